@@ -1,12 +1,13 @@
 #pragma once
 #include <GL/glew.h>
 #include <string>
+#include "CommandList.h"
 
 class BitmapFont {
 private:
     unsigned int fontTexture;
     unsigned int shaderProgram;
-    unsigned int VAO, VBO;
+    unsigned int VAO;   // Verteksi su u StreamBuffer-u
 
     int gridWidth;      // Broj karaktera po irini (16)
     int gridHeight;     // Broj karaktera po visini (6)
@@ -22,13 +23,30 @@ public:
     // U?itaj font teksturu i postavi parametre
     void Init(unsigned int texture, unsigned int shader, int gridW = 16, int gridH = 6, int firstASCII = 32);
 
+    // Zameni sejder (npr. nakon ponovnog ucitavanja sa diska)
+    void SetShader(unsigned int shader) { shaderProgram = shader; }
+
     // Renderuj tekst na ekranu
     // x, y - screen koordinate (0,0 = top-left, width,height = bottom-right)
     // scale - veli?ina (1.0 = normalna, 2.0 = duplo ve?a)
     // r, g, b - boja teksta (0.0 - 1.0)
     void RenderText(const std::string& text, float x, float y, float scale, float r, float g, float b);
 
+    // Snimi tekst u listu komandi: svi karakteri u jednom baferu, jedan poziv za iscrtavanje
+    void RecordText(CommandList& list, const std::string& text, float x, float y, float scale, float r, float g, float b);
+    // Isto za tekst koji nije std::string (npr. FrameArena::Format), bez kopiranja
+    void RecordText(CommandList& list, const char* text, float x, float y, float scale, float r, float g, float b);
+
 private:
     // Dobavi texture koordinate za odre?eni karakter
     void GetCharUV(char c, float& u1, float& v1, float& u2, float& v2);
+
+    // Napravi 6 verteksa (x, y, u, v) po vidljivom karakteru; vraca broj verteksa
+    int BuildVertices(const char* text, float x, float y, float scale);
+    // Upisi vertekse u StreamBuffer; vraca indeks prvog verteksa (-1 ako nema mesta)
+    int WriteVertices();
+
+    // Verteksi poslednjeg teksta, u frameArena (vaze do kraja frejma)
+    float* vertices;
+    size_t vertexFloats;
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+// Binding point uniform bloka ViewParams (mat4 uView) - deli ga svaki program
+const unsigned int VIEW_UBO_BINDING = 0;
+
+// Kamera nad mapom: centar u map space [0,1] i deo mape koji se vidi (1 = cela mapa).
+// Daje jednu matricu pogleda map space -> NDC koja ide u sejdere, pa zoom i pan
+// nikad ne diraju bafere sa geometrijom.
+class Camera {
+private:
+    float targetZoom;
+    // Tacka mape koja ostaje ispod kursora dok zoom klizi ka targetZoom
+    float anchorMapX, anchorMapY, anchorNdcX, anchorNdcY;
+    bool anchored;
+
+    void Clamp();
+
+public:
+    float centerX, centerY;
+    float zoom;
+
+    float minZoom, maxZoom;
+
+    Camera(float centerX = 0.5f, float centerY = 0.5f, float zoom = 1.0f);
+
+    // Odmah postavi pogled (bez animacije)
+    void Set(float cx, float cy, float z);
+
+    // Zoom oko tacke ekrana (NDC); factor < 1 priblizava
+    void ZoomAt(float ndcX, float ndcY, float factor);
+    // Pomeri pogled za pomeraj u NDC (prevlacenje misem)
+    void Pan(float dNdcX, float dNdcY);
+    // Glatko priblizavanje zoom-a ka cilju; dt u sekundama
+    void Update(float dt);
+
+    void NDCToMap(float ndcX, float ndcY, float& mapX, float& mapY) const;
+    void MapToNDC(float mapX, float mapY, float& ndcX, float& ndcY) const;
+
+    // Matrica (column-major, za std140 mat4)
+    void GetViewMatrix(float out[16]) const;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+#include "FrameArena.h"
+
+// Slojevi se iscrtavaju ovim redom; unutar sloja komande se sortiraju po programu i teksturi,
+// pa sve sto mora biti preko necega drugog (tacke ruta preko linija) ima svoj sloj
+enum class RenderLayer : unsigned char { Map = 0, Route = 1, RoutePoints = 2, Hud = 3, Text = 4 };
+
+// Vise indeksiranih poziva (GL_UNSIGNED_INT) jednim GL pozivom: glMultiDrawElementsIndirect
+// iz GL_DRAW_INDIRECT_BUFFER-a, ili bez ARB_multi_draw_indirect glMultiDrawElementsBaseVertex
+// iz istih podataka u SoA nizovima na CPU. Nizove drzi vlasnik do sledeceg snimanja.
+struct MultiDrawBatch {
+    unsigned int indirectBuffer;
+    size_t indirectOffset;          // U bajtovima, do prve DrawElementsIndirectCommand
+    int drawCount;
+    const GLsizei* counts;
+    const void* const* indexOffsets;
+    const GLint* baseVertices;
+};
+
+struct DrawCommand {
+    RenderLayer layer;
+    unsigned int program;
+    unsigned int vao;
+    unsigned int texture;       // 0 = bez teksture
+    unsigned int sampler;       // Sampler objekat za jedinicu 0 (0 = parametri same teksture)
+    GLenum primitive;
+    int first, count;           // Opseg verteksa
+    int instanceCount;          // 0 = obican (neinstancirani) poziv
+    bool indexed;               // glDrawElements sa GL_UNSIGNED_INT iz element bafera VAO-a
+    size_t indexOffset;         // U bajtovima; "count" je tada broj indeksa
+    int baseInstance;
+
+    // Kada nema ARB_base_instance: vlasnik VAO-a pomera pokazivace atributa po instanci
+    void (*setBaseInstance)(void* owner, int baseInstance);
+    void* owner;
+
+    const MultiDrawBatch* multiDraw; // != nullptr: ceo batch umesto jednog poziva
+
+    bool hasColor;              // Postavlja "uColor" (vec4) ako program ima taj uniform
+    float color[4];
+};
+
+// Podaci koje treba upisati u bafer pre iscrtavanja (izvrsava se na GL niti pri Submit)
+struct BufferUpload {
+    GLenum target;
+    unsigned int buffer;
+    GLsizeiptr reserve;         // Velicina za orphan (glBufferData), >= data.size()
+    bool partial;               // Samo deo bafera (glBufferSubData od "offset"), bez orphan-a
+    GLintptr offset;
+    unsigned char* data;        // U areni liste, do sledeceg Clear
+    size_t size;
+};
+
+// Lista komandi za jedan frejm. Snimanje ne poziva GL, pa svaki podsistem moze
+// da snima u svoju listu i na radnoj niti; GL nit ih zatim preda RenderQueue-u.
+// Podaci upisa su u areni liste, pa posle zagrevanja snimanje ne ide na heap.
+class CommandList {
+public:
+    std::vector<BufferUpload> uploads;
+    std::vector<DrawCommand> commands;
+    FrameArena arena;
+
+    // Pocetak frejma: prazne liste i arena (prethodni frejm je vec predat)
+    void Clear();
+
+    // Kopira "size" bajtova; orphan velicina je najmanje "reserve"
+    void Upload(GLenum target, unsigned int buffer, const void* data, size_t size, size_t reserve = 0);
+    // Isto, ali pozivalac sam upisuje "size" bajtova u vraceni prostor (npr. preslaganje SoA -> xy)
+    void* UploadSpace(GLenum target, unsigned int buffer, size_t size, size_t reserve = 0);
+    // Upis u deo postojeceg bafera (ostatak ostaje); pozivalac upisuje "size" bajtova
+    void* UploadRange(GLenum target, unsigned int buffer, size_t offset, size_t size);
+
+    DrawCommand& Draw(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+        GLenum primitive, int first, int count);
+    DrawCommand& DrawIndexed(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+        GLenum primitive, int count, size_t indexOffset);
+    DrawCommand& DrawInstanced(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+        GLenum primitive, int first, int count, int instanceCount, int baseInstance);
+    DrawCommand& MultiDraw(RenderLayer layer, unsigned int program, unsigned int vao, GLenum primitive,
+        const MultiDrawBatch* batch);
+
+    void SetColor(DrawCommand& cmd, float r, float g, float b, float a);
+};
+
+// Izvrsava liste na GL niti: prvo svi upisi u bafere, pa komande sortirane po
+// (sloj, program, tekstura, redosled snimanja), bez ponovnog postavljanja istog stanja.
+class RenderQueue {
+private:
+    struct ProgramInfo {
+        unsigned int program;
+        int colorLocation;
+        float color[4];
+        bool colorSet;
+    };
+
+    struct SortEntry {
+        const DrawCommand* cmd;
+        unsigned int sequence;
+    };
+
+    struct BlockBinding {
+        const char* name;
+        unsigned int binding;
+    };
+
+    std::vector<ProgramInfo> programs;  // Programi koji su vec pripremljeni (lokacije, blokovi)
+    std::vector<BlockBinding> blocks;
+    std::vector<BlockBinding> samplerUnits; // Dodatni sampleri (uTexture je uvek jedinica 0)
+    std::vector<SortEntry> sorted;
+
+    ProgramInfo& PrepareProgram(unsigned int program);
+
+public:
+    // Uniform blok sa ovim imenom se u svakom programu vezuje za dati binding point
+    void RegisterUniformBlock(const char* name, unsigned int binding);
+    // Sampler uniform sa ovim imenom se u svakom programu postavlja na datu jedinicu teksture
+    void RegisterSampler(const char* name, unsigned int unit);
+
+    // Zaboravi pripremljene programe (posle hot-reload-a ID moze biti ponovo iskoriscen)
+    void InvalidatePrograms();
+
+    void Submit(std::initializer_list<const CommandList*> lists);
+    void Submit(const CommandList& list);
+};
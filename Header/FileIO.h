@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+
+// Fajl mapiran u memoriju samo za citanje (mmap / MapViewOfFile): citanje bez kopiranja
+// u bafer, stranice ucitava OS po potrebi
+class MappedFile {
+private:
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int descriptor;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // false ako fajl ne postoji ili ne moze da se mapira (prazan fajl se otvara, Size() == 0)
+    bool Open(const char* path);
+    void Close();
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+};
+
+// Fajl u koji se samo dopisuje na kraj (dnevnik). Append ne ceka disk; Sync ceka da sve
+// upisano stigne na disk (fsync / FlushFileBuffers), pa se poziva jednom za vise upisa
+class AppendFile {
+private:
+#ifdef _WIN32
+    void* handle;
+#else
+    int descriptor;
+#endif
+
+public:
+    AppendFile();
+    ~AppendFile();
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    // truncate = zapocni prazan fajl; inace se nastavlja postojeci
+    bool Open(const char* path, bool truncate);
+    void Close();
+    bool IsOpen() const;
+    // Trenutna velicina fajla (0 ako nije otvoren)
+    size_t Size() const;
+
+    bool Append(const void* data, size_t size);
+    bool Sync();
+};
+
+// Upis celog fajla tako da je na disku ili stari ili novi sadrzaj, nikad pola: upis u
+// "path.tmp", fsync, pa zamena imena (rename / MoveFileEx), koja je atomicna
+bool writeFileAtomic(const char* path, const void* data, size_t size);
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Linearni (bump) alokator za podatke koji zive jedan frejm: Allocate samo pomera pokazivac,
+// a Reset na kraju frejma sve oslobadja odjednom. Memorija se ne vraca: ako frejm nije stao
+// u jedan blok, Reset ih zameni jednim dovoljno velikim, pa posle zagrevanja frejm ne ide
+// na heap. Jedna nit po areni.
+class FrameArena {
+private:
+    struct Block {
+        unsigned char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current;             // Blok iz kog se trenutno dodeljuje
+    size_t used;                // ...i koliko je od njega zauzeto
+    size_t frameBytes;          // Dodeljeno od poslednjeg Reset (sa poravnanjem)
+    size_t peakBytes;           // Najvise u jednom frejmu
+    unsigned int blockAllocations; // Blokovi uzeti sa heap-a od pocetka
+
+    void* AllocateSlow(size_t size, size_t align);
+    void AddBlock(size_t size);
+
+public:
+    explicit FrameArena(size_t initialSize = 64 * 1024);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Vazi do sledeceg Reset; nikad nullptr
+    void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if (start + size <= blocks[current].size) {
+            frameBytes += start + size - used;
+            used = start + size;
+            return blocks[current].data + start;
+        }
+        return AllocateSlow(size, align);
+    }
+
+    template <typename T>
+    T* AllocateArray(size_t count) { return (T*)Allocate(count * sizeof(T), alignof(T)); }
+
+    // printf u arenu; vraca tekst sa '\0' na kraju (length = duzina bez njega)
+    const char* Format(size_t* length, const char* format, ...);
+
+    void Reset();
+
+    size_t FrameBytes() const { return frameBytes; }
+    size_t PeakBytes() const { return peakBytes; }
+    unsigned int BlockAllocations() const { return blockAllocations; }
+};
+
+// STL alokator nad arenom (deallocate ne radi nista); kontejner ne sme da nadzivi Reset
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+    FrameArena* arena;
+
+    explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return arena->AllocateArray<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Arena render niti za privremene podatke frejma (tekst, verteksi); Reset na kraju frejma
+extern FrameArena frameArena;
+
+// Alokacije sa heap-a (operator new) pozivajuce niti od pokretanja; razlika po frejmu ide u
+// frameStats i treba da bude 0 u stabilnom stanju
+uint64_t threadHeapAllocations();
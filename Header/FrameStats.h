@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+// Brojaci za jedan frejm (F3 ukljucuje/iskljucuje prikaz)
+struct FrameStats {
+    unsigned int drawCalls;     // glDraw*
+    unsigned int stateChanges;  // glUniform* i pokazivaci atributa (ne prolaze kroz glState)
+    unsigned int glCallsIssued; // Vezivanja koja je glState prosledio drajveru
+    unsigned int glCallsSkipped;// Vezivanja koja je glState preskocio (stanje je vec bilo takvo)
+    unsigned int bufferUpdates; // glBufferData / glBufferSubData
+    double submitCpuMs;         // CPU vreme provedeno u pozivima ka drajveru za iscrtavanje
+    unsigned int streamBytes;   // Dinamicki verteksi upisani u StreamBuffer
+    unsigned int routesVisible; // Rute u pogledu
+    unsigned int routesCulled;  // Rute preskocene jer su van pogleda
+    double journalRecordMaxUs;  // Najvece kasnjenje koje je upis u dnevnik dodao kliku
+    // Stranice virtuelne teksture mape
+    unsigned int tilesVisible;  // Stranice koje je pogled trazio (feedback)
+    unsigned int tilesHit;      // ...i bile su u kesu
+    unsigned int tilesLate;     // Stigle posle trenutka kada su bile potrebne (pop-in)
+    unsigned int tilesPrefetched;        // Predvidjene i stigle pre nego sto su bile potrebne
+    unsigned int tilesPrefetchRequested; // Zahtevi prefetch-a prihvaceni u budzet
+    unsigned int tilesInFlight;          // Na kraju frejma u obradi na radnim nitima
+    // JobSystem
+    unsigned int jobsExecuted;  // Zavrseni poslovi radnih niti (i pomoci u Wait)
+    unsigned int jobsStolen;    // ...od toga uzeti iz tudjeg reda
+    unsigned int jobsMainThread;// Poslovi iz reda glavne niti (GL)
+    unsigned int jobQueueDepth; // Na kraju frejma u redovima (radne niti + glavna)
+    // Memorija render niti
+    unsigned int heapAllocations; // operator new tokom frejma (0 u stabilnom stanju)
+    unsigned int arenaBytes;    // Privremeni podaci frejma u arenama (FrameArena)
+};
+
+extern FrameStats frameStats;     // Samo render nit
+extern std::atomic<bool> profilingEnabled;
+
+// Pozvati na pocetku i kraju svakog frejma (render nit); jednom u sekundi ispisuje proseke
+// u konzolu (ako je profilisanje ukljuceno) i ostavlja ih za naslov prozora
+void beginFrameStats();
+void endFrameStats();
+// Nit prozora (GLFW): novi tekst za naslov od poslednjeg poziva, ako ga ima
+bool takeFrameStatsTitle(std::string& title);
@@ -0,0 +1,40 @@
+#pragma once
+#include <GL/glew.h>
+
+// Pamti trenutno GL stanje glavnog konteksta i preskace pozive koji ga ne bi promenili.
+// Sva vezivanja na glavnoj niti treba da idu kroz glState, inace kes zastareva
+// (tada pozvati Invalidate). Brojaci izdatih/preskocenih poziva idu u frameStats.
+class GLState {
+private:
+    static const int MAX_TEXTURE_UNITS = 8;
+    static const unsigned int UNKNOWN = 0xFFFFFFFF; // Stanje koje jos nismo postavili
+
+    unsigned int program;
+    unsigned int vao;
+    unsigned int activeUnit;
+    unsigned int textures[MAX_TEXTURE_UNITS];
+    unsigned int samplers[MAX_TEXTURE_UNITS];
+    unsigned int arrayBuffer;
+    unsigned int uniformBuffer;
+    int blend;                      // -1 = nepoznato
+    GLenum blendSrc, blendDst;
+
+    bool Changed(unsigned int& current, unsigned int value);
+
+public:
+    GLState();
+
+    void UseProgram(unsigned int p);
+    void BindVertexArray(unsigned int v);
+    void ActiveTexture(unsigned int unit);          // Indeks jedinice (0 = GL_TEXTURE0)
+    void BindTexture(unsigned int texture);         // GL_TEXTURE_2D na aktivnoj jedinici
+    void BindSampler(unsigned int unit, unsigned int sampler);
+    void BindBuffer(GLenum target, unsigned int buffer);
+    void SetBlend(bool enabled);
+    void BlendFunc(GLenum src, GLenum dst);
+
+    // Zaboravi sve (npr. posle koda koji direktno menja stanje)
+    void Invalidate();
+};
+
+extern GLState glState;
@@ -0,0 +1,40 @@
+#pragma once
+#include "FileIO.h"
+#include "MapSource.h"
+#include <cstdint>
+#include <vector>
+
+// Tiled GeoTIFF (klasican i BigTIFF) kao izvor mape. Fajl je mapiran u memoriju, a plocica
+// se raspakuje tek kada je virtuelna tekstura zatrazi. Pregledi (overviews, npr. iz gdaladdo)
+// koriste se kao grublji nivoi; nivoi bez pregleda se prave usrednjavanjem.
+// Podrzano: 8 bita po kanalu, siva/siva+alfa/RGB/RGBA/paleta, bez kompresije, LZW ili
+// deflate, sa ili bez horizontalnog prediktora. JPEG kompresija nije podrzana.
+class GeoTiffSource : public TiledMapSource {
+private:
+    struct Image {
+        int width, height;
+        int tilesAcross, tilesDown;
+        int samples;
+        int photometric;
+        int compression;
+        int predictor;
+        std::vector<uint64_t> tileOffsets, tileBytes;
+    };
+
+    MappedFile file;
+    std::vector<Image> levels;  // Indeks = nivo; width == 0 ako nivo nema pregled
+    std::vector<unsigned char> palette; // RGB po indeksu (256 ulaza) za fotometriju "paleta"
+    bool hasGeoBounds;
+    double south, west, north, east;
+
+protected:
+    bool HasLevel(int level) const override;
+    void TileOrigin(int level, int& originX, int& originY) const override;
+    bool LoadTile(int level, int tileX, int tileY, unsigned char* rgba) override;
+
+public:
+    GeoTiffSource();
+
+    bool Open(const char* path);
+    bool GeoBounds(double& south, double& west, double& north, double& east) const override;
+};
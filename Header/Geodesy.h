@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Geometry.h"
+
+// Geografske koordinate u stepenima (WGS84)
+struct GeoPoint {
+    double lat, lon;
+};
+
+// Veza map space [0,1] (y = 0 je dno slike) i geografskih koordinata. Slika mape je
+// u Web Mercator projekciji, pa je x linearan po duzini, a y po Mercator y.
+// Bez georeference (IsValid() == false) ToGeo vraca (0, 0), pa su sva rastojanja 0.
+class GeoReference {
+private:
+    double west, east;          // Duzina leve/desne ivice (stepeni)
+    double mercSouth, mercNorth;// Mercator y donje/gornje ivice (radijani, jedinicna sfera)
+    bool valid;
+
+public:
+    GeoReference();
+
+    bool IsValid() const { return valid; }
+
+    // Ivice mape u stepenima
+    void SetBounds(double south, double west, double north, double east);
+    // Centar, sirina na terenu u metrima i odnos sirina/visina slike (ivice se racunaju)
+    void SetCenter(double lat, double lon, double widthMeters, double aspect);
+    // Dve kontrolne tacke (map space -> poznate koordinate), npr. dva raskrsca na slici
+    bool Calibrate(Point mapA, GeoPoint geoA, Point mapB, GeoPoint geoB);
+    // Kontrolne tacke iz tekstualnog fajla pored slike mape: dva reda "x y lat lon"
+    // (x, y u map space, y = 0 je dno slike); redovi koji pocinju sa '#' su komentari
+    bool LoadControlPoints(const char* path);
+
+    GeoPoint ToGeo(float x, float y) const;
+    Point ToMap(GeoPoint geo) const;
+
+    // Paketna konverzija (SoA, bez grananja u petlji)
+    void ToGeo(const float* xs, const float* ys, size_t count, double* lat, double* lon) const;
+};
+
+enum class DistanceMethod { Haversine, Vincenty };
+
+// Rastojanja na terenu u metrima, u dvostrukoj preciznosti. Haversine je sfera srednjeg
+// poluprecnika (greska do ~0.5%), Vincenty elipsoid WGS84 (milimetri).
+class DistanceEngine {
+private:
+    GeoReference reference;
+    DistanceMethod method;
+    std::vector<double> lat, lon, cosLat; // Radni nizovi za paketni racun
+
+public:
+    static const double EARTH_RADIUS;   // Srednji poluprecnik (m)
+
+    DistanceEngine();
+
+    GeoReference& Reference() { return reference; }
+    const GeoReference& Reference() const { return reference; }
+
+    void SetMethod(DistanceMethod newMethod) { method = newMethod; }
+    DistanceMethod GetMethod() const { return method; }
+
+    static double Haversine(GeoPoint a, GeoPoint b);
+    // Inverzni Vincenty; ako ne konvergira (skoro antipodne tacke) vraca haversine
+    static double Vincenty(GeoPoint a, GeoPoint b);
+
+    double Distance(GeoPoint a, GeoPoint b) const;
+    // Dve tacke u map space
+    double Distance(Point a, Point b) const;
+
+    // Duzine segmenata (tacka i, tacka i + 1) za i < count - 1, racunate u double i upisane
+    // kao float (kao u RouteStore); vraca zbir u double.
+    // Za hiljade tacaka odjednom (izmena rute, uvoz) - konverzija i haversine su
+    // jednostavne petlje nad nizovima koje kompajler vektorizuje
+    double SegmentLengths(const float* xs, const float* ys, size_t count, float* lengths);
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+// Tacka u map space [0,1] (ili u NDC, zavisno od mesta upotrebe)
+struct Point {
+    float x, y;
+    Point(float x = 0, float y = 0) : x(x), y(y) {}
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+
+// Paketne geometrijske funkcije nad SoA nizovima (xs[i], ys[i]) u float preciznosti.
+// Postoje tri implementacije (skalarna, SSE2, AVX2); initGeometryKernels bira najbolju
+// koju procesor podrzava, a ostatak programa ih poziva preko geometryKernels.
+enum class KernelSet { Scalar = 0, SSE2, AVX2, Count };
+
+struct GeometryKernels {
+    KernelSet set;
+
+    // out[i] = |(xs[i], ys[i]) - (px, py)|
+    void (*distancesToPoint)(const float* xs, const float* ys, size_t count, float px, float py, float* out);
+    // out[i] = |p[i + 1] - p[i]| za i < count - 1
+    void (*segmentLengths)(const float* xs, const float* ys, size_t count, float* out);
+    // outX[i] = xs[i] * scaleX + offsetX (isto za y); npr. map space -> NDC ili pixel -> NDC
+    void (*transform)(const float* xs, const float* ys, size_t count, float scaleX, float scaleY,
+        float offsetX, float offsetY, float* outX, float* outY);
+    // Granice svih tacaka; za count == 0 ne menja izlaz
+    void (*boundingBox)(const float* xs, const float* ys, size_t count,
+        float* minX, float* minY, float* maxX, float* maxY);
+    // Indeks najblize tacke (najmanji indeks pri jednakosti) i kvadrat rastojanja; -1 za count == 0
+    int (*nearestPoint)(const float* xs, const float* ys, size_t count, float px, float py, float* distanceSq);
+};
+
+extern GeometryKernels geometryKernels;
+
+// Pozvati jednom na pocetku; vraca izabrani skup
+KernelSet initGeometryKernels();
+// false ako procesor ne podrzava dati skup (ili nije x86)
+bool getGeometryKernels(KernelSet set, GeometryKernels& out);
+const char* kernelSetName(KernelSet set);
+
+// Propusnost svake funkcije za svaki podrzani skup, ispis u konzolu (F10)
+void benchmarkGeometryKernels();
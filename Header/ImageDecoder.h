@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+
+// Dekodiranje slika u RGBA piksele sa izborom implementacije.
+// PNG koji nosi tabelu traka ("stRP", pise je PngWriter - npr. izvoz mape) dekodira se
+// paralelno: svaka traka je zaseban deflate segment (LZ77 prozor se ne prenosi preko granice),
+// pa niti nezavisno raspakuju, defiltriraju i prepisuju svoju traku u izlaz.
+// Sve ostalo (obican PNG, JPEG, ...) ide kroz stb_image. Obican PNG je jedan deflate tok, pa
+// se veliki (>= 1 MB, npr. mapa) posle prvog ucitavanja u pozadini prepise pored originala kao
+// "<putanja>.strips.png"; dok je kes noviji od originala, decodeImageRGBA cita njega paralelno.
+// Izlaz se uvek alocira sa malloc, pa ga oslobadja free / stbi_image_free.
+enum class ImageBackend {
+    Stb,
+    StripPng
+};
+
+struct ImageDecodeStats {
+    ImageBackend backend;
+    int threads;
+    int strips;
+    size_t fileBytes;
+    double milliseconds;
+};
+
+// RGBA, red 0 = vrh slike ili dno ako je bottomUp (kao sto GL ocekuje); nullptr ako ne uspe
+unsigned char* decodeImageRGBA(const char* path, int* width, int* height, bool bottomUp,
+    ImageDecodeStats* stats = nullptr);
+
+// Isto, za sliku vec ucitanu u memoriju (npr. plocica iz baze)
+unsigned char* decodeImageMemoryRGBA(const unsigned char* data, size_t size, int* width, int* height, bool bottomUp,
+    ImageDecodeStats* stats = nullptr);
+
+// zlib tok (sa zaglavljem) u dst; false ako je ostecen ili ne staje u dstSize
+bool inflateZlib(const unsigned char* src, size_t size, unsigned char* dst, size_t dstSize, size_t* written);
+
+// Samo paralelni PNG dekoder (bez stb rezerve) nad fajlom u memoriji; nullptr ako PNG nema
+// tabelu traka ili nije 8-bitni RGB/RGBA bez preplitanja
+unsigned char* decodeStripPng(const unsigned char* data, size_t size, int* width, int* height,
+    bool bottomUp, int threadCount, ImageDecodeStats* stats = nullptr);
+
+// Poredi stb_image i paralelni dekoder (MB/s nekompresovanih piksela) na mapi i sintetickoj
+// mapi sirine 16k; privremeni fajlovi se pisu u radni direktorijum
+void benchmarkImageDecode(const char* mapPath);
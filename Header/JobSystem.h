@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Zajednicki skup radnih niti za pozadinski posao (dekodiranje slika, stranice mape,
+// kompresija izvoza, uvoz ruta, geometrija ruta). Svaka radna nit ima svoj red: nov posao
+// ide na kraj reda niti koja ga je napravila i odatle se i uzima (najsvezi podaci u kesu),
+// a nit bez posla krade sa pocetka tudjeg reda (najstariji posao). Posao moze da zavisi od
+// drugih i krece tek kada se svi zavrse. GL pozivi idu u red glavne niti (SubmitMainThread),
+// koji glavna nit prazni jednom po frejmu. Bez fibera: Wait ne blokira nit, nego izvrsava
+// druge poslove radnih niti dok ceka (poslove glavne niti nikad).
+class JobSystem {
+public:
+    typedef std::function<void()> Function;
+    typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+    struct Job;
+    typedef std::shared_ptr<Job> JobHandle;
+
+    // Ukupno od pokretanja (GetCounters); frameStats dobija razlike po frejmu
+    struct Counters {
+        uint64_t submitted;
+        uint64_t executed;      // Zavrseni van glavnog reda (radne niti i pomoc u Wait)
+        uint64_t stolen;        // ...od toga uzeti iz tudjeg reda
+        uint64_t mainExecuted;  // Zavrseni iz reda glavne niti
+        int queued;             // Trenutno u redovima radnih niti
+        int mainQueued;         // Trenutno u redu glavne niti
+    };
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex mainMutex;
+    std::deque<JobHandle> mainJobs;
+
+    // Radne niti bez posla spavaju na wake, a Wait bez posla za pomoc na finished
+    std::mutex sleepMutex;
+    std::condition_variable wake, finished;
+    std::atomic<int> sleeping, waiting;
+    bool running;                   // Pod sleepMutex
+
+    std::atomic<std::thread::id> mainThread; // Nit sa GL kontekstom (Start / SetMainThread)
+    std::atomic<unsigned int> nextWorker;   // Poslovi sa drugih niti se dele redom
+    std::atomic<int> queued, mainQueued;
+    std::atomic<uint64_t> submitted, executed, stolen, mainExecuted;
+    Counters lastFrame;
+
+    void WorkerLoop(int index);
+    JobHandle Create(Function function, bool onMainThread, const std::vector<JobHandle>& dependencies);
+    void Schedule(const JobHandle& job);
+    JobHandle Take(int index, bool& wasStolen);
+    JobHandle TakeMain();
+    void Execute(const JobHandle& job);
+    void Complete(const JobHandle& job);
+    // Jedan korak cekanja: izvrsi jedan posao radnih niti ili kratko sacekaj
+    void WaitStep(const JobHandle& job);
+
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // threadCount 0 = jezgra - 1 (glavna nit crta i pomaze u Wait)
+    void Start(int threadCount = 0);
+    // Red glavne niti od sada prazni pozivajuca nit, npr. render nit
+    // kojoj je predat GL kontekst. Start postavlja nit koja ga je pozvala.
+    void SetMainThread() { mainThread = std::this_thread::get_id(); }
+    // Radne niti zavrse sve sto je u redovima; pozvati posle svih korisnika
+    void Stop();
+    int WorkerCount() const { return (int)workers.size(); }
+
+    // Bez radnih niti (pre Start / posle Stop) posao se izvrsava odmah, na pozivajucoj niti
+    JobHandle Submit(Function function, const std::vector<JobHandle>& dependencies = {});
+    // Izvrsava se samo u RunMainThreadJobs, posle zavisnosti
+    JobHandle SubmitMainThread(Function function, const std::vector<JobHandle>& dependencies = {});
+
+    bool IsDone(const JobHandle& job) const;
+    // Dok posao ne bude gotov, nit izvrsava druge poslove radnih niti
+    void Wait(const JobHandle& job);
+    // Kao Wait, ali glavna nit usput izvrsava i red glavne niti, pa moze da ceka GL nastavak
+    // (SubmitMainThread sa zavisnostima). Sa druge niti isto sto i Wait; ne pozivati iz posla
+    // glavne niti za drugi posao glavne niti
+    void WaitMainThread(const JobHandle& job);
+
+    // body(begin, end) nad [0, count) u komadima od grain; pozivalac radi jedan deo i ceka ostale
+    void ParallelFor(size_t count, size_t grain, const RangeFunction& body);
+    // Najvise koliko delova radi istovremeno (radne niti + pozivalac)
+    int Concurrency() const { return WorkerCount() + 1; }
+
+    // Glavna nit, jednom po frejmu; posle budgetMs ostatak ceka sledeci frejm. Vraca broj poslova.
+    // Poziv sa druge niti ili iz posla glavne niti ne radi nista
+    int RunMainThreadJobs(double budgetMs);
+
+    Counters GetCounters() const;
+    // Razlike brojaca od prethodnog poziva -> frameStats (jednom po frejmu)
+    void UpdateFrameStats();
+};
+
+extern JobSystem jobSystem;
@@ -0,0 +1,91 @@
+#pragma once
+#include <GL/glew.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "JobSystem.h"
+#include "PngWriter.h"
+#include "RouteRenderer.h"
+
+class Camera;
+
+// Izvoz trenutnog pogleda u PNG velike rezolucije (npr. 16384 x 16384). Slika se iscrtava
+// u plocicama TILE_SIZE x TILE_SIZE u FBO, nekoliko po frejmu, i cita asinhrono kroz PBO-e.
+// Red plocica (traka) ide kao posao u JobSystem na filtriranje i deflate, a trake se upisuju redom.
+// Najvise MaxBands() traka je istovremeno u memoriji, pa memorija ne zavisi od velicine
+// slike, a aplikacija normalno radi dok izvoz traje. Rute su iz verzije u trenutku pocetka,
+// u svojim GPU baferima (ekran za to vreme crta novije verzije svojim RouteRenderer-om).
+class MapExport {
+public:
+    static const int TILE_SIZE = 256;
+    static const int TILES_PER_FRAME = 8;
+    static const int READBACK_SLOTS = TILES_PER_FRAME * 2;
+
+    // Iscrtaj scenu za dati pogled (kvadrat "pixels" x "pixels"); FBO i viewport su vec postavljeni.
+    // Rute izvoza crta dati routeRenderer
+    typedef std::function<void(const Camera& camera, int pixels, RouteRenderer& routeRenderer,
+        const RouteSnapshot& routes)> RenderFunction;
+
+private:
+    struct Band {
+        int index;
+        int tilesCopied;
+        std::vector<unsigned char> pixels;  // RGBA, size x TILE_SIZE
+    };
+
+    struct Readback {
+        unsigned int pbo;
+        GLsync fence;
+        int tile;
+    };
+
+    std::string path;
+    int size, tilesPerSide;
+    float left, top, tileZoom;      // Gornji levi ugao pogleda i deo mape po plocici
+    int nextTile;
+    bool active;
+    double startTime;
+
+    unsigned int fbo, colorBuffer;
+    RouteRenderer routeRenderer;    // Postoji od Start do Finish
+    RouteSnapshotPtr routes;
+    Readback readbacks[READBACK_SLOTS];
+    int readbackHead, readbackCount;    // FIFO: plocice citamo redom kojim su iscrtane
+
+    std::vector<std::unique_ptr<Band>> filling; // Trake kojima jos fale plocice
+
+    // Deljeno sa poslovima kompresije (mutex)
+    PngWriter writer;
+    std::deque<std::unique_ptr<Band>> toCompress;
+    std::map<int, PngWriter::Strip> compressed; // Gotove trake koje cekaju prethodne
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    int nextToWrite;
+    int bandsInFlight;              // Zapocete, a jos neupisane trake
+    bool failed;
+    std::mutex mutex;
+    std::vector<JobSystem::JobHandle> jobs;  // Samo GL nit; Finish ih ceka
+
+    int MaxBands() const { return std::min(4, jobSystem.WorkerCount()) + 2; }
+    void CompressNext();
+    void CollectReadbacks(bool wait);
+    void RenderTile(const RenderFunction& render);
+    void Finish(bool ok);
+
+public:
+    MapExport();
+    ~MapExport();
+
+    // Pocinje izvoz pogleda kamere i datih ruta; size se zaokruzuje na umnozak TILE_SIZE
+    bool Start(const char* path, int size, const Camera& camera, const RouteSnapshotPtr& routes);
+    void Cancel();
+    bool IsActive() const { return active; }
+
+    // Jednom po frejmu (GL nit), posle iscrtavanja ekrana: preuzme gotova citanja i
+    // iscrta sledece plocice. Na kraju vraca viewport na velicinu prozora.
+    void Update(const RenderFunction& render, int windowWidth, int windowHeight);
+};
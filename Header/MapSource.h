@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Izvor piksela mape za virtuelnu teksturu. Nivo 0 je najfiniji, svaki sledeci je upola
+// manji (max(1, velicina >> nivo)); koordinate i redovi idu od donjeg levog ugla, kao u GL.
+// ReadRegion se poziva sa radnih niti TileStreamer-a (vise istovremeno), pa izvori citaju
+// fajl tek kada se stranica trazi. Nivo koji izvor nema (npr. zoom ispod minzoom u bazi)
+// pravi se usrednjavanjem 2x2 finijeg nivoa.
+class MapSource {
+protected:
+    int width, height;
+
+    // Nivoi koje izvor ima sam
+    virtual bool HasLevel(int level) const = 0;
+    // Pravougaonik je uvek unutar nivoa
+    virtual void ReadNative(int level, int x, int y, int w, int h, unsigned char* rgba) = 0;
+
+public:
+    MapSource() : width(0), height(0) {}
+    virtual ~MapSource() {}
+    MapSource(const MapSource&) = delete;
+    MapSource& operator=(const MapSource&) = delete;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int LevelWidth(int level) const;
+    int LevelHeight(int level) const;
+
+    // RGBA w x h, red 0 = donji; pravougaonik mora biti unutar nivoa
+    void ReadRegion(int level, int x, int y, int w, int h, unsigned char* rgba);
+
+    // Ivice mape u stepenima, ako ih izvor zna (MBTiles, GeoTIFF sa georeferencom)
+    virtual bool GeoBounds(double& south, double& west, double& north, double& east) const { return false; }
+    // false za izvore koji nikad nisu ceo u memoriji (nema obicne GL teksture)
+    virtual bool InMemory() const { return false; }
+};
+
+// Slika vec ucitana u memoriju (PNG mape): cela piramida se pravi unapred
+class ImageMapSource : public MapSource {
+private:
+    struct Level {
+        int width, height;
+        std::vector<unsigned char> pixels; // RGBA, red 0 = dno slike
+    };
+    std::vector<Level> levels;
+
+protected:
+    bool HasLevel(int level) const override { return level < (int)levels.size(); }
+    void ReadNative(int level, int x, int y, int w, int h, unsigned char* rgba) override;
+
+public:
+    // rgba: red 0 = dno; kopira se, pa se moze osloboditi odmah posle
+    ImageMapSource(const unsigned char* rgba, int width, int height);
+    bool InMemory() const override { return true; }
+};
+
+// Izvor podeljen na plocice iste velicine (baze plocica, tiled GeoTIFF). Dekodirane plocice
+// se cuvaju u malom LRU kesu, jer stranica virtuelne teksture (sa ivicom) sece vise plocica,
+// a susedne stranice dele iste plocice.
+class TiledMapSource : public MapSource {
+public:
+    static const int CACHE_TILES = 64;
+
+private:
+    struct CachedTile {
+        uint64_t key;
+        std::vector<unsigned char> pixels;
+        bool present;
+    };
+    std::list<CachedTile> cache;            // Napred = poslednja koriscena
+    std::unordered_map<uint64_t, std::list<CachedTile>::iterator> cacheIndex;
+    std::mutex cacheMutex;
+    std::vector<unsigned char> background;  // Plocica koja ne postoji u izvoru
+
+    bool FetchTile(int level, int tileX, int tileY, std::vector<unsigned char>& pixels);
+
+protected:
+    int tileSize;
+
+    // Pomeraj mreze plocica na nivou: piksel (x, y) izvora je piksel (x + ox, y + oy) mreze
+    virtual void TileOrigin(int level, int& originX, int& originY) const { originX = originY = 0; }
+    // Plocica tileSize x tileSize RGBA, red 0 = donji; false ako je nema (prazna plocica)
+    virtual bool LoadTile(int level, int tileX, int tileY, unsigned char* rgba) = 0;
+
+    void ReadNative(int level, int x, int y, int w, int h, unsigned char* rgba) override;
+
+public:
+    TiledMapSource();
+};
+
+// Po ekstenziji: .mbtiles (SQLite baza plocica), .tif/.tiff (tiled GeoTIFF).
+// nullptr ako fajl nije podrzan ili nije ispravan (razlog se ispisuje)
+MapSource* openMapSource(const char* path);
+bool isMapSourcePath(const char* path);
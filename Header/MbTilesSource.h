@@ -0,0 +1,42 @@
+#pragma once
+#include "FileIO.h"
+#include "MapSource.h"
+#include <cstdint>
+#include <unordered_map>
+
+// MBTiles baza (SQLite) kao izvor mape. SQLite biblioteka nije potrebna: fajl se mapira u
+// memoriju i cita se direktno format baze (B-stabla tabela, prelivne stranice). Pri otvaranju
+// se jednom prodju listovi tabele plocica i napravi indeks (zoom, kolona, red) -> celija;
+// sama plocica (PNG/JPEG) se cita i dekodira tek kada je virtuelna tekstura zatrazi.
+// Podrzane su obe uobicajene seme: tabela "tiles" i pogled "tiles" nad "map" + "images".
+// Mapa pokriva plocice najveceg zooma; nivo L je zoom (maxzoom - L).
+class MbTilesSource : public TiledMapSource {
+private:
+    struct TileRef {
+        uint32_t page;          // Stranica baze sa celijom reda
+        uint16_t cell;          // Pomeraj celije u stranici
+        uint16_t column;        // Kolona tile_data u zapisu
+    };
+
+    MappedFile file;
+    uint32_t pageSize, usableSize;
+    std::unordered_map<uint64_t, TileRef> tiles;    // Kljuc: TileKey(zoom, kolona, red)
+    int minZoom, maxZoom;
+    int minColumn, minRow;      // TMS (red 0 = jug) na maxZoom
+    int columns, rows;
+
+    static uint64_t TileKey(int zoom, int column, int row);
+    bool ReadTileData(const TileRef& ref, std::vector<unsigned char>& data) const;
+
+protected:
+    bool HasLevel(int level) const override;
+    void TileOrigin(int level, int& originX, int& originY) const override;
+    bool LoadTile(int level, int tileX, int tileY, unsigned char* rgba) override;
+
+public:
+    MbTilesSource();
+
+    bool Open(const char* path);
+    bool GeoBounds(double& south, double& west, double& north, double& east) const override;
+    size_t TileCount() const { return tiles.size(); }
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// PNG koji se pise u delovima (trakama redova), pa slika ne mora cela da bude u memoriji.
+// Svaka traka se kompresuje nezavisno (CompressStrip, moze na radnoj niti); traka zavrsava
+// poravnata na bajt (prazan "stored" blok), pa se trake samo nadovezu u isti zlib tok.
+// Deflate koristi fiksne Huffman kodove i LZ77 sa kratkim lancem - brzo, uz osrednju
+// kompresiju (tipicno 2-3x za mapu).
+// Pre IEND ide privatni chunk "stRP" sa granicama traka (broj redova i bajtova deflate toka
+// po traci), pa ImageDecoder moze da raspakuje trake paralelno; ostali citaci ga preskacu.
+class PngWriter {
+public:
+    static const char STRIP_CHUNK[5];
+
+    struct Strip {
+        std::vector<unsigned char> data;    // Deflate blokovi (bez zlib zaglavlja)
+        uint32_t adler;                     // Adler-32 nekompresovanih (filtriranih) bajtova
+        size_t rawSize;
+        int rows;
+    };
+
+private:
+    FILE* file;
+    uint32_t adler;
+    size_t idatBytes;
+    std::vector<unsigned char> stripTable;  // Sadrzaj "stRP": po traci redovi (u32) i bajtovi (u64)
+    uint32_t stripCount;
+
+    void WriteChunk(const char type[4], const unsigned char* data, size_t size);
+
+public:
+    PngWriter();
+    ~PngWriter();
+
+    // RGB (channels = 3) ili RGBA (4), 8 bita po kanalu
+    bool Begin(const char* path, int width, int height, int channels);
+    // Trake moraju doci redom, od gornjeg reda slike
+    bool WriteStrip(const Strip& strip);
+    bool End();
+    void Abort();
+
+    size_t CompressedBytes() const { return idatBytes; }
+
+    // "rows" redova od "pixels" (gore -> dole, bez razmaka izmedju redova). Prvi red trake
+    // koristi filter Sub (ne zavisi od prethodne trake), ostali Up.
+    static void CompressStrip(const unsigned char* pixels, int width, int rows, int channels, Strip& out);
+};
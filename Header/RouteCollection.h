@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "RouteLOD.h"
+#include "RouteStore.h"
+
+class DistanceEngine;
+struct ImportedTracks;
+
+// Podaci jedne rute: tacke, LOD nivoi i granice. Posle objave (RouteCollection::Publish)
+// se vise ne menjaju; izmena pravi novu kopiju.
+struct RouteData {
+    RouteStore store;
+    RouteLOD lod;
+    float minX, minY, maxX, maxY;   // Granice u map space
+};
+
+// Sve rute u jednom trenutku, za citaoce na drugim nitima (render, izvoz, snimanje sesije).
+// Nepromenljiv dok god ga neko drzi; nepromenjene rute dele podatke sa prethodnim verzijama.
+struct RouteSnapshot {
+    uint64_t version;
+    std::vector<std::shared_ptr<const RouteData>> routes;  // Indeks = id ruta; nullptr = obrisana
+
+    int Count() const { return (int)routes.size(); }
+    const RouteData* Route(int id) const { return id >= 0 && id < Count() ? routes[id].get() : nullptr; }
+};
+
+typedef std::shared_ptr<const RouteSnapshot> RouteSnapshotPtr;
+
+// Sve rute (merena + sacuvane/uvezene). Menja ih samo jedna nit (nit dogadjaja); ostale niti
+// citaju verzije (RCU): Publish objavi nov RouteSnapshot jednom atomskom zamenom pokazivaca,
+// citalac uzme trenutni sa Snapshot() i koristi ga bez brava koliko mu treba, a stara verzija
+// nestaje sa poslednjim citaocem. Izmena rute koja je vec objavljena prvo pravi njenu kopiju
+// (copy-on-write), najvise jednom po objavi; kopija deli nizove sa objavljenom verzijom, a
+// tacke dodate na kraj idu iza onih koje citaoci vide, pa klik ne kopira celu rutu.
+// GPU bafere ruta drzi RouteRenderer (render nit).
+class RouteCollection {
+private:
+    struct Route {
+        std::shared_ptr<RouteData> data;    // nullptr = obrisana
+        bool shared;                        // data je u objavljenoj verziji (izmena ide u kopiju)
+    };
+
+    std::vector<Route> routes;
+    bool changed;                           // Od poslednje objave
+    uint64_t version;
+    RouteSnapshotPtr published;             // Samo std::atomic_load / std::atomic_store
+
+    RouteData& Edit(int id);
+    static void UpdateBounds(RouteData& data);
+
+public:
+    RouteCollection();
+
+    int Create();
+    void Remove(int id);
+    void Clear(int id);
+    int Count() const { return (int)routes.size(); }
+    bool IsAlive(int id) const { return id >= 0 && id < (int)routes.size() && routes[id].data != nullptr; }
+    // Trenutno stanje (samo nit koja menja rute)
+    const RouteStore& Store(int id) const { return routes[id].data->store; }
+
+    void Append(int id, Point point, const DistanceEngine& engine);
+    void Erase(int id, size_t index, const DistanceEngine& engine);
+    void Assign(int id, const float* xs, const float* ys, size_t count, DistanceEngine& engine);
+    // Svaka staza postaje nova ruta (id-jevi redom staza). Duzine, LOD i granice se racunaju
+    // paralelno u JobSystem-u
+    void AddTracks(const ImportedTracks& tracks, const DistanceEngine& engine);
+
+    // Nit koja menja rute: izmene od prethodnog poziva postaju vidljive citaocima
+    void Publish();
+    // Bilo koja nit: poslednja objavljena verzija (nikad nullptr)
+    RouteSnapshotPtr Snapshot() const;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ImportedTracks;
+
+struct RouteFileStats {
+    size_t bytes;
+    size_t points;
+    size_t routes;
+    size_t corruptBlocks;   // Blokovi odbaceni zbog pogresnog checksum-a (ucitavanje staje na prvom)
+    double milliseconds;
+};
+
+// Binarni fajl ruta (sesija merenja). Koordinate (map space) su kvantizovane na 2^-24
+// (ispod 0.1 mm na mapi od 1 km), a svaka tacka je razlika od prethodne kao zigzag varint,
+// tipicno 2-4 bajta po koordinati. Tacke su u blokovima od BLOCK_POINTS; blok pocinje
+// apsolutnom tackom i ima svoj CRC32, pa se ostecenje otkriva po bloku.
+//
+// Raspored (little-endian):
+//   zaglavlje: magic, version (u16), headerSize (u16), routes, blocks, points, scaleBits, crc
+//   blok:      route, points, payloadBytes, crc (zaglavlja bloka + payload), payload
+class RouteFile {
+public:
+    static const uint32_t MAGIC = 0x4554524B;   // "KRTE"
+    static const uint16_t VERSION = 1;
+    static const uint32_t BLOCK_POINTS = 4096;
+    static const uint32_t SCALE_BITS = 24;
+
+private:
+    std::vector<unsigned char> buffer;  // Ceo fajl pre upisa
+    uint32_t routeCount, blockCount, pointCount;
+
+public:
+    RouteFile();
+
+    // Snimanje: Begin, AddRoute za svaku rutu, pa Write (atomicno: ili stari ili novi fajl)
+    void Begin();
+    void AddRoute(const float* xs, const float* ys, size_t count);
+    bool Write(const char* path, RouteFileStats& stats);
+
+    // Ucitavanje preko mmap-a; "out" dobija sve ispravne rute. false ako fajla nema ili
+    // zaglavlje nije ispravno (tada se nista ne ucitava)
+    static bool Load(const char* path, ImportedTracks& out, RouteFileStats& stats);
+
+    static uint32_t Crc32(const unsigned char* data, size_t size, uint32_t crc = 0);
+};
+
+// Snimanje i ucitavanje milion tacaka u ovom formatu i u naivnom tekstualnom ("x y" po liniji)
+void benchmarkRouteFile();
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+class GeoReference;
+
+// Staze iz fajla u map space, sve jedna za drugom (SoA)
+struct ImportedTracks {
+    std::vector<float> xs, ys;
+    std::vector<size_t> trackEnds;  // Indeks posle poslednje tacke svake staze
+
+    void Clear();
+};
+
+struct RouteImportStats {
+    size_t bytes;
+    size_t points;
+    size_t tracks;
+    double seconds;                 // Citanje + parsiranje + konverzija u map space
+
+    double PointsPerSecond() const { return seconds > 0.0 ? points / seconds : 0.0; }
+};
+
+// Uvoz snimljenih staza iz GPX (trkpt/rtept) i GeoJSON (LineString/MultiLineString) fajlova.
+// Fajl se cita u blokovima od CHUNK_SIZE bajtova i parsira dogadjajima (SAX, bez stabla
+// dokumenta), pa je memorija srazmerna broju tacaka, a ne velicini fajla. Koordinate idu
+// kroz georeferencu mape direktno u map space.
+// Svaki trkseg/rte (GPX) i svaka linija (GeoJSON) je posebna staza.
+class RouteImporter {
+private:
+    std::vector<char> chunk;
+
+public:
+    static const size_t CHUNK_SIZE = 1 << 16;
+
+    enum class Format { Unknown, Gpx, GeoJson };
+
+    // Po ekstenziji (.gpx, .geojson, .json); ako je nepoznata, po prvom znaku sadrzaja
+    static Format DetectFormat(const char* path, const char* head, size_t headSize);
+
+    // "out" se prazni i puni; vraca false ako fajl ne moze da se otvori ili format nije prepoznat
+    bool Import(const char* path, const GeoReference& reference, ImportedTracks& out, RouteImportStats& stats);
+};
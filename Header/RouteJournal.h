@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FileIO.h"
+
+// Dnevnik izmena ruta posle poslednjeg snimanja sesije (RouteFile). Svaka izmena
+// (klik: dodata/obrisana tacka, nova ruta) je zapis od 20 bajtova sa svojim CRC32 koji
+// se dopisuje na kraj fajla. Render nit samo stavi zapis u red; upis i fsync radi
+// pozadinska nit, vise zapisa odjednom (jedan fsync za sve sto stigne u COALESCE_MS).
+// Posle pada se pri pokretanju ucita sesija i ponove zapisi; nepotpun zapis na kraju
+// (prekinut upis) se odbacuje.
+class RouteJournal {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t NO_ROUTE = 0xFFFFFFFFu;
+    static const int COALESCE_MS = 20;
+
+    enum class Op : uint32_t {
+        Header = 1,     // arg = verzija; prvi zapis fajla
+        Resume = 2,     // arg = indeks aktivne rute u fajlu sesije (NO_ROUTE = nova ruta)
+        Append = 3,     // Tacka (x, y) na kraj aktivne rute
+        Erase = 4,      // arg = indeks tacke aktivne rute
+        NewRoute = 5    // Nova aktivna ruta
+    };
+
+    struct Entry {
+        Op op;
+        uint32_t arg;
+        float x, y;
+    };
+
+    struct Stats {
+        size_t records;
+        size_t syncs;
+        double maxRecordMicros;     // Najvece kasnjenje koje je Record dodao kliku (nit dogadjaja)
+        double maxDurableMillis;    // Najduze od klika do zavrsenog fsync-a
+    };
+
+private:
+    struct Queued {
+        Entry entry;
+        bool truncate;              // Reset: novi fajl (sesija je upravo snimljena)
+        std::chrono::steady_clock::time_point time;
+    };
+
+    std::string path;
+    AppendFile file;
+    std::vector<Queued> pending, writing;
+    std::vector<unsigned char> bytes;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+    std::thread worker;
+    Stats stats;                    // Pod mutex-om (osim maxRecordMicros)
+    double maxRecordMicros;         // Samo nit dogadjaja
+    double frameRecordMicros;       // Pod mutex-om; najvece od poslednjeg TakeFrameRecordMicros
+
+    void WorkerLoop();
+    void Encode(const Entry& entry);
+
+public:
+    RouteJournal();
+    ~RouteJournal();
+
+    // Svi ispravni zapisi postojeceg dnevnika (pre Start); false ako ga nema
+    static bool Read(const char* path, std::vector<Entry>& out);
+
+    // Zapisi dodati pre Start (npr. Reset posle snimanja sesije) upisuju se prvi. Postojeci
+    // fajl se nastavlja, pa prvi zapis posle pokretanja treba da bude Reset (odbacuje i
+    // eventualni nepotpun zapis sa kraja)
+    void Start(const char* path);
+    // Upise sve sto je u redu i zaustavi nit
+    void Stop();
+
+    // Render nit: ne ceka disk, samo kratko zakljucavanje reda
+    void Record(Op op, uint32_t arg = 0, float x = 0.0f, float y = 0.0f);
+    // Posle snimanja sesije: dnevnik pocinje iznova od aktivne rute
+    void Reset(uint32_t resumeRoute);
+
+    Stats GetStats();
+    // Render nit, jednom po frejmu (FrameStats::journalRecordMaxUs)
+    double TakeFrameRecordMicros();
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Geometry.h"
+#include "SharedArray.h"
+
+// Nivoi detalja za rutu: nivo 0 su sve tacke, svaki sledeci je Douglas-Peucker
+// uproscenje sa duplo vecom tolerancijom. Nivoi se dopunjuju inkrementalno kada se
+// tacke dodaju na kraj, a iscrtava se nivo cija greska ne prelazi pola piksela.
+// Poslednja tacka rute je kraj svakog nivoa, ali se ne cuva u njemu: jedino se ona menja
+// kada se tacka doda, pa se nivoi samo dopisuju i kopija deli njihove nizove (SharedArray).
+class RouteLOD {
+public:
+    static const int LEVEL_COUNT = 10;
+
+private:
+    SharedArray<unsigned int> levels[LEVEL_COUNT];  // Indeksi zadrzanih tacaka, bez poslednje
+    size_t builtCount;                              // Koliko tacaka je vec obradjeno
+
+    // DP nad [first, last], dodaje zadrzane indekse (bez "first") u "out"
+    static void Simplify(const float* xs, const float* ys, unsigned int first, unsigned int last,
+        float tolerance, std::vector<unsigned int>& out);
+
+public:
+    // Tolerancija nivoa 1 u map space; nivo k ima BASE_TOLERANCE * 2^(k-1)
+    static const float BASE_TOLERANCE;
+
+    RouteLOD();
+
+    void Clear();
+    // Tacke (SoA, map space) su samo dodate na kraj (od poslednjeg poziva)
+    void Append(const float* xs, const float* ys, size_t count);
+    // Tacke su menjane proizvoljno (brisanje, uvoz)
+    void Rebuild(const float* xs, const float* ys, size_t count);
+
+    static float Tolerance(int level);
+
+    // Najgrublji nivo cija je greska <= pola piksela; zoom = deo mape koji se vidi
+    static int SelectLevel(float zoom, int viewportPixels);
+
+    // Broj indeksa nivoa (sa poslednjom tackom)
+    size_t Count(int level) const { return builtCount > 0 ? levels[level].size() + 1 : 0; }
+
+    // Svi nivoi jedan za drugim (za jedan element bafer); offsets[k] = prvi indeks nivoa k
+    void BuildIndexBuffer(std::vector<unsigned int>& out, unsigned int offsets[LEVEL_COUNT]) const;
+};
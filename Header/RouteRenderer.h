@@ -0,0 +1,62 @@
+#pragma once
+#include <GL/glew.h>
+#include <memory>
+#include <vector>
+#include "CommandList.h"
+#include "RouteCollection.h"
+
+class Camera;
+
+// Crtanje ruta iz RouteSnapshot-a (render nit). Svaka ruta ima svoj opseg u zajednickom
+// vertex/index baferu, pa izmena jedne rute salje samo njen opseg. Rute van pogleda se
+// preskacu, a sve vidljive idu u dva poziva (linije i tacke) preko multi-draw-indirect
+// (ili glMultiDrawElementsBaseVertex bez ARB_multi_draw_indirect).
+class RouteRenderer {
+private:
+    // GPU opseg rute sa istim id-jem u snimku
+    struct Slot {
+        // Verzija podataka koja je u baferima. Drzi je zivom, pa je "ruta se promenila"
+        // samo poredjenje pokazivaca sa snimkom (adresa ne moze da se ponovo iskoristi)
+        std::shared_ptr<const RouteData> uploaded;
+        unsigned int vertexStart, vertexCapacity;   // Opseg u vertex baferu (tacke)
+        unsigned int indexStart, indexCapacity;     // Opseg u index baferu
+        unsigned int levelOffsets[RouteLOD::LEVEL_COUNT]; // U okviru opsega rute
+        unsigned int levelCounts[RouteLOD::LEVEL_COUNT];
+    };
+
+    // Raspored koji ocekuje glMultiDrawElementsIndirect
+    struct IndirectCommand {
+        GLuint count, instanceCount, firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    std::vector<Slot> slots;
+    unsigned int VAO, VBO, EBO;
+    unsigned int vertexCapacity, indexCapacity; // Velicina bafera (tacke / indeksi)
+    unsigned int vertexUsed, indexUsed;         // Do ovde su dodeljeni opsezi
+    unsigned int vertexWasted;                  // Opsezi obrisanih/preraslih ruta
+
+    // Scratch (bez alokacija posle zagrevanja)
+    std::vector<unsigned int> indices;
+    std::vector<IndirectCommand> commands;      // Linije pa tacke
+    std::vector<GLsizei> counts;
+    std::vector<const void*> indexOffsets;
+    std::vector<GLint> baseVertices;
+    MultiDrawBatch lineBatch, pointBatch;
+
+    // Upisi za rute koje se razlikuju od snimka; ako neka ne staje u svoj opseg, sve se presloze
+    void SyncBuffers(CommandList& list, const RouteSnapshot& snapshot);
+    void Repack(CommandList& list, const RouteSnapshot& snapshot);
+    void WriteRoute(Slot& slot, const std::shared_ptr<const RouteData>& data, float* vertices, unsigned int* indexData);
+
+public:
+    RouteRenderer();
+
+    void Init();
+    void Destroy();
+
+    // Upisi izmena + odsecanje po pogledu kamere + dve multi-draw komande
+    void Record(CommandList& list, const RouteSnapshot& snapshot, unsigned int lineProgram,
+        unsigned int pointProgram, const Camera& camera, int viewportPixels);
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include "Geometry.h"
+#include "SharedArray.h"
+
+class DistanceEngine;
+
+// Merena ruta kao SoA: x i y svake tacke (map space) u svojim nizovima i duzina
+// svakog segmenta (metri). Segment i spaja tacke i i i + 1, pa se tacke ne kopiraju
+// po segmentima: 12 bajtova po tacki umesto tacke + linije sa oba kraja (28).
+// Kopija deli nizove sa originalom (SharedArray), pa je kopija pri izmeni objavljene rute
+// O(1), a tacke dodate na kraj ne kopiraju postojece.
+class RouteStore {
+private:
+    SharedArray<float> xs, ys;
+    SharedArray<float> lengths;     // lengths[i] = segment (i, i + 1)
+    double total;
+
+    void SumLengths();
+
+public:
+    RouteStore();
+
+    size_t Size() const { return xs.size(); }
+    bool Empty() const { return xs.empty(); }
+    const float* X() const { return xs.data(); }
+    const float* Y() const { return ys.data(); }
+    Point At(size_t index) const { return Point(xs[index], ys[index]); }
+
+    size_t SegmentCount() const { return lengths.size(); }
+    float SegmentLength(size_t index) const { return lengths[index]; }
+    const float* SegmentLengths() const { return lengths.data(); }
+    double TotalLength() const { return total; }
+
+    void Clear();
+    // Nova tacka na kraju - racuna se samo novi segment
+    void Append(Point point, const DistanceEngine& engine);
+    // Brisanje tacke - dva susedna segmenta postaju jedan
+    void Erase(size_t index, const DistanceEngine& engine);
+    // Cela ruta odjednom (uvoz) - duzine paketno
+    void Assign(const float* x, const float* y, size_t count, DistanceEngine& engine);
+
+    // x0, y0, x1, y1, ... za vertex bafer (out ima mesta za 2 * Size() float-ova)
+    void Interleave(float* out) const;
+};
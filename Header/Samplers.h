@@ -0,0 +1,41 @@
+#pragma once
+#include <GL/glew.h>
+
+// Sampler objekti po nameni - parametri uzorkovanja vise nisu vezani za teksturu
+enum class SamplerUse { Map = 0, Icon, Font, PageCache, Count };
+
+// Konfiguracije filtriranja mape (F5 ih menja redom)
+enum class MapFilter { Trilinear = 0, Anisotropic4x, AnisotropicMax, Count };
+
+class Samplers {
+private:
+    unsigned int samplers[(int)SamplerUse::Count];
+    float maxAnisotropy;        // 1.0 = anizotropno filtriranje nije podrzano
+    MapFilter mapFilter;
+    int lodBiasIndex;
+
+    void ApplyMapConfig();
+
+public:
+    Samplers();
+
+    void Init();
+    void Destroy();
+
+    unsigned int Get(SamplerUse use) const { return samplers[(int)use]; }
+
+    void SetMapFilter(MapFilter filter);
+    MapFilter GetMapFilter() const { return mapFilter; }
+    void NextMapFilter();
+
+    // LOD bias mape (F6): negativan = ostrije/vise treperenja, pozitivan = mutnije
+    void SetLodBiasIndex(int index);
+    int GetLodBiasIndex() const { return lodBiasIndex; }
+    void NextLodBias();
+    float GetLodBias() const;
+
+    static const int LOD_BIAS_COUNT = 4;
+    static const char* FilterName(MapFilter filter);
+};
+
+extern Samplers samplers;
@@ -0,0 +1,51 @@
+#pragma once
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Prati fajlove sejdera i kada se promene ponovo ih kompajlira na pozadinskoj niti
+// (sa svojim, deljenim GL kontekstom). Render nit samo zameni ID programa kada je
+// linkovanje uspelo i drajver zavrsio (fence), pa izmena nikad ne blokira frejm.
+class ShaderReloader {
+private:
+    struct WatchedProgram {
+        unsigned int* target;          // Globalna promenljiva koja drzi ID programa
+        std::string vsPath, fsPath;
+        std::filesystem::file_time_type vsTime, fsTime;
+    };
+
+    struct ReadyProgram {
+        size_t index;                  // Indeks u "watched"
+        unsigned int program;
+        GLsync fence;
+    };
+
+    std::vector<WatchedProgram> watched;
+    std::vector<ReadyProgram> ready;   // Zasticeno sa readyMutex
+    std::mutex readyMutex;
+
+    GLFWwindow* sharedContext;         // Nevidljivi prozor ciji kontekst deli objekte sa glavnim
+    std::thread worker;
+    std::atomic<bool> running;
+
+    void WorkerLoop();
+
+public:
+    ShaderReloader();
+    ~ShaderReloader();
+
+    // Registruj program za pracenje (pozvati pre Start)
+    void Watch(unsigned int* program, const char* vsPath, const char* fsPath);
+
+    // Napravi deljeni kontekst i pokreni nit (glavna nit, kontekst mainWindow mora postojati)
+    bool Start(GLFWwindow* mainWindow);
+    void Stop();
+
+    // Poziva se jednom po frejmu na render niti; vraca true ako je neki program zamenjen
+    bool Update();
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+// Niz (za jednostavne tipove: float, indeksi) ciju memoriju kopije dele. Kopija je samo jos
+// jedan pokazivac na isti blok i broj elemenata, a Append u kopiju pise iza svih elemenata koje
+// je iko video, pa objavljena verzija rute i njena izmena dele iste tacke bez kopiranja.
+// Tek izmena vidljivog elementa (set, erase) ili dodavanje posle skracivanja pravi nov blok.
+// Kopira i menja samo jedna nit; ostale niti samo citaju svoje kopije.
+template <typename T>
+class SharedArray {
+private:
+    struct Block {
+        std::unique_ptr<T[]> data;
+        size_t capacity;
+        size_t used;        // Najvise upisanih elemenata (od svih kopija); iza toga je slobodno
+        bool shared;        // Postoji kopija: upisani elementi se vise ne menjaju na mestu
+    };
+
+    std::shared_ptr<Block> block;
+    size_t count;
+
+    // Nov blok sa prvih "keep" elemenata
+    void Reallocate(size_t capacity, size_t keep) {
+        std::shared_ptr<Block> next = std::make_shared<Block>();
+        next->data.reset(new T[capacity]);
+        next->capacity = capacity;
+        next->used = keep;
+        next->shared = false;
+        if (keep > 0) memcpy(next->data.get(), block->data.get(), keep * sizeof(T));
+        block = std::move(next);
+    }
+
+public:
+    SharedArray() : count(0) {}
+
+    SharedArray(const SharedArray& other) : block(other.block), count(other.count) {
+        if (block) block->shared = true;
+    }
+
+    SharedArray& operator=(const SharedArray& other) {
+        block = other.block;
+        count = other.count;
+        if (block) block->shared = true;
+        return *this;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* data() const { return block ? block->data.get() : nullptr; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + count; }
+    const T& operator[](size_t index) const { return block->data[index]; }
+    const T& back() const { return block->data[count - 1]; }
+
+    void clear() {
+        block.reset();
+        count = 0;
+    }
+
+    void push_back(const T& value) {
+        // Na mestu samo iza svega sto je upisano, inace bi se prepisao element neke kopije
+        if (!block || block->used != count || count == block->capacity)
+            Reallocate(std::max<size_t>(16, count * 2), count);
+        block->data[count++] = value;
+        block->used = count;
+    }
+
+    // Element ostaje u bloku (kopije ga i dalje vide); sledeci push_back pravi nov blok
+    void pop_back() { count--; }
+
+    void set(size_t index, const T& value) {
+        if (block->shared) Reallocate(block->capacity, count);
+        block->data[index] = value;
+    }
+
+    void erase(size_t index) {
+        std::shared_ptr<Block> old = block;
+        Reallocate(old->capacity, index);
+        memcpy(block->data.get() + index, old->data.get() + index + 1, (count - index - 1) * sizeof(T));
+        count--;
+        block->used = count;
+    }
+
+    void assign(const T* first, const T* last) {
+        T* out = Overwrite((size_t)(last - first));
+        if (first != last) memcpy(out, first, (last - first) * sizeof(T));
+    }
+
+    // Nov blok sa "size" neinicijalizovanih elemenata za upis (npr. paketno racunanje)
+    T* Overwrite(size_t size) {
+        block.reset();
+        count = 0;
+        Reallocate(std::max<size_t>(16, size), 0);
+        count = size;
+        block->used = size;
+        return block->data.get();
+    }
+};
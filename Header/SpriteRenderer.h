@@ -0,0 +1,46 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include "CommandList.h"
+
+// Svi teksturisani pravougaonici (mapa, ikone, pozadina teksta) idu kroz jedan program.
+// Pogled je u uniform bloku ViewParams (vidi Camera.h), a pozicija/skala/alpha svakog
+// sprite-a su atributi po instanci u StreamBuffer-u (jedan upis po frejmu, bez sinhronizacije).
+class SpriteRenderer {
+private:
+    struct Instance {
+        float x, y;             // Pozicija u NDC
+        float scaleX, scaleY;
+        float alpha;
+        float useView;          // 1.0 = pozicija je u map space i prolazi kroz matricu pogleda
+    };
+
+    static const int MAX_SPRITES = 64;
+
+    unsigned int VAO, quadVBO;
+
+    std::vector<Instance> instances;
+    std::vector<unsigned int> textures; // Tekstura svake instance
+    std::vector<RenderLayer> layers;    // Sloj svake instance
+
+    static void SetInstanceOffset(void* owner, int first);
+
+public:
+    SpriteRenderer();
+    ~SpriteRenderer();
+
+    void Init();
+
+    // Pocetak frejma: obrisi listu
+    void Begin();
+
+    // Dodaj sprite (podrazumevano HUD sloj)
+    void Add(unsigned int texture, float x, float y, float scale, float alpha = 1.0f, RenderLayer layer = RenderLayer::Hud);
+    // Mapa kao kvadrat [0,1] u map space (na ekran je postavlja matrica pogleda)
+    void AddMap(unsigned int texture);
+
+    // Upisi instance u StreamBuffer (jednom za ceo frejm) i snimi po jednu
+    // instanciranu komandu za svaki niz susednih sprite-ova sa istim slojem i teksturom.
+    // Ako je virtualMapShader != 0, mapa je kes stranica virtuelne teksture (vidi VirtualTexture.h)
+    void Record(CommandList& list, unsigned int shader, unsigned int virtualMapShader = 0);
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+// Prstenasti vertex bafer za sve dinamicke vertekse (instance sprite-ova, tekst).
+// Podeljen je na FRAMES delova; svaki frejm pise u svoj deo, a pre ponovnog
+// koriscenja dela ceka fence iz frejma koji ga je koristio (obicno vec signaliziran).
+// Sa ARB_buffer_storage bafer je trajno mapiran (persistent + coherent) i upis je
+// obican memcpy; bez njega se pise u kopiju na CPU, na pocetku kruga bafer se
+// "orphan"-uje, a Flush upisuje novi opseg nesinhronizovanim mapiranjem.
+class StreamBuffer {
+public:
+    static const size_t DEFAULT_SIZE = 1 << 20;
+    static const int FRAMES = 3;
+
+    struct Allocation {
+        void* data;         // nullptr ako u delu frejma nema mesta
+        size_t offset;      // Od pocetka bafera, deljivo sa "stride"
+    };
+
+private:
+    unsigned int buffer;
+    size_t size, segmentSize;
+    int segment;                    // Deo koji koristi tekuci frejm
+    size_t head;                    // Sledeci slobodan bajt (apsolutno)
+    size_t flushed;                 // Do ovde je fallback vec upisan u bafer
+    bool persistent;
+    unsigned char* mapped;          // Trajno mapiran bafer ili kopija na CPU
+    std::vector<unsigned char> shadow;
+    GLsync fences[FRAMES];
+    bool overflowReported;
+
+public:
+    StreamBuffer();
+
+    void Init(size_t bytes = DEFAULT_SIZE);
+    void Destroy();
+
+    unsigned int Buffer() const { return buffer; }
+    bool IsPersistent() const { return persistent; }
+
+    // Pocetak frejma: predji na sledeci deo (ceka GPU samo ako je zaostao FRAMES frejmova)
+    void BeginFrame();
+    // Prostor za "bytes" bajtova; offset je umnozak "stride" (da se moze adresirati
+    // indeksom verteksa/instance). Snimanje ne poziva GL.
+    Allocation Allocate(size_t bytes, size_t stride);
+    // Pre iscrtavanja: u fallback rezimu posalje sve upisano od poslednjeg Flush-a
+    void Flush();
+    // Posle poslednjeg iscrtavanja iz ovog dela
+    void EndFrame();
+};
+
+extern StreamBuffer streamBuffer;
@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Priprema stranica (plocica) mape na radnim nitima (JobSystem). Render nit salje zahteve
+// (kljuc stranice) i svaki frejm preuzme gotove piksele; GL poziva ovde nema.
+// Jedan posao ucita jednu stranicu, pa ako red nije prazan prijavi sledeci; broj takvih
+// poslova je ogranicen, da ucitavanje mape ne zauzme sve radne niti.
+// Zahtevi iz feedback-a (vidljive stranice) uvek idu pre predvidjenih (prefetch),
+// a broj stranica u obradi je ogranicen da prefetch ne bi zagusio ucitavanje.
+class TileStreamer {
+public:
+    static const int MAX_IN_FLIGHT = 32;
+
+    enum class Priority { Demand, Prefetch };
+
+    // Puni piksele stranice (PAGE_SIZE x PAGE_SIZE RGBA); poziva se sa radnih niti
+    typedef std::function<void(uint64_t key, unsigned char* pixels)> LoadFunction;
+
+    struct Tile {
+        uint64_t key;
+        Priority priority;
+        std::vector<unsigned char> pixels;
+    };
+
+private:
+    struct Job {
+        uint64_t key;
+        Priority priority;
+    };
+
+    // Red fiksne velicine: svaki posao u redu je i u inFlight, pa ih nikad nema vise od
+    // MAX_IN_FLIGHT i red ne ide na heap
+    struct JobQueue {
+        Job jobs[MAX_IN_FLIGHT];
+        int head, count;
+
+        JobQueue() : head(0), count(0) {}
+        bool empty() const { return count == 0; }
+        int size() const { return count; }
+        const Job& operator[](int index) const { return jobs[(head + index) % MAX_IN_FLIGHT]; }
+        const Job& front() const { return jobs[head]; }
+        void push_back(const Job& job) { jobs[(head + count++) % MAX_IN_FLIGHT] = job; }
+        void pop_front() { head = (head + 1) % MAX_IN_FLIGHT; count--; }
+        void clear() { head = count = 0; }
+    };
+
+    LoadFunction load;
+    size_t tileBytes;
+
+    JobQueue demand, prefetch;              // Jos nisu zapoceti
+    std::vector<uint64_t> inFlight;         // U redu, u obradi ili gotovi a nepreuzeti (najvise MAX_IN_FLIGHT)
+    std::vector<Tile> ready;
+    std::vector<std::vector<unsigned char>> freeBuffers; // Ponovo se koriste, bez alokacije po stranici
+    std::mutex mutex;
+    std::condition_variable idle;           // Stop ceka da se poslovi zavrse
+    bool running;
+    int maxJobs, activeJobs;                // Prijavljeni poslovi (u redu JobSystem-a ili u radu)
+
+    void LoadNext();
+    bool Contains(uint64_t key) const;      // Pod mutex-om
+    void Remove(uint64_t key);
+
+public:
+    TileStreamer();
+    ~TileStreamer();
+
+    // jobCount = najvise stranica koje se istovremeno ucitavaju
+    void Start(int jobCount, size_t tileBytes, LoadFunction load);
+    void Stop();
+
+    // false ako je stranica vec u obradi ili je budzet pun (prefetch mora da saceka,
+    // a zahtev iz feedback-a izbacuje najstariji nezapoceti prefetch)
+    bool Request(uint64_t key, Priority priority);
+
+    // Odbaci predvidjanja koja jos nisu zapoceta (pravac kretanja se promenio)
+    void CancelPrefetch();
+
+    // Preuzmi jednu gotovu stranicu; buffer vratiti sa Recycle posle upisa u kes
+    bool PopReady(Tile& tile);
+    void Recycle(std::vector<unsigned char>&& pixels);
+
+    bool IsInFlight(uint64_t key);
+    int InFlightCount();
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+
+// Tri kopije stanja izmedju jednog proizvodjaca i jednog potrosaca, bez brava i bez cekanja.
+// Proizvodjac uvek pise u svoju kopiju i objavi je (Publish), potrosac uzme najnoviju
+// objavljenu (Update). Treca kopija je uvek ona koja je poslednja objavljena, pa nijedna
+// strana ne ceka drugu; potrosac koji kasni preskace medjukopije.
+// Posle Publish proizvodjac dobija neku stariju kopiju: Write() treba popuniti celu.
+template <typename T>
+class TripleBuffer {
+private:
+    static const int INDEX_MASK = 3;
+    static const int NEW_BIT = 4;   // Objavljena kopija koju potrosac jos nije uzeo
+
+    T slots[3];
+    int writeIndex;                 // Samo proizvodjac
+    int readIndex;                  // Samo potrosac
+    std::atomic<int> shared;        // Indeks trece kopije | NEW_BIT
+
+public:
+    TripleBuffer() : slots(), writeIndex(0), readIndex(1), shared(2) {}
+
+    T& Write() { return slots[writeIndex]; }
+
+    void Publish() {
+        writeIndex = shared.exchange(writeIndex | NEW_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // true ako je od prethodnog poziva objavljena nova kopija (Read je tada ta kopija)
+    bool Update() {
+        if (!(shared.load(std::memory_order_relaxed) & NEW_BIT)) return false;
+        readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& Read() const { return slots[readIndex]; }
+};
@@ -4,6 +4,20 @@
 #include <string>
 int endProgram(std::string message);
 unsigned int createShader(const char* vsSource, const char* fsSource);
+// Dvofazno pravljenje sejdera: submitShader salje kompajliranje/linkovanje, finishShaders ceka i provjerava greske
+void initParallelShaderCompile();
+unsigned int submitShader(const char* vsSource, const char* fsSource);
+bool shadersReady();
+void finishShaders();
+// Sinhrono pravljenje programa za druge niti/kontekste; vraca 0 ako nije uspjelo
+unsigned int tryCreateShader(const char* vsSource, const char* fsSource);
 unsigned loadImageToTexture(const char* filePath);
 GLFWcursor* loadImageToCursor(const char* filePath);
-unsigned loadImageToTextureRGBA(const char* filePath);
\ No newline at end of file
+unsigned loadImageToTextureRGBA(const char* filePath);
+// Isto za vise slika odjednom: dekodiranje paralelno, teksture kao poslovi glavne niti (JobSystem);
+// poziva nit sa GL kontekstom, koja je i glavna nit JobSystem-a
+void loadImagesToTexturesRGBA(const char* const* filePaths, unsigned* textures, int count);
+// Piksele slike (RGBA, red 0 = dno) za obradu na CPU; oslobadja se sa freeImagePixels
+unsigned char* loadImagePixels(const char* filePath, int* width, int* height);
+void freeImagePixels(unsigned char* pixels);
+unsigned createTextureRGBA(const unsigned char* pixels, int width, int height, bool mipmaps);
\ No newline at end of file
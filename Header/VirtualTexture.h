@@ -0,0 +1,109 @@
+#pragma once
+#include <GL/glew.h>
+#include "MapSource.h"
+#include "TileStreamer.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Virtuelna tekstura za mapu proizvoljne velicine (i vece od GL_MAX_TEXTURE_SIZE):
+// mapa je podeljena na stranice po mip nivoima, na GPU je samo kes stranica koje se
+// vide. Feedback prolaz (male rezolucije) upisuje koje stranice map.frag trazi,
+// a indirekciona tekstura (jedan mip po nivou) za svaku stranicu pokazuje na
+// najbolju stranicu koja je u kesu. Mapa se i dalje crta jednim pozivom.
+// Stranice se pripremaju na pozadinskim nitima (TileStreamer) iz izvora mape (MapSource:
+// slika u memoriji, MBTiles, GeoTIFF); pri kretanju se unapred traze stranice u pravcu
+// brzine (Prefetch), da ne bi kasnile na ekran.
+class VirtualTexture {
+public:
+    static const int PAGE_SIZE = 128;               // Stranica u kesu (sa ivicom)
+    static const int PAGE_BORDER = 1;               // Ivica za bilinearno filtriranje
+    static const int PAGE_PAYLOAD = PAGE_SIZE - 2 * PAGE_BORDER;
+    static const int CACHE_PAGES = 16;              // Kes je CACHE_PAGES x CACHE_PAGES stranica
+    static const int FEEDBACK_SHIFT = 3;            // Feedback je 1/8 rezolucije ekrana
+    static const int MAX_UPLOADS_PER_FRAME = 8;
+    static const unsigned int PARAMS_BINDING = 1;   // Uniform blok VirtualTextureParams
+    static const unsigned int INDIRECTION_UNIT = 1; // Jedinica teksture za uIndirection
+    static const int LOAD_JOBS = 2;                 // Stranice koje se istovremeno ucitavaju (JobSystem)
+    static constexpr float PREFETCH_LOOKAHEAD = 0.5f; // Sekundi unapred
+
+private:
+    struct Level {
+        int width, height;          // U tekselima
+        int pagesX, pagesY;
+    };
+
+    struct CacheSlot {
+        uint64_t key;               // Stranica koja je u slotu (0 = prazan)
+        unsigned int lastUsed;      // Poslednji frejm u kome je trazena
+        bool locked;                // Najgrublji nivo je uvek u kesu
+    };
+
+    // std140
+    struct Params {
+        float virtualSize[4];       // xy = velicina u tekselima, z = payload, w = ivica
+        float cacheInfo[4];         // xy = velicina kesa u tekselima, z = velicina stranice, w = najgrublji nivo
+        float feedbackInfo[4];      // x = log2 umanjenja feedback prolaza
+    };
+
+    MapSource* source;              // Ne pripada teksturi; mora da nadzivi radne niti
+    std::vector<Level> levels;
+    int maxLevel;
+
+    unsigned int cacheTexture, indirectionTexture, paramsUBO;
+    int indirectionWidth, indirectionHeight; // Nivo 0 indirekcije (stepen dvojke)
+    std::vector<std::vector<unsigned char>> indirection; // RGBA8UI po nivou
+    bool indirectionDirty;
+
+    std::vector<CacheSlot> slots;
+    std::unordered_map<uint64_t, int> resident; // Stranica -> slot
+
+    // Feedback prolaz
+    unsigned int feedbackFBO, feedbackColor, quadVAO, quadVBO;
+    int feedbackWidth, feedbackHeight;
+    unsigned int readbackPBO[2];
+    GLsync readbackFence[2];
+    int readbackWidth[2], readbackHeight[2];
+    int readbackIndex;
+    unsigned int feedbackProgram;   // Poslednji program kome je vezan blok
+    unsigned int frame;
+
+    std::vector<uint64_t> visiblePages, neededPages; // Feedback frejma (sortirano, bez ponavljanja)
+    std::vector<uint64_t> requests;
+    std::vector<unsigned char> pageScratch;
+
+    TileStreamer streamer;
+    std::vector<uint64_t> demandedMissing;  // Videle su se pre nego sto su stigle (kasne); sortirano
+
+    static uint64_t PageKey(int level, int x, int y);
+    void BuildLevels();
+    void ResizeFeedback(int width, int height);
+    void ProcessFeedback(const unsigned short* data, int width, int height);
+    void LoadPage(uint64_t key, unsigned char* pixels) const; // Sa radnih niti (cita izvor)
+    void UploadPage(uint64_t key, int slot, const unsigned char* pixels);
+    void UploadReady();
+    int AllocateSlot();
+    void RebuildIndirection();
+
+public:
+    VirtualTexture();
+    ~VirtualTexture();
+
+    // Pravi GPU resurse; najgrublji nivo odmah ide u kes (sinhrono citanje izvora)
+    bool Init(MapSource* mapSource);
+
+    unsigned int CacheTexture() const { return cacheTexture; }
+
+    // Pre iscrtavanja mape: veze indirekciju na INDIRECTION_UNIT i posalje izmenjenu indirekciju
+    void Bind();
+
+    // Posle iscrtavanja frejma (pogled u ViewParams je vec upisan): feedback prolaz u
+    // malom FBO-u, asinhrono citanje preko PBO-a i ucitavanje trazenih stranica u kes
+    void Update(unsigned int program, int viewportWidth, int viewportHeight);
+
+    // U hodanju: zatrazi stranice koje ce pogled (centar, velicina zoom u map space)
+    // pokrivati za PREFETCH_LOOKAHEAD sekundi pri brzini (velocityX, velocityY) u map space/s
+    void Prefetch(float centerX, float centerY, float zoom, float velocityX, float velocityY, int viewportWidth);
+
+    int ResidentPages() const { return (int)resident.size(); }
+};
@@ -1,8 +1,13 @@
 #version 330 core
 
-layout(location = 0) in vec2 aPos;
+layout(location = 0) in vec2 aPos;      // map space [0,1]
+
+layout(std140) uniform ViewParams
+{
+    mat4 uView;     // map space -> NDC
+};
 
 void main()
 {
-    gl_Position = vec4(aPos, 0.0, 1.0);
-}
\ No newline at end of file
+    gl_Position = uView * vec4(aPos, 0.0, 1.0);
+}
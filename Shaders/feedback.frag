@@ -0,0 +1,24 @@
+#version 330 core
+
+in vec2 TexCoord;
+out uvec4 FragPage;     // xy = stranica, z = nivo, w = 1 (0 = piksel bez mape)
+
+layout(std140) uniform VirtualTextureParams
+{
+    vec4 uVirtualSize;
+    vec4 uCacheInfo;
+    vec4 uFeedbackInfo; // x = log2 umanjenja feedback prolaza
+};
+
+void main()
+{
+    // Isti izbor nivoa kao u map.frag; izvodi su ovde uFeedbackInfo.x puta veci
+    vec2 texel = TexCoord * uVirtualSize.xy;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8)) - uFeedbackInfo.x;
+    int level = int(clamp(floor(lod), 0.0, uCacheInfo.w));
+
+    ivec2 page = ivec2(floor(clamp(TexCoord, 0.0, 0.9999) * uVirtualSize.xy / (exp2(float(level)) * uVirtualSize.z)));
+    FragPage = uvec4(uvec2(page), uint(level), 1u);
+}
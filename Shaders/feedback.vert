@@ -0,0 +1,16 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPos;      // Kvadrat mape u map space [0, 1]
+
+layout(std140) uniform ViewParams
+{
+    mat4 uView;     // map space -> NDC
+};
+
+out vec2 TexCoord;
+
+void main()
+{
+    gl_Position = uView * vec4(aPos, 0.0, 1.0);
+    TexCoord = aPos;
+}
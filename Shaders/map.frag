@@ -1,11 +1,37 @@
 #version 330 core
 
 in vec2 TexCoord;
+in float Alpha;
 out vec4 FragColor;
 
-uniform sampler2D uTexture;
+uniform sampler2D uTexture;         // Kes stranica
+uniform usampler2D uIndirection;    // Po mip nivou: xy = slot u kesu, z = nivo stranice u slotu, w = 1 ako postoji
+
+layout(std140) uniform VirtualTextureParams
+{
+    vec4 uVirtualSize;  // xy = velicina mape u tekselima, z = korisni deo stranice, w = ivica
+    vec4 uCacheInfo;    // xy = velicina kesa u tekselima, z = velicina stranice, w = najgrublji nivo
+    vec4 uFeedbackInfo;
+};
 
 void main()
 {
-    FragColor = texture(uTexture, TexCoord);
-}
\ No newline at end of file
+    // Nivo kao kod mipmapa: iz promene teksel koordinata po pikselu
+    vec2 texel = TexCoord * uVirtualSize.xy;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8));
+    int level = int(clamp(floor(lod), 0.0, uCacheInfo.w));
+
+    ivec2 page = ivec2(floor(clamp(TexCoord, 0.0, 0.9999) * uVirtualSize.xy / (exp2(float(level)) * uVirtualSize.z)));
+    uvec4 entry = texelFetch(uIndirection, page, level);
+
+    // Stranica u kesu moze biti grublja od trazene (jos nije stigla)
+    float residentScale = exp2(float(entry.z));
+    vec2 residentTexel = texel / residentScale;
+    vec2 local = residentTexel - floor(residentTexel / uVirtualSize.z) * uVirtualSize.z;
+    vec2 cacheTexel = vec2(entry.xy) * uCacheInfo.z + uVirtualSize.w + local;
+
+    vec4 tex = textureLod(uTexture, cacheTexel / uCacheInfo.xy, 0.0);
+    FragColor = vec4(tex.rgb, tex.a * Alpha);
+}
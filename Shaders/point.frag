@@ -0,0 +1,14 @@
+#version 330 core
+
+out vec4 FragColor;
+
+uniform vec4 uColor;
+
+void main()
+{
+    // Kvadratni point sprite isecen u krug
+    vec2 fromCenter = gl_PointCoord - vec2(0.5);
+    if (dot(fromCenter, fromCenter) > 0.25)
+        discard;
+    FragColor = uColor;
+}
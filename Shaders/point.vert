@@ -0,0 +1,14 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPos;      // map space [0,1]
+
+layout(std140) uniform ViewParams
+{
+    mat4 uView;     // map space -> NDC
+};
+
+void main()
+{
+    gl_Position = uView * vec4(aPos, 0.0, 1.0);
+    gl_PointSize = 10.0; // Precnik tacke u pikselima (ne zavisi od zoom-a)
+}
@@ -1,14 +1,13 @@
 #version 330 core
 
 in vec2 TexCoord;
+in float Alpha;
 out vec4 FragColor;
 
 uniform sampler2D uTexture;
-uniform float uAlpha;   
 
 void main()
 {
-    //FragColor = texture(uTexture, TexCoord);
     vec4 tex = texture(uTexture, TexCoord);
-    FragColor = vec4(tex.rgb, tex.a * uAlpha);
-}
\ No newline at end of file
+    FragColor = vec4(tex.rgb, tex.a * Alpha);
+}
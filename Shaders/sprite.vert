@@ -0,0 +1,27 @@
+#version 330 core
+
+layout(location = 0) in vec2 aPos;       // jedinicni kvadrat [-0.5, 0.5]
+layout(location = 1) in vec2 aTexCoord;
+
+// Po instanci (jedan sprite = jedna instanca)
+layout(location = 2) in vec4 iRect;      // xy = pozicija, zw = skala
+layout(location = 3) in vec2 iParams;    // x = alpha, y = 1.0 ako je pozicija u map space (prolazi kroz pogled)
+
+// Pogled - jedan upis po frejmu za sve programe
+layout(std140) uniform ViewParams
+{
+    mat4 uView;     // map space -> NDC
+};
+
+out vec2 TexCoord;
+out float Alpha;
+
+void main()
+{
+    vec4 position = vec4(aPos * iRect.zw + iRect.xy, 0.0, 1.0);
+
+    // Mapa je u map space, HUD je vec u NDC
+    gl_Position = mix(position, uView * position, iParams.y);
+    TexCoord = aTexCoord;
+    Alpha = iParams.x;
+}
@@ -1,4 +1,9 @@
 #include "../Header/BitmapFont.h"
+#include "../Header/FrameArena.h"
+#include "../Header/GLState.h"
+#include "../Header/Samplers.h"
+#include "../Header/StreamBuffer.h"
+#include <cstring>
 #include <iostream>
 
 // Reference na window dimenzije iz main.cpp
@@ -6,14 +11,13 @@ const unsigned int WINDOW_WIDTH = 1200;
 const unsigned int WINDOW_HEIGHT = 800;
 
 BitmapFont::BitmapFont()
-    : fontTexture(0), shaderProgram(0), VAO(0), VBO(0),
+    : fontTexture(0), shaderProgram(0), VAO(0),
     gridWidth(10), gridHeight(1), firstChar('0'),
-    charWidth(0.0f), charHeight(0.0f) {
+    charWidth(0.0f), charHeight(0.0f), vertices(nullptr), vertexFloats(0) {
 }
 
 BitmapFont::~BitmapFont() {
     if (VAO != 0) glDeleteVertexArrays(1, &VAO);
-    if (VBO != 0) glDeleteBuffers(1, &VBO);
 }
 
 void BitmapFont::Init(unsigned int texture, unsigned int shader, int gridW, int gridH, int firstASCII) {
@@ -27,15 +31,11 @@ void BitmapFont::Init(unsigned int texture, unsigned int shader, int gridW, int
     charWidth = 1.0f / gridWidth;
     charHeight = 1.0f / gridHeight;
 
-    // Kreiraj VAO i VBO za quad rendering
+    // VAO cita vertekse (x, y, u, v) iz StreamBuffer-a; svaki tekst bira svoje preko "first"
     glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
 
     glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-    // Alocira prostor za 6 verteksa (2 trougla) * 4 floata (x, y, u, v)
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.Buffer());
 
     // Position attribute (location 0)
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -70,25 +70,9 @@ void BitmapFont::GetCharUV(char c, float& u1, float& v1, float& u2, float& v2) {
     v2 = v1 - charHeight;
 }
 
-void BitmapFont::RenderText(const std::string& text, float x, float y, float scale, float r, float g, float b) {
-    if (fontTexture == 0 || shaderProgram == 0) {
-        std::cout << "BitmapFont nije inicijalizovan!" << std::endl;
-        return;
-    }
-
-    // Aktiviraj shader i teksturu
-    glUseProgram(shaderProgram);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, fontTexture);
-    glUniform1i(glGetUniformLocation(shaderProgram, "uTexture"), 0);
-
-    // Postavi boju (ako shader ima uColor uniform)
-    unsigned int colorLoc = glGetUniformLocation(shaderProgram, "uColor");
-    if (colorLoc != -1) {
-        glUniform4f(colorLoc, r, g, b, 1.0f);
-    }
-
-    glBindVertexArray(VAO);
+int BitmapFont::BuildVertices(const char* text, float x, float y, float scale) {
+    vertices = frameArena.AllocateArray<float>(strlen(text) * 6 * 4);
+    vertexFloats = 0;
 
     // Veli?ina jednog karaktera na ekranu (u pikselima)
     float charScreenWidth = 32.0f * scale;  // 32px je bazna irina karaktera
@@ -98,7 +82,8 @@ void BitmapFont::RenderText(const std::string& text, float x, float y, float sca
     float currentX = x;
     float currentY = y;
 
-    for (char c : text) {
+    for (; *text != '\0'; text++) {
+        char c = *text;
         // Novi red
         if (c == '\n') {
             currentX = startX;
@@ -122,8 +107,8 @@ void BitmapFont::RenderText(const std::string& text, float x, float y, float sca
         float x2 = ((currentX + charScreenWidth) / WINDOW_WIDTH) * 2.0f - 1.0f;
         float y2 = -(((currentY + charScreenHeight) / WINDOW_HEIGHT) * 2.0f - 1.0f);
 
-        // Kreiraj quad za karakter (2 trougla)
-        float vertices[6][4] = {
+        // Quad za karakter (2 trougla)
+        float quad[6][4] = {
             // Pozicija (x, y)    Texture (u, v)
             { x1, y1,             u1, v1 },  // Top-left
             { x1, y2,             u1, v2 },  // Bottom-left
@@ -133,19 +118,70 @@ void BitmapFont::RenderText(const std::string& text, float x, float y, float sca
             { x2, y2,             u2, v2 },  // Bottom-right
             { x2, y1,             u2, v1 }   // Top-right
         };
-
-        // Auriraj VBO sa vertex podacima
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        // Renderuj karakter
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        memcpy(vertices + vertexFloats, quad, sizeof(quad));
+        vertexFloats += 6 * 4;
 
         // Pomeri kursor za slede?i karakter
         currentX += charScreenWidth;
     }
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    return (int)vertexFloats / 4;
+}
+
+int BitmapFont::WriteVertices() {
+    const size_t stride = 4 * sizeof(float);
+    StreamBuffer::Allocation allocation = streamBuffer.Allocate(vertexFloats * sizeof(float), stride);
+    if (allocation.data == nullptr) return -1;
+    memcpy(allocation.data, vertices, vertexFloats * sizeof(float));
+    return (int)(allocation.offset / stride);
+}
+
+void BitmapFont::RenderText(const std::string& text, float x, float y, float scale, float r, float g, float b) {
+    if (fontTexture == 0 || shaderProgram == 0) {
+        std::cout << "BitmapFont nije inicijalizovan!" << std::endl;
+        return;
+    }
+
+    int vertexCount = BuildVertices(text.c_str(), x, y, scale);
+    if (vertexCount == 0) return;
+
+    // Aktiviraj shader i teksturu
+    glState.UseProgram(shaderProgram);
+    glState.ActiveTexture(0);
+    glState.BindTexture(fontTexture);
+    glState.BindSampler(0, samplers.Get(SamplerUse::Font));
+    glUniform1i(glGetUniformLocation(shaderProgram, "uTexture"), 0);
+
+    // Postavi boju (ako shader ima uColor uniform)
+    unsigned int colorLoc = glGetUniformLocation(shaderProgram, "uColor");
+    if (colorLoc != -1) {
+        glUniform4f(colorLoc, r, g, b, 1.0f);
+    }
+
+    // Svi karakteri odjednom (VAO i tekstura ostaju vezani - glState preskace ponovno vezivanje)
+    int first = WriteVertices();
+    if (first < 0) return;
+    streamBuffer.Flush();
+    glState.BindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, first, vertexCount);
+}
+
+void BitmapFont::RecordText(CommandList& list, const std::string& text, float x, float y, float scale, float r, float g, float b) {
+    RecordText(list, text.c_str(), x, y, scale, r, g, b);
+}
+
+void BitmapFont::RecordText(CommandList& list, const char* text, float x, float y, float scale, float r, float g, float b) {
+    if (fontTexture == 0 || shaderProgram == 0) {
+        std::cout << "BitmapFont nije inicijalizovan!" << std::endl;
+        return;
+    }
+
+    int vertexCount = BuildVertices(text, x, y, scale);
+    if (vertexCount == 0) return;
+
+    int first = WriteVertices();
+    if (first < 0) return;
+    DrawCommand& cmd = list.Draw(RenderLayer::Text, shaderProgram, VAO, fontTexture, GL_TRIANGLES, first, vertexCount);
+    cmd.sampler = samplers.Get(SamplerUse::Font);
+    list.SetColor(cmd, r, g, b, 1.0f);
 }
\ No newline at end of file
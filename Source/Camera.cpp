@@ -0,0 +1,77 @@
+#include "../Header/Camera.h"
+#include <cmath>
+
+// Koliko brzo zoom stize do cilja (veci broj = brze)
+const float ZOOM_SMOOTHING = 12.0f;
+
+Camera::Camera(float centerX, float centerY, float zoom)
+    : targetZoom(zoom), anchorMapX(0.0f), anchorMapY(0.0f), anchorNdcX(0.0f), anchorNdcY(0.0f), anchored(false),
+    centerX(centerX), centerY(centerY), zoom(zoom), minZoom(0.02f), maxZoom(1.0f) {
+}
+
+void Camera::Set(float cx, float cy, float z) {
+    centerX = cx;
+    centerY = cy;
+    zoom = targetZoom = z;
+    anchored = false;
+}
+
+void Camera::ZoomAt(float ndcX, float ndcY, float factor) {
+    // Sidro je tacka mape ispod kursora u trenutku skrolovanja
+    NDCToMap(ndcX, ndcY, anchorMapX, anchorMapY);
+    anchorNdcX = ndcX;
+    anchorNdcY = ndcY;
+    anchored = true;
+
+    targetZoom = fmax(minZoom, fmin(maxZoom, targetZoom * factor));
+}
+
+void Camera::Pan(float dNdcX, float dNdcY) {
+    centerX -= dNdcX * zoom * 0.5f;
+    centerY -= dNdcY * zoom * 0.5f;
+    anchored = false;
+    Clamp();
+}
+
+void Camera::Update(float dt) {
+    if (zoom == targetZoom) return;
+
+    float t = 1.0f - expf(-ZOOM_SMOOTHING * dt);
+    zoom += (targetZoom - zoom) * t;
+    if (fabs(zoom - targetZoom) < targetZoom * 0.001f) zoom = targetZoom;
+
+    if (anchored) {
+        // Zadrzi sidro na istom mestu na ekranu
+        centerX = anchorMapX - anchorNdcX * zoom * 0.5f;
+        centerY = anchorMapY - anchorNdcY * zoom * 0.5f;
+    }
+    Clamp();
+}
+
+void Camera::Clamp() {
+    // Pogled ne izlazi van mape
+    float half = zoom * 0.5f;
+    centerX = fmax(half, fmin(1.0f - half, centerX));
+    centerY = fmax(half, fmin(1.0f - half, centerY));
+}
+
+void Camera::NDCToMap(float ndcX, float ndcY, float& mapX, float& mapY) const {
+    mapX = centerX + ndcX * zoom * 0.5f;
+    mapY = centerY + ndcY * zoom * 0.5f;
+}
+
+void Camera::MapToNDC(float mapX, float mapY, float& ndcX, float& ndcY) const {
+    ndcX = (mapX - centerX) * 2.0f / zoom;
+    ndcY = (mapY - centerY) * 2.0f / zoom;
+}
+
+void Camera::GetViewMatrix(float out[16]) const {
+    float scale = 2.0f / zoom;
+    for (int i = 0; i < 16; i++) out[i] = 0.0f;
+    out[0] = scale;
+    out[5] = scale;
+    out[10] = 1.0f;
+    out[12] = -centerX * scale;
+    out[13] = -centerY * scale;
+    out[15] = 1.0f;
+}
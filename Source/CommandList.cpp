@@ -0,0 +1,222 @@
+#include "../Header/CommandList.h"
+#include "../Header/FrameStats.h"
+#include "../Header/GLState.h"
+#include "../Header/StreamBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+void CommandList::Clear() {
+    uploads.clear();
+    commands.clear();
+    arena.Reset();
+}
+
+void CommandList::Upload(GLenum target, unsigned int buffer, const void* data, size_t size, size_t reserve) {
+    void* space = UploadSpace(target, buffer, size, reserve);
+    if (size > 0) memcpy(space, data, size);
+}
+
+void* CommandList::UploadSpace(GLenum target, unsigned int buffer, size_t size, size_t reserve) {
+    BufferUpload upload;
+    upload.target = target;
+    upload.buffer = buffer;
+    upload.reserve = (GLsizeiptr)std::max(size, reserve);
+    upload.partial = false;
+    upload.offset = 0;
+    upload.data = (unsigned char*)arena.Allocate(size);
+    upload.size = size;
+    uploads.push_back(upload);
+    return upload.data;
+}
+
+void* CommandList::UploadRange(GLenum target, unsigned int buffer, size_t offset, size_t size) {
+    void* space = UploadSpace(target, buffer, size);
+    uploads.back().partial = true;
+    uploads.back().offset = (GLintptr)offset;
+    return space;
+}
+
+DrawCommand& CommandList::Draw(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+    GLenum primitive, int first, int count) {
+    return DrawInstanced(layer, program, vao, texture, primitive, first, count, 0, 0);
+}
+
+DrawCommand& CommandList::DrawIndexed(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+    GLenum primitive, int count, size_t indexOffset) {
+    DrawCommand& cmd = DrawInstanced(layer, program, vao, texture, primitive, 0, count, 0, 0);
+    cmd.indexed = true;
+    cmd.indexOffset = indexOffset;
+    return cmd;
+}
+
+DrawCommand& CommandList::DrawInstanced(RenderLayer layer, unsigned int program, unsigned int vao, unsigned int texture,
+    GLenum primitive, int first, int count, int instanceCount, int baseInstance) {
+    DrawCommand cmd = {};
+    cmd.layer = layer;
+    cmd.program = program;
+    cmd.vao = vao;
+    cmd.texture = texture;
+    cmd.primitive = primitive;
+    cmd.first = first;
+    cmd.count = count;
+    cmd.instanceCount = instanceCount;
+    cmd.baseInstance = baseInstance;
+    commands.push_back(cmd);
+    return commands.back();
+}
+
+DrawCommand& CommandList::MultiDraw(RenderLayer layer, unsigned int program, unsigned int vao, GLenum primitive,
+    const MultiDrawBatch* batch) {
+    DrawCommand& cmd = DrawInstanced(layer, program, vao, 0, primitive, 0, 0, 0, 0);
+    cmd.multiDraw = batch;
+    return cmd;
+}
+
+void CommandList::SetColor(DrawCommand& cmd, float r, float g, float b, float a) {
+    cmd.hasColor = true;
+    cmd.color[0] = r;
+    cmd.color[1] = g;
+    cmd.color[2] = b;
+    cmd.color[3] = a;
+}
+
+void RenderQueue::RegisterUniformBlock(const char* name, unsigned int binding) {
+    blocks.push_back({ name, binding });
+}
+
+void RenderQueue::RegisterSampler(const char* name, unsigned int unit) {
+    samplerUnits.push_back({ name, unit });
+}
+
+void RenderQueue::InvalidatePrograms() {
+    programs.clear();
+}
+
+RenderQueue::ProgramInfo& RenderQueue::PrepareProgram(unsigned int program) {
+    for (ProgramInfo& info : programs)
+        if (info.program == program) return info;
+
+    // Prvi put vidimo ovaj program (novi ili zamenjen hot-reload-om): vezi blokove i sampler
+    for (const BlockBinding& block : blocks) {
+        unsigned int index = glGetUniformBlockIndex(program, block.name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, block.binding);
+    }
+    int samplerLocation = glGetUniformLocation(program, "uTexture");
+    if (samplerLocation != -1)
+        glUniform1i(samplerLocation, 0);
+    for (const BlockBinding& sampler : samplerUnits) {
+        int location = glGetUniformLocation(program, sampler.name);
+        if (location != -1)
+            glUniform1i(location, sampler.binding);
+    }
+
+    ProgramInfo info = {};
+    info.program = program;
+    info.colorLocation = glGetUniformLocation(program, "uColor");
+    programs.push_back(info);
+    return programs.back();
+}
+
+void RenderQueue::Submit(const CommandList& list) {
+    Submit({ &list });
+}
+
+void RenderQueue::Submit(std::initializer_list<const CommandList*> lists) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Uniformi su mogli biti menjani van reda (npr. neposredni RenderText)
+    for (ProgramInfo& program : programs)
+        program.colorSet = false;
+
+    // 1) Upisi u bafere (dinamicki verteksi su vec u StreamBuffer-u)
+    streamBuffer.Flush();
+    for (const CommandList* list : lists) {
+        for (const BufferUpload& upload : list->uploads) {
+            glState.BindBuffer(upload.target, upload.buffer);
+            if (upload.partial) {
+                glBufferSubData(upload.target, upload.offset, upload.size, upload.data);
+                frameStats.bufferUpdates++;
+                continue;
+            }
+            glBufferData(upload.target, upload.reserve, NULL, GL_STREAM_DRAW); // orphan
+            if (upload.size > 0)
+                glBufferSubData(upload.target, 0, upload.size, upload.data);
+            frameStats.bufferUpdates++;
+        }
+    }
+
+    // 2) Sortiranje; redosled snimanja razresava samo jednake kljuceve (isti program i tekstura)
+    sorted.clear();
+    unsigned int sequence = 0;
+    for (const CommandList* list : lists)
+        for (const DrawCommand& cmd : list->commands)
+            sorted.push_back({ &cmd, sequence++ });
+
+    std::sort(sorted.begin(), sorted.end(), [](const SortEntry& a, const SortEntry& b) {
+        if (a.cmd->layer != b.cmd->layer) return a.cmd->layer < b.cmd->layer;
+        if (a.cmd->program != b.cmd->program) return a.cmd->program < b.cmd->program;
+        if (a.cmd->texture != b.cmd->texture) return a.cmd->texture < b.cmd->texture;
+        return a.sequence < b.sequence;
+    });
+
+    // 3) Iscrtavanje; glState preskace vezivanja koja su vec na snazi (i izmedju frejmova)
+    unsigned int currentProgram = 0;
+    ProgramInfo* info = nullptr;
+    glState.ActiveTexture(0);
+
+    for (const SortEntry& entry : sorted) {
+        const DrawCommand& cmd = *entry.cmd;
+
+        glState.UseProgram(cmd.program);
+        if (cmd.program != currentProgram || info == nullptr) {
+            info = &PrepareProgram(cmd.program);
+            currentProgram = cmd.program;
+        }
+        glState.BindVertexArray(cmd.vao);
+        glState.BindTexture(cmd.texture);
+        if (cmd.texture != 0) glState.BindSampler(0, cmd.sampler);
+        if (cmd.hasColor && info->colorLocation != -1 &&
+            (!info->colorSet || memcmp(info->color, cmd.color, sizeof(cmd.color)) != 0)) {
+            glUniform4fv(info->colorLocation, 1, cmd.color);
+            memcpy(info->color, cmd.color, sizeof(cmd.color));
+            info->colorSet = true;
+            frameStats.stateChanges++;
+        }
+
+        if (cmd.multiDraw) {
+            const MultiDrawBatch& batch = *cmd.multiDraw;
+            if (GLEW_ARB_multi_draw_indirect) {
+                glState.BindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.indirectBuffer);
+                glMultiDrawElementsIndirect(cmd.primitive, GL_UNSIGNED_INT, (void*)batch.indirectOffset, batch.drawCount, 0);
+            }
+            else {
+                glMultiDrawElementsBaseVertex(cmd.primitive, batch.counts, GL_UNSIGNED_INT, batch.indexOffsets,
+                    batch.drawCount, batch.baseVertices);
+            }
+        }
+        else if (cmd.instanceCount > 0) {
+            if (GLEW_ARB_base_instance) {
+                glDrawArraysInstancedBaseInstance(cmd.primitive, cmd.first, cmd.count, cmd.instanceCount, cmd.baseInstance);
+            }
+            else {
+                if (cmd.setBaseInstance) {
+                    cmd.setBaseInstance(cmd.owner, cmd.baseInstance);
+                    frameStats.stateChanges++;
+                }
+                glDrawArraysInstanced(cmd.primitive, cmd.first, cmd.count, cmd.instanceCount);
+            }
+        }
+        else if (cmd.indexed) {
+            glDrawElements(cmd.primitive, cmd.count, GL_UNSIGNED_INT, (void*)cmd.indexOffset);
+        }
+        else {
+            glDrawArrays(cmd.primitive, cmd.first, cmd.count);
+        }
+        frameStats.drawCalls++;
+    }
+
+    frameStats.submitCpuMs += std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
@@ -0,0 +1,233 @@
+#include "../Header/FileIO.h"
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0) {
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+#else
+    descriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* path) {
+    Close();
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        Close();
+        return false;
+    }
+    size = (size_t)fileSize.QuadPart;
+    if (size == 0) return true; // Prazan fajl se ne moze mapirati
+
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mappingHandle != NULL)
+        data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != NULL) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+}
+
+AppendFile::AppendFile() : handle(INVALID_HANDLE_VALUE) {}
+
+AppendFile::~AppendFile() {
+    Close();
+}
+
+bool AppendFile::Open(const char* path, bool truncate) {
+    Close();
+    handle = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    // Jedini pisac, pa posle pomeranja na kraj svaki upis dopisuje
+    LARGE_INTEGER zero = {};
+    SetFilePointerEx(handle, zero, NULL, FILE_END);
+    return true;
+}
+
+void AppendFile::Close() {
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+    handle = INVALID_HANDLE_VALUE;
+}
+
+bool AppendFile::IsOpen() const {
+    return handle != INVALID_HANDLE_VALUE;
+}
+
+size_t AppendFile::Size() const {
+    LARGE_INTEGER fileSize;
+    if (handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(handle, &fileSize)) return 0;
+    return (size_t)fileSize.QuadPart;
+}
+
+bool AppendFile::Append(const void* data, size_t size) {
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        DWORD chunk = (DWORD)(size < (1u << 30) ? size : (1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(handle, bytes, chunk, &written, NULL) || written == 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool AppendFile::Sync() {
+    return handle != INVALID_HANDLE_VALUE && FlushFileBuffers(handle) != 0;
+}
+
+bool writeFileAtomic(const char* path, const void* data, size_t size) {
+    std::string temporary = std::string(path) + ".tmp";
+    HANDLE file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    const char* bytes = (const char*)data;
+    bool ok = true;
+    while (ok && size > 0) {
+        DWORD chunk = (DWORD)(size < (1u << 30) ? size : (1u << 30));
+        DWORD written = 0;
+        ok = WriteFile(file, bytes, chunk, &written, NULL) && written == chunk;
+        bytes += written;
+        size -= written;
+    }
+    ok = ok && FlushFileBuffers(file);
+    CloseHandle(file);
+    if (ok) ok = MoveFileExA(temporary.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    if (!ok) DeleteFileA(temporary.c_str());
+    return ok;
+}
+
+#else
+
+bool MappedFile::Open(const char* path) {
+    Close();
+    descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        Close();
+        return false;
+    }
+    size = (size_t)info.st_size;
+    if (size == 0) return true;
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapped == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = (const unsigned char*)mapped;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data != nullptr) munmap((void*)data, size);
+    if (descriptor >= 0) close(descriptor);
+    data = nullptr;
+    size = 0;
+    descriptor = -1;
+}
+
+AppendFile::AppendFile() : descriptor(-1) {}
+
+AppendFile::~AppendFile() {
+    Close();
+}
+
+bool AppendFile::Open(const char* path, bool truncate) {
+    Close();
+    descriptor = open(path, O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+    return descriptor >= 0;
+}
+
+void AppendFile::Close() {
+    if (descriptor >= 0) close(descriptor);
+    descriptor = -1;
+}
+
+bool AppendFile::IsOpen() const {
+    return descriptor >= 0;
+}
+
+size_t AppendFile::Size() const {
+    struct stat info;
+    if (descriptor < 0 || fstat(descriptor, &info) != 0) return 0;
+    return (size_t)info.st_size;
+}
+
+bool AppendFile::Append(const void* data, size_t size) {
+    if (descriptor < 0) return false;
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        ssize_t written = write(descriptor, bytes, size);
+        if (written <= 0) return false;
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+bool AppendFile::Sync() {
+    return descriptor >= 0 && fsync(descriptor) == 0;
+}
+
+bool writeFileAtomic(const char* path, const void* data, size_t size) {
+    std::string temporary = std::string(path) + ".tmp";
+    int file = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) return false;
+
+    const char* bytes = (const char*)data;
+    bool ok = true;
+    while (ok && size > 0) {
+        ssize_t written = write(file, bytes, size);
+        ok = written > 0;
+        if (ok) {
+            bytes += written;
+            size -= (size_t)written;
+        }
+    }
+    ok = ok && fsync(file) == 0;
+    close(file);
+    if (ok) ok = rename(temporary.c_str(), path) == 0;
+    if (!ok) remove(temporary.c_str());
+    return ok;
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "../Header/FrameArena.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+FrameArena frameArena;
+
+// Broji se u zamenjenom globalnom operator new (ostali oblici new/new[] ga pozivaju)
+static thread_local uint64_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+    heapAllocations++;
+    if (size == 0) size = 1;
+    while (true) {
+        void* p = malloc(size);
+        if (p != nullptr) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+
+uint64_t threadHeapAllocations() {
+    return heapAllocations;
+}
+
+FrameArena::FrameArena(size_t initialSize)
+    : current(0), used(0), frameBytes(0), peakBytes(0), blockAllocations(0) {
+    AddBlock(initialSize);
+}
+
+FrameArena::~FrameArena() {
+    for (Block& block : blocks) delete[] block.data;
+}
+
+void FrameArena::AddBlock(size_t size) {
+    // Kroz operator new, pa rast arene vidi i brojac alokacija po frejmu
+    Block block;
+    block.data = new unsigned char[size];
+    block.size = size;
+    blocks.push_back(block);
+    blockAllocations++;
+}
+
+void* FrameArena::AllocateSlow(size_t size, size_t align) {
+    // Sledeci blok je bar duplo veci od prethodnog i staje ceo zahtev
+    AddBlock(std::max(blocks.back().size * 2, size + align));
+    current = blocks.size() - 1;
+    used = 0;
+    return Allocate(size, align);
+}
+
+const char* FrameArena::Format(size_t* length, const char* format, ...) {
+    // Prvo u ostatak trenutnog bloka; ako ne stane, tacna velicina iz vsnprintf
+    size_t available = blocks[current].size - used;
+    char* text = (char*)blocks[current].data + used;
+    va_list args;
+    va_start(args, format);
+    int count = vsnprintf(text, available, format, args);
+    va_end(args);
+    if (count < 0) count = 0;
+
+    if ((size_t)count < available) {
+        Allocate(count + 1, 1);
+    }
+    else {
+        text = (char*)Allocate(count + 1, 1);
+        va_start(args, format);
+        vsnprintf(text, count + 1, format, args);
+        va_end(args);
+    }
+    if (length != nullptr) *length = (size_t)count;
+    return text;
+}
+
+void FrameArena::Reset() {
+    peakBytes = std::max(peakBytes, frameBytes);
+    if (blocks.size() > 1) {
+        // Jedan blok za ceo frejm: sledeci isti frejm staje bez novog bloka
+        size_t total = 0;
+        for (Block& block : blocks) {
+            total += block.size;
+            delete[] block.data;
+        }
+        blocks.clear();
+        AddBlock(total);
+    }
+    current = 0;
+    used = 0;
+    frameBytes = 0;
+}
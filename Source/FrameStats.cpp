@@ -0,0 +1,105 @@
+#include "../Header/FrameStats.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <mutex>
+
+FrameStats frameStats = {};
+std::atomic<bool> profilingEnabled(false);
+
+// Zbir od poslednjeg ispisa
+static FrameStats accumulated = {};
+static unsigned int accumulatedFrames = 0;
+static std::chrono::steady_clock::time_point lastReportTime = std::chrono::steady_clock::now();
+
+// Naslov prozora menja samo GLFW nit
+static std::mutex titleMutex;
+static std::string pendingTitle;
+static bool titleChanged = false;
+
+void beginFrameStats() {
+    frameStats = {};
+}
+
+void endFrameStats() {
+    accumulated.drawCalls += frameStats.drawCalls;
+    accumulated.stateChanges += frameStats.stateChanges;
+    accumulated.glCallsIssued += frameStats.glCallsIssued;
+    accumulated.glCallsSkipped += frameStats.glCallsSkipped;
+    accumulated.bufferUpdates += frameStats.bufferUpdates;
+    accumulated.submitCpuMs += frameStats.submitCpuMs;
+    accumulated.streamBytes += frameStats.streamBytes;
+    accumulated.routesVisible += frameStats.routesVisible;
+    accumulated.routesCulled += frameStats.routesCulled;
+    accumulated.journalRecordMaxUs = std::max(accumulated.journalRecordMaxUs, frameStats.journalRecordMaxUs);
+    accumulated.tilesVisible += frameStats.tilesVisible;
+    accumulated.tilesHit += frameStats.tilesHit;
+    accumulated.tilesLate += frameStats.tilesLate;
+    accumulated.tilesPrefetched += frameStats.tilesPrefetched;
+    accumulated.tilesPrefetchRequested += frameStats.tilesPrefetchRequested;
+    accumulated.tilesInFlight += frameStats.tilesInFlight;
+    accumulated.jobsExecuted += frameStats.jobsExecuted;
+    accumulated.jobsStolen += frameStats.jobsStolen;
+    accumulated.jobsMainThread += frameStats.jobsMainThread;
+    accumulated.jobQueueDepth += frameStats.jobQueueDepth;
+    accumulated.heapAllocations += frameStats.heapAllocations;
+    accumulated.arenaBytes += frameStats.arenaBytes;
+    accumulatedFrames++;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastReportTime).count();
+    if (elapsed < 1.0) return;
+
+    if (profilingEnabled && accumulatedFrames > 0) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        ss << "FPS " << accumulatedFrames / elapsed
+            << " | draw " << accumulated.drawCalls / accumulatedFrames
+            << " | state " << accumulated.stateChanges / accumulatedFrames
+            << " | bind " << accumulated.glCallsIssued / accumulatedFrames
+            << " issued / " << accumulated.glCallsSkipped / accumulatedFrames << " skipped"
+            << " | buf " << accumulated.bufferUpdates / accumulatedFrames
+            << " | stream " << accumulated.streamBytes / accumulatedFrames << " B"
+            << " | routes " << accumulated.routesVisible / accumulatedFrames
+            << " / culled " << accumulated.routesCulled / accumulatedFrames
+            << " | submit " << accumulated.submitCpuMs / accumulatedFrames << " ms"
+            << " | heap " << (double)accumulated.heapAllocations / accumulatedFrames << " alloc"
+            << " | arena " << accumulated.arenaBytes / accumulatedFrames << " B";
+        if (accumulated.journalRecordMaxUs > 0.0)
+            ss << " | journal max " << accumulated.journalRecordMaxUs << " us";
+        if (accumulated.tilesVisible > 0) {
+            // Stranice: zbir za poslednju sekundu, osim pogodaka (%) i broja u obradi (prosek)
+            ss << std::setprecision(1)
+                << " | tiles hit " << 100.0 * accumulated.tilesHit / accumulated.tilesVisible << "%"
+                << " late " << accumulated.tilesLate
+                << " prefetched " << accumulated.tilesPrefetched << "/" << accumulated.tilesPrefetchRequested
+                << " in flight " << (double)accumulated.tilesInFlight / accumulatedFrames;
+        }
+        if (accumulated.jobsExecuted + accumulated.jobsMainThread > 0) {
+            // Poslovi: zbir za poslednju sekundu; red je prosek stanja na kraju frejma
+            ss << std::setprecision(1)
+                << " | jobs " << accumulated.jobsExecuted
+                << " stolen " << (accumulated.jobsExecuted > 0 ? 100.0 * accumulated.jobsStolen / accumulated.jobsExecuted : 0.0) << "%"
+                << " main " << accumulated.jobsMainThread
+                << " queue " << (double)accumulated.jobQueueDepth / accumulatedFrames;
+        }
+        std::cout << ss.str() << std::endl;
+        std::lock_guard<std::mutex> lock(titleMutex);
+        pendingTitle = ss.str();
+        titleChanged = true;
+    }
+
+    accumulated = {};
+    accumulatedFrames = 0;
+    lastReportTime = now;
+}
+
+bool takeFrameStatsTitle(std::string& title) {
+    std::lock_guard<std::mutex> lock(titleMutex);
+    if (!titleChanged) return false;
+    title.swap(pendingTitle);
+    titleChanged = false;
+    return true;
+}
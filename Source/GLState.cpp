@@ -0,0 +1,97 @@
+#include "../Header/GLState.h"
+#include "../Header/FrameStats.h"
+
+GLState glState;
+
+GLState::GLState() {
+    Invalidate();
+}
+
+void GLState::Invalidate() {
+    program = UNKNOWN;
+    vao = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (int i = 0; i < MAX_TEXTURE_UNITS; i++) textures[i] = samplers[i] = UNKNOWN;
+    arrayBuffer = UNKNOWN;
+    uniformBuffer = UNKNOWN;
+    blend = -1;
+    blendSrc = blendDst = UNKNOWN;
+}
+
+bool GLState::Changed(unsigned int& current, unsigned int value) {
+    if (current == value) {
+        frameStats.glCallsSkipped++;
+        return false;
+    }
+    current = value;
+    frameStats.glCallsIssued++;
+    return true;
+}
+
+void GLState::UseProgram(unsigned int p) {
+    if (Changed(program, p)) glUseProgram(p);
+}
+
+void GLState::BindVertexArray(unsigned int v) {
+    if (Changed(vao, v)) glBindVertexArray(v);
+}
+
+void GLState::ActiveTexture(unsigned int unit) {
+    if (Changed(activeUnit, unit)) glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture(unsigned int texture) {
+    if (activeUnit >= MAX_TEXTURE_UNITS) {
+        // Aktivna jedinica nije poznata - ne mozemo znati sta je vezano
+        glBindTexture(GL_TEXTURE_2D, texture);
+        frameStats.glCallsIssued++;
+        return;
+    }
+    if (Changed(textures[activeUnit], texture)) glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLState::BindSampler(unsigned int unit, unsigned int sampler) {
+    if (unit >= MAX_TEXTURE_UNITS) {
+        glBindSampler(unit, sampler);
+        frameStats.glCallsIssued++;
+        return;
+    }
+    if (Changed(samplers[unit], sampler)) glBindSampler(unit, sampler);
+}
+
+void GLState::BindBuffer(GLenum target, unsigned int buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (Changed(arrayBuffer, buffer)) glBindBuffer(target, buffer);
+    }
+    else if (target == GL_UNIFORM_BUFFER) {
+        if (Changed(uniformBuffer, buffer)) glBindBuffer(target, buffer);
+    }
+    else {
+        // Ostale mete (npr. GL_ELEMENT_ARRAY_BUFFER je deo VAO stanja) se ne kesiraju
+        glBindBuffer(target, buffer);
+        frameStats.glCallsIssued++;
+    }
+}
+
+void GLState::SetBlend(bool enabled) {
+    int value = enabled ? 1 : 0;
+    if (blend == value) {
+        frameStats.glCallsSkipped++;
+        return;
+    }
+    blend = value;
+    frameStats.glCallsIssued++;
+    if (enabled) glEnable(GL_BLEND);
+    else glDisable(GL_BLEND);
+}
+
+void GLState::BlendFunc(GLenum src, GLenum dst) {
+    if (blendSrc == src && blendDst == dst) {
+        frameStats.glCallsSkipped++;
+        return;
+    }
+    blendSrc = src;
+    blendDst = dst;
+    frameStats.glCallsIssued++;
+    glBlendFunc(src, dst);
+}
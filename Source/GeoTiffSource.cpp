@@ -0,0 +1,399 @@
+#include "../Header/GeoTiffSource.h"
+#include "../Header/ImageDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+static const double PI = 3.14159265358979323846;
+static const double WEB_MERCATOR_RADIUS = 6378137.0;
+
+enum TiffTag {
+    TAG_SUBFILE_TYPE = 254,
+    TAG_WIDTH = 256,
+    TAG_HEIGHT = 257,
+    TAG_BITS_PER_SAMPLE = 258,
+    TAG_COMPRESSION = 259,
+    TAG_PHOTOMETRIC = 262,
+    TAG_SAMPLES_PER_PIXEL = 277,
+    TAG_PLANAR_CONFIG = 284,
+    TAG_PREDICTOR = 317,
+    TAG_COLOR_MAP = 320,
+    TAG_TILE_WIDTH = 322,
+    TAG_TILE_HEIGHT = 323,
+    TAG_TILE_OFFSETS = 324,
+    TAG_TILE_BYTE_COUNTS = 325,
+    TAG_MODEL_PIXEL_SCALE = 33550,
+    TAG_MODEL_TIEPOINT = 33922,
+    TAG_GEO_KEY_DIRECTORY = 34735
+};
+
+enum TiffCompression { COMPRESSION_NONE = 1, COMPRESSION_LZW = 5, COMPRESSION_DEFLATE = 8, COMPRESSION_DEFLATE_OLD = 32946 };
+enum TiffPhotometric { PHOTOMETRIC_MIN_IS_BLACK = 1, PHOTOMETRIC_RGB = 2, PHOTOMETRIC_PALETTE = 3 };
+
+// Citanje zaglavlja i IFD-ova; svaka vrednost se proverava da je unutar fajla
+struct TiffReader {
+    const unsigned char* data;
+    size_t size;
+    bool bigEndian;
+    bool bigTiff;
+
+    struct Entry {
+        uint16_t type;
+        uint64_t count;
+        uint64_t valueOffset; // Gde su vrednosti (u samom unosu ako staju)
+    };
+
+    uint64_t Get(uint64_t offset, int bytes) const {
+        if (offset + bytes > size) return 0;
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            int shift = bigEndian ? (bytes - 1 - i) * 8 : i * 8;
+            value |= (uint64_t)data[offset + i] << shift;
+        }
+        return value;
+    }
+
+    static int TypeSize(uint16_t type) {
+        switch (type) {
+        case 1: case 2: case 6: case 7: return 1;
+        case 3: case 8: return 2;
+        case 4: case 9: case 11: return 4;
+        case 5: case 10: case 12: case 16: case 17: case 18: return 8;
+        default: return 0;
+        }
+    }
+
+    bool ReadIfd(uint64_t offset, std::map<uint16_t, Entry>& entries, uint64_t& next) const {
+        entries.clear();
+        int countBytes = bigTiff ? 8 : 2, entryBytes = bigTiff ? 20 : 12, inlineBytes = bigTiff ? 8 : 4;
+        if (offset == 0 || offset + countBytes > size) return false;
+        uint64_t count = Get(offset, countBytes);
+        uint64_t position = offset + countBytes;
+        if (position + count * entryBytes + inlineBytes > size) return false;
+
+        for (uint64_t i = 0; i < count; i++, position += entryBytes) {
+            Entry entry;
+            uint16_t tag = (uint16_t)Get(position, 2);
+            entry.type = (uint16_t)Get(position + 2, 2);
+            entry.count = Get(position + 4, bigTiff ? 8 : 4);
+            uint64_t valuePosition = position + (bigTiff ? 12 : 8);
+            uint64_t bytes = entry.count * TypeSize(entry.type);
+            entry.valueOffset = bytes <= (uint64_t)inlineBytes ? valuePosition : Get(valuePosition, inlineBytes);
+            if (TypeSize(entry.type) == 0 || entry.valueOffset + bytes > size) continue;
+            entries[tag] = entry;
+        }
+        next = Get(position, inlineBytes);
+        return true;
+    }
+
+    // Celobrojne vrednosti unosa (SHORT/LONG/LONG8...)
+    std::vector<uint64_t> Values(const Entry& entry) const {
+        std::vector<uint64_t> values((size_t)entry.count);
+        int bytes = TypeSize(entry.type);
+        for (uint64_t i = 0; i < entry.count; i++) values[(size_t)i] = Get(entry.valueOffset + i * bytes, bytes);
+        return values;
+    }
+
+    std::vector<double> Doubles(const Entry& entry) const {
+        std::vector<double> values((size_t)entry.count);
+        for (uint64_t i = 0; i < entry.count; i++) {
+            uint64_t bits = Get(entry.valueOffset + i * 8, 8);
+            memcpy(&values[(size_t)i], &bits, 8);
+        }
+        return values;
+    }
+};
+
+static uint64_t firstValue(const TiffReader& reader, const std::map<uint16_t, TiffReader::Entry>& entries,
+    uint16_t tag, uint64_t fallback) {
+    auto found = entries.find(tag);
+    if (found == entries.end() || found->second.count == 0) return fallback;
+    return reader.Values(found->second)[0];
+}
+
+// TIFF LZW: kodovi od najviseg bita, 256 = brisanje recnika, 257 = kraj, sirina koda
+// raste jedan kod ranije nego u GIF-u
+static bool decodeLzw(const unsigned char* src, size_t size, unsigned char* dst, size_t dstSize) {
+    const int CLEAR = 256, END = 257;
+    std::vector<uint16_t> prefix(4096);
+    std::vector<unsigned char> suffix(4096), first(4096);
+    std::vector<unsigned char> stack(4096);
+    for (int i = 0; i < 256; i++) {
+        suffix[i] = (unsigned char)i;
+        first[i] = (unsigned char)i;
+    }
+
+    size_t out = 0, bitPosition = 0, totalBits = size * 8;
+    int next = 258, width = 9, previous = -1;
+    while (out < dstSize && bitPosition + width <= totalBits) {
+        int code = 0;
+        for (int i = 0; i < width; i++, bitPosition++)
+            code = (code << 1) | ((src[bitPosition >> 3] >> (7 - (bitPosition & 7))) & 1);
+
+        if (code == CLEAR) {
+            next = 258;
+            width = 9;
+            previous = -1;
+            continue;
+        }
+        if (code == END) break;
+        if (code > next || (previous < 0 && code >= 256)) return false;
+
+        // Niz za kod se slaze unazad na stek
+        int depth = 0, current = code;
+        if (code == next) {
+            stack[depth++] = first[previous];
+            current = previous;
+        }
+        while (current >= 258) {
+            stack[depth++] = suffix[current];
+            current = prefix[current];
+        }
+        stack[depth++] = (unsigned char)current;
+
+        if (previous >= 0 && next < 4096) {
+            prefix[next] = (uint16_t)previous;
+            suffix[next] = (unsigned char)current;
+            first[next] = first[previous];
+            next++;
+        }
+        if (next + 1 >= (1 << width) && width < 12) width++;
+
+        while (depth > 0 && out < dstSize) dst[out++] = stack[--depth];
+        previous = code;
+    }
+    return out == dstSize;
+}
+
+GeoTiffSource::GeoTiffSource() : hasGeoBounds(false), south(0), west(0), north(0), east(0) {}
+
+bool GeoTiffSource::Open(const char* path) {
+    if (!file.Open(path)) {
+        std::cout << "GeoTIFF: ne mogu da otvorim " << path << std::endl;
+        return false;
+    }
+
+    TiffReader reader = { file.Data(), file.Size(), false, false };
+    if (reader.size < 16 || !(memcmp(reader.data, "II", 2) == 0 || memcmp(reader.data, "MM", 2) == 0)) {
+        std::cout << "GeoTIFF: " << path << " nije TIFF" << std::endl;
+        return false;
+    }
+    reader.bigEndian = reader.data[0] == 'M';
+    uint64_t version = reader.Get(2, 2);
+    reader.bigTiff = version == 43;
+    if (version != 42 && version != 43) return false;
+    uint64_t ifdOffset = reader.bigTiff ? reader.Get(8, 8) : reader.Get(4, 4);
+
+    std::map<uint16_t, TiffReader::Entry> entries;
+    std::vector<Image> images;
+    int tileWidth = 0;
+    for (int index = 0; index < 64 && ifdOffset != 0; index++) {
+        uint64_t next = 0;
+        if (!reader.ReadIfd(ifdOffset, entries, next)) break;
+        ifdOffset = next;
+
+        // Prvi IFD je slika, kasniji sa bitom "umanjena rezolucija" su pregledi (maske se preskacu)
+        uint64_t subfileType = firstValue(reader, entries, TAG_SUBFILE_TYPE, 0);
+        if (index > 0 && subfileType != 1) continue;
+
+        Image image;
+        image.width = (int)firstValue(reader, entries, TAG_WIDTH, 0);
+        image.height = (int)firstValue(reader, entries, TAG_HEIGHT, 0);
+        image.samples = (int)firstValue(reader, entries, TAG_SAMPLES_PER_PIXEL, 1);
+        image.photometric = (int)firstValue(reader, entries, TAG_PHOTOMETRIC, PHOTOMETRIC_MIN_IS_BLACK);
+        image.compression = (int)firstValue(reader, entries, TAG_COMPRESSION, COMPRESSION_NONE);
+        image.predictor = (int)firstValue(reader, entries, TAG_PREDICTOR, 1);
+        int bits = (int)firstValue(reader, entries, TAG_BITS_PER_SAMPLE, 1);
+        int planar = (int)firstValue(reader, entries, TAG_PLANAR_CONFIG, 1);
+        int tileW = (int)firstValue(reader, entries, TAG_TILE_WIDTH, 0);
+        int tileH = (int)firstValue(reader, entries, TAG_TILE_HEIGHT, 0);
+
+        const char* problem = nullptr;
+        if (tileW == 0 || tileH == 0 || !entries.count(TAG_TILE_OFFSETS) || !entries.count(TAG_TILE_BYTE_COUNTS))
+            problem = "nije podeljen na plocice (gdal_translate -co TILED=YES)";
+        else if (tileW != tileH || (index > 0 && tileW != tileWidth)) problem = "plocice razlicitih velicina";
+        else if (bits != 8 || planar != 1) problem = "podrzano je samo 8 bita po kanalu, kanali zajedno";
+        else if (image.samples < 1 || image.samples > 4) problem = "nepodrzan broj kanala";
+        else if (image.compression != COMPRESSION_NONE && image.compression != COMPRESSION_LZW
+            && image.compression != COMPRESSION_DEFLATE && image.compression != COMPRESSION_DEFLATE_OLD)
+            problem = "nepodrzana kompresija (samo bez, LZW i deflate)";
+        else if (image.photometric != PHOTOMETRIC_MIN_IS_BLACK && image.photometric != PHOTOMETRIC_RGB
+            && image.photometric != PHOTOMETRIC_PALETTE)
+            problem = "nepodrzana fotometrija";
+        else if (image.predictor != 1 && image.predictor != 2) problem = "nepodrzan prediktor";
+        if (problem) {
+            if (index == 0) {
+                std::cout << "GeoTIFF " << path << ": " << problem << std::endl;
+                return false;
+            }
+            continue; // Pregled koji ne moze da se koristi pravi se usrednjavanjem
+        }
+
+        image.tilesAcross = (image.width + tileW - 1) / tileW;
+        image.tilesDown = (image.height + tileH - 1) / tileH;
+        image.tileOffsets = reader.Values(entries[TAG_TILE_OFFSETS]);
+        image.tileBytes = reader.Values(entries[TAG_TILE_BYTE_COUNTS]);
+        size_t tileCount = (size_t)image.tilesAcross * image.tilesDown;
+        if (image.tileOffsets.size() < tileCount || image.tileBytes.size() < tileCount) {
+            if (index == 0) {
+                std::cout << "GeoTIFF " << path << ": nepotpune tabele plocica (TileOffsets/TileByteCounts)" << std::endl;
+                return false;
+            }
+            continue;
+        }
+
+        if (index == 0) {
+            tileWidth = tileW;
+            if (image.photometric == PHOTOMETRIC_PALETTE) {
+                auto colorMap = entries.find(TAG_COLOR_MAP);
+                if (colorMap == entries.end() || colorMap->second.count < 768) {
+                    std::cout << "GeoTIFF " << path << ": paleta bez ColorMap" << std::endl;
+                    return false;
+                }
+                std::vector<uint64_t> colors = reader.Values(colorMap->second);
+                palette.resize(768);
+                for (int i = 0; i < 256; i++)
+                    for (int c = 0; c < 3; c++) palette[i * 3 + c] = (unsigned char)(colors[c * 256 + i] >> 8);
+            }
+
+            // Georeferenca: tacka veze (piksel -> model) i velicina piksela
+            auto scale = entries.find(TAG_MODEL_PIXEL_SCALE);
+            auto tiepoint = entries.find(TAG_MODEL_TIEPOINT);
+            auto keys = entries.find(TAG_GEO_KEY_DIRECTORY);
+            if (scale != entries.end() && tiepoint != entries.end() && keys != entries.end()
+                && scale->second.type == 12 && tiepoint->second.type == 12
+                && scale->second.count >= 2 && tiepoint->second.count >= 6) {
+                std::vector<double> s = reader.Doubles(scale->second);
+                std::vector<double> t = reader.Doubles(tiepoint->second);
+                std::vector<uint64_t> k = reader.Values(keys->second);
+                int modelType = 0, projected = 0;
+                for (size_t i = 4; i + 3 < k.size(); i += 4) {
+                    if (k[i + 1] != 0) continue; // Vrednost nije u samom direktorijumu
+                    if (k[i] == 1024) modelType = (int)k[i + 3];
+                    if (k[i] == 3072) projected = (int)k[i + 3];
+                }
+                double left = t[3] - t[0] * s[0], top = t[4] + t[1] * s[1];
+                double right = left + image.width * s[0], bottom = top - image.height * s[1];
+                if (modelType == 2) { // Geografske koordinate (stepeni)
+                    west = left; east = right; north = top; south = bottom;
+                    hasGeoBounds = true;
+                }
+                else if (modelType == 1 && (projected == 3857 || projected == 3785 || projected == 900913)) {
+                    auto toLatitude = [](double y) { return atan(sinh(y / WEB_MERCATOR_RADIUS)) * 180.0 / PI; };
+                    west = left / WEB_MERCATOR_RADIUS * 180.0 / PI;
+                    east = right / WEB_MERCATOR_RADIUS * 180.0 / PI;
+                    north = toLatitude(top);
+                    south = toLatitude(bottom);
+                    hasGeoBounds = true;
+                }
+            }
+        }
+        images.push_back(std::move(image));
+    }
+    if (images.empty()) return false;
+
+    tileSize = tileWidth;
+    width = images[0].width;
+    height = images[0].height;
+
+    // Pregled ide na nivo cija velicina mu odgovara (gdal zaokruzuje navise, ovde se deli nanize)
+    levels.assign(1, images[0]);
+    for (int level = 1; LevelWidth(level - 1) > 1 || LevelHeight(level - 1) > 1; level++) {
+        levels.push_back(Image());
+        levels.back().width = 0;
+        for (const Image& overview : images) {
+            if (std::abs(overview.width - LevelWidth(level)) <= 1 && std::abs(overview.height - LevelHeight(level)) <= 1) {
+                levels.back() = overview;
+                break;
+            }
+        }
+    }
+
+    int overviews = 0;
+    for (size_t level = 1; level < levels.size(); level++) overviews += levels[level].width > 0;
+    std::cout << "GeoTIFF " << path << ": " << width << "x" << height << ", plocice " << tileSize
+        << ", pregleda " << overviews << (hasGeoBounds ? ", georeferenciran" : "") << std::endl;
+    if (overviews == 0 && levels.size() > 4)
+        std::cout << "GeoTIFF: nema pregleda, grubi nivoi citaju celu sliku (dodati ih sa gdaladdo)" << std::endl;
+    return true;
+}
+
+bool GeoTiffSource::HasLevel(int level) const {
+    return level < (int)levels.size() && levels[level].width > 0;
+}
+
+void GeoTiffSource::TileOrigin(int level, int& originX, int& originY) const {
+    // Redovi TIFF-a idu odozgo: mreza pocinje od dna poslednjeg reda plocica (sa dopunom)
+    const Image& image = levels[level];
+    originX = 0;
+    originY = image.tilesDown * tileSize - image.height;
+}
+
+bool GeoTiffSource::LoadTile(int level, int tileX, int tileY, unsigned char* rgba) {
+    const Image& image = levels[level];
+    int tiffRow = image.tilesDown - 1 - tileY;
+    if (tileX < 0 || tileX >= image.tilesAcross || tiffRow < 0) return false;
+    size_t index = (size_t)tiffRow * image.tilesAcross + tileX;
+    uint64_t offset = image.tileOffsets[index], bytes = image.tileBytes[index];
+    if (bytes == 0 || offset + bytes > file.Size()) return false; // Retka plocica
+
+    size_t rowBytes = (size_t)tileSize * image.samples;
+    std::vector<unsigned char> raw(rowBytes * tileSize);
+    const unsigned char* src = file.Data() + offset;
+    size_t written = 0;
+    bool ok;
+    switch (image.compression) {
+    case COMPRESSION_NONE:
+        ok = bytes >= raw.size();
+        if (ok) memcpy(raw.data(), src, raw.size());
+        break;
+    case COMPRESSION_LZW:
+        ok = decodeLzw(src, (size_t)bytes, raw.data(), raw.size());
+        break;
+    default:
+        ok = inflateZlib(src, (size_t)bytes, raw.data(), raw.size(), &written) && written == raw.size();
+        break;
+    }
+    if (!ok) return false;
+
+    if (image.predictor == 2) {
+        for (int row = 0; row < tileSize; row++) {
+            unsigned char* p = raw.data() + row * rowBytes;
+            for (size_t i = image.samples; i < rowBytes; i++) p[i] = (unsigned char)(p[i] + p[i - image.samples]);
+        }
+    }
+
+    // U RGBA, redovi obrnuto (red 0 plocice je donji)
+    for (int row = 0; row < tileSize; row++) {
+        const unsigned char* s = raw.data() + row * rowBytes;
+        unsigned char* d = rgba + (size_t)(tileSize - 1 - row) * tileSize * 4;
+        for (int x = 0; x < tileSize; x++, s += image.samples, d += 4) {
+            if (image.photometric == PHOTOMETRIC_PALETTE) {
+                memcpy(d, &palette[s[0] * 3], 3);
+                d[3] = 255;
+            }
+            else if (image.samples <= 2) {
+                d[0] = d[1] = d[2] = s[0];
+                d[3] = image.samples == 2 ? s[1] : 255;
+            }
+            else {
+                d[0] = s[0];
+                d[1] = s[1];
+                d[2] = s[2];
+                d[3] = image.samples == 4 ? s[3] : 255;
+            }
+        }
+    }
+    return true;
+}
+
+bool GeoTiffSource::GeoBounds(double& outSouth, double& outWest, double& outNorth, double& outEast) const {
+    if (!hasGeoBounds) return false;
+    outSouth = south;
+    outWest = west;
+    outNorth = north;
+    outEast = east;
+    return true;
+}
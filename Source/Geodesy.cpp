@@ -0,0 +1,199 @@
+#include "../Header/Geodesy.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static const double PI = 3.14159265358979323846;
+static const double DEG_TO_RAD = PI / 180.0;
+static const double RAD_TO_DEG = 180.0 / PI;
+
+// WGS84
+static const double WGS84_A = 6378137.0;
+static const double WGS84_F = 1.0 / 298.257223563;
+static const double WGS84_B = WGS84_A * (1.0 - WGS84_F);
+
+const double DistanceEngine::EARTH_RADIUS = 6371008.8;
+
+static double latToMercator(double lat) {
+    return log(tan(PI / 4.0 + lat * DEG_TO_RAD / 2.0));
+}
+
+static double mercatorToLat(double y) {
+    return (2.0 * atan(exp(y)) - PI / 2.0) * RAD_TO_DEG;
+}
+
+GeoReference::GeoReference()
+    : west(0.0), east(0.0), mercSouth(0.0), mercNorth(0.0), valid(false) {
+}
+
+void GeoReference::SetBounds(double south, double westLon, double north, double eastLon) {
+    west = westLon;
+    east = eastLon;
+    mercSouth = latToMercator(south);
+    mercNorth = latToMercator(north);
+    valid = east != west && mercNorth != mercSouth;
+}
+
+void GeoReference::SetCenter(double lat, double lon, double widthMeters, double aspect) {
+    // Mercator razmera na sirini lat je 1 / cos(lat); na ovoj velicini je konstantna
+    double scale = 1.0 / (DistanceEngine::EARTH_RADIUS * cos(lat * DEG_TO_RAD));
+    double halfWidth = widthMeters * 0.5 * scale;               // Radijani duzine = Mercator x
+    double halfHeight = widthMeters / aspect * 0.5 * scale;     // Mercator y
+    double centerY = latToMercator(lat);
+
+    west = lon - halfWidth * RAD_TO_DEG;
+    east = lon + halfWidth * RAD_TO_DEG;
+    mercSouth = centerY - halfHeight;
+    mercNorth = centerY + halfHeight;
+    valid = widthMeters > 0.0 && aspect > 0.0;
+}
+
+bool GeoReference::Calibrate(Point mapA, GeoPoint geoA, Point mapB, GeoPoint geoB) {
+    double dx = (double)mapB.x - mapA.x;
+    double dy = (double)mapB.y - mapA.y;
+    if (fabs(dx) < 1e-6 || fabs(dy) < 1e-6) return false; // Tacke moraju biti razmaknute po obe ose
+
+    double lonPerUnit = (geoB.lon - geoA.lon) / dx;
+    double mercA = latToMercator(geoA.lat), mercB = latToMercator(geoB.lat);
+    double mercPerUnit = (mercB - mercA) / dy;
+
+    west = geoA.lon - mapA.x * lonPerUnit;
+    east = west + lonPerUnit;
+    mercSouth = mercA - mapA.y * mercPerUnit;
+    mercNorth = mercSouth + mercPerUnit;
+    valid = true;
+    return true;
+}
+
+bool GeoReference::LoadControlPoints(const char* path) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    Point map[2];
+    GeoPoint geo[2];
+    int count = 0;
+    std::string line;
+    while (count < 2 && std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        if (!(fields >> map[count].x >> map[count].y >> geo[count].lat >> geo[count].lon)) return false;
+        count++;
+    }
+    return count == 2 && Calibrate(map[0], geo[0], map[1], geo[1]);
+}
+
+GeoPoint GeoReference::ToGeo(float x, float y) const {
+    GeoPoint geo;
+    geo.lon = west + (east - west) * x;
+    geo.lat = mercatorToLat(mercSouth + (mercNorth - mercSouth) * y);
+    return geo;
+}
+
+Point GeoReference::ToMap(GeoPoint geo) const {
+    if (!valid) return Point(0.0f, 0.0f);
+    return Point((float)((geo.lon - west) / (east - west)),
+        (float)((latToMercator(geo.lat) - mercSouth) / (mercNorth - mercSouth)));
+}
+
+void GeoReference::ToGeo(const float* xs, const float* ys, size_t count, double* lat, double* lon) const {
+    double lonScale = east - west;
+    double mercScale = mercNorth - mercSouth;
+    for (size_t i = 0; i < count; i++) {
+        lon[i] = west + lonScale * xs[i];
+        lat[i] = mercatorToLat(mercSouth + mercScale * ys[i]);
+    }
+}
+
+DistanceEngine::DistanceEngine() : method(DistanceMethod::Vincenty) {
+}
+
+double DistanceEngine::Haversine(GeoPoint a, GeoPoint b) {
+    double dLat = (b.lat - a.lat) * DEG_TO_RAD;
+    double dLon = (b.lon - a.lon) * DEG_TO_RAD;
+    double sinLat = sin(dLat * 0.5), sinLon = sin(dLon * 0.5);
+    double h = sinLat * sinLat + cos(a.lat * DEG_TO_RAD) * cos(b.lat * DEG_TO_RAD) * sinLon * sinLon;
+    return 2.0 * EARTH_RADIUS * asin(fmin(1.0, sqrt(h)));
+}
+
+double DistanceEngine::Vincenty(GeoPoint a, GeoPoint b) {
+    double L = (b.lon - a.lon) * DEG_TO_RAD;
+    double U1 = atan((1.0 - WGS84_F) * tan(a.lat * DEG_TO_RAD));
+    double U2 = atan((1.0 - WGS84_F) * tan(b.lat * DEG_TO_RAD));
+    double sinU1 = sin(U1), cosU1 = cos(U1);
+    double sinU2 = sin(U2), cosU2 = cos(U2);
+
+    double lambda = L;
+    double sinSigma = 0, cosSigma = 0, sigma = 0, cosSqAlpha = 0, cos2SigmaM = 0;
+    for (int iteration = 0; iteration < 100; iteration++) {
+        double sinLambda = sin(lambda), cosLambda = cos(lambda);
+        double t1 = cosU2 * sinLambda;
+        double t2 = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+        sinSigma = sqrt(t1 * t1 + t2 * t2);
+        if (sinSigma == 0.0) return 0.0; // Iste tacke
+
+        cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+        sigma = atan2(sinSigma, cosSigma);
+        double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+        cosSqAlpha = 1.0 - sinAlpha * sinAlpha;
+        cos2SigmaM = cosSqAlpha != 0.0 ? cosSigma - 2.0 * sinU1 * sinU2 / cosSqAlpha : 0.0; // Ekvator
+
+        double C = WGS84_F / 16.0 * cosSqAlpha * (4.0 + WGS84_F * (4.0 - 3.0 * cosSqAlpha));
+        double previous = lambda;
+        lambda = L + (1.0 - C) * WGS84_F * sinAlpha *
+            (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+
+        if (fabs(lambda - previous) < 1e-12) {
+            double uSq = cosSqAlpha * (WGS84_A * WGS84_A - WGS84_B * WGS84_B) / (WGS84_B * WGS84_B);
+            double A = 1.0 + uSq / 16384.0 * (4096.0 + uSq * (-768.0 + uSq * (320.0 - 175.0 * uSq)));
+            double B = uSq / 1024.0 * (256.0 + uSq * (-128.0 + uSq * (74.0 - 47.0 * uSq)));
+            double deltaSigma = B * sinSigma * (cos2SigmaM + B / 4.0 * (cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)
+                - B / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) * (-3.0 + 4.0 * cos2SigmaM * cos2SigmaM)));
+            return WGS84_B * A * (sigma - deltaSigma);
+        }
+    }
+    return Haversine(a, b);
+}
+
+double DistanceEngine::Distance(GeoPoint a, GeoPoint b) const {
+    return method == DistanceMethod::Vincenty ? Vincenty(a, b) : Haversine(a, b);
+}
+
+double DistanceEngine::Distance(Point a, Point b) const {
+    return Distance(reference.ToGeo(a.x, a.y), reference.ToGeo(b.x, b.y));
+}
+
+double DistanceEngine::SegmentLengths(const float* xs, const float* ys, size_t count, float* lengths) {
+    if (count < 2) return 0.0;
+
+    lat.resize(count);
+    lon.resize(count);
+    reference.ToGeo(xs, ys, count, lat.data(), lon.data());
+
+    double total = 0.0;
+    if (method == DistanceMethod::Haversine) {
+        // cos(lat) jednom po tacki, pa svaki segment koristi dva susedna
+        cosLat.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            lat[i] *= DEG_TO_RAD;
+            lon[i] *= DEG_TO_RAD;
+            cosLat[i] = cos(lat[i]);
+        }
+        for (size_t i = 0; i + 1 < count; i++) {
+            double sinLat = sin((lat[i + 1] - lat[i]) * 0.5);
+            double sinLon = sin((lon[i + 1] - lon[i]) * 0.5);
+            double h = sinLat * sinLat + cosLat[i] * cosLat[i + 1] * sinLon * sinLon;
+            double length = 2.0 * EARTH_RADIUS * asin(fmin(1.0, sqrt(h)));
+            lengths[i] = (float)length;
+            total += length;
+        }
+    }
+    else {
+        for (size_t i = 0; i + 1 < count; i++) {
+            double length = Vincenty({ lat[i], lon[i] }, { lat[i + 1], lon[i + 1] });
+            lengths[i] = (float)length;
+            total += length;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,396 @@
+#include "../Header/GeometryKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GEOMETRY_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang prevode AVX2 funkcije samo uz atribut (ostatak programa ostaje bez AVX-a)
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+GeometryKernels geometryKernels;
+
+// ---------------- Skalarno ----------------
+
+static void distancesToPointScalar(const float* xs, const float* ys, size_t count, float px, float py, float* out) {
+    for (size_t i = 0; i < count; i++) {
+        float dx = xs[i] - px, dy = ys[i] - py;
+        out[i] = sqrtf(dx * dx + dy * dy);
+    }
+}
+
+static void segmentLengthsScalar(const float* xs, const float* ys, size_t count, float* out) {
+    for (size_t i = 0; i + 1 < count; i++) {
+        float dx = xs[i + 1] - xs[i], dy = ys[i + 1] - ys[i];
+        out[i] = sqrtf(dx * dx + dy * dy);
+    }
+}
+
+static void transformScalar(const float* xs, const float* ys, size_t count, float scaleX, float scaleY,
+    float offsetX, float offsetY, float* outX, float* outY) {
+    for (size_t i = 0; i < count; i++) {
+        outX[i] = xs[i] * scaleX + offsetX;
+        outY[i] = ys[i] * scaleY + offsetY;
+    }
+}
+
+static void boundingBoxScalar(const float* xs, const float* ys, size_t count,
+    float* minX, float* minY, float* maxX, float* maxY) {
+    if (count == 0) return;
+    float x0 = xs[0], x1 = xs[0], y0 = ys[0], y1 = ys[0];
+    for (size_t i = 1; i < count; i++) {
+        x0 = std::min(x0, xs[i]);
+        x1 = std::max(x1, xs[i]);
+        y0 = std::min(y0, ys[i]);
+        y1 = std::max(y1, ys[i]);
+    }
+    *minX = x0; *minY = y0; *maxX = x1; *maxY = y1;
+}
+
+static int nearestPointScalar(const float* xs, const float* ys, size_t count, float px, float py, float* distanceSq) {
+    int best = -1;
+    float bestSq = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float dx = xs[i] - px, dy = ys[i] - py;
+        float sq = dx * dx + dy * dy;
+        if (best == -1 || sq < bestSq) {
+            best = (int)i;
+            bestSq = sq;
+        }
+    }
+    if (distanceSq && best != -1) *distanceSq = bestSq;
+    return best;
+}
+
+#ifdef GEOMETRY_SIMD
+
+// ---------------- SSE2 (4 tacke) ----------------
+
+static void distancesToPointSSE2(const float* xs, const float* ys, size_t count, float px, float py, float* out) {
+    __m128 vx = _mm_set1_ps(px), vy = _mm_set1_ps(py);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), vy);
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+    }
+    distancesToPointScalar(xs + i, ys + i, count - i, px, py, out + i);
+}
+
+static void segmentLengthsSSE2(const float* xs, const float* ys, size_t count, float* out) {
+    size_t i = 0;
+    for (; i + 5 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i + 1), _mm_loadu_ps(xs + i));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i + 1), _mm_loadu_ps(ys + i));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+    }
+    if (i < count) segmentLengthsScalar(xs + i, ys + i, count - i, out + i);
+}
+
+static void transformSSE2(const float* xs, const float* ys, size_t count, float scaleX, float scaleY,
+    float offsetX, float offsetY, float* outX, float* outY) {
+    __m128 sx = _mm_set1_ps(scaleX), sy = _mm_set1_ps(scaleY);
+    __m128 ox = _mm_set1_ps(offsetX), oy = _mm_set1_ps(offsetY);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(xs + i), sx), ox));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ys + i), sy), oy));
+    }
+    transformScalar(xs + i, ys + i, count - i, scaleX, scaleY, offsetX, offsetY, outX + i, outY + i);
+}
+
+static void boundingBoxSSE2(const float* xs, const float* ys, size_t count,
+    float* minX, float* minY, float* maxX, float* maxY) {
+    if (count < 4) {
+        boundingBoxScalar(xs, ys, count, minX, minY, maxX, maxY);
+        return;
+    }
+    __m128 x0 = _mm_loadu_ps(xs), x1 = x0, y0 = _mm_loadu_ps(ys), y1 = y0;
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+        x0 = _mm_min_ps(x0, x); x1 = _mm_max_ps(x1, x);
+        y0 = _mm_min_ps(y0, y); y1 = _mm_max_ps(y1, y);
+    }
+    float lanes[4][4];
+    _mm_storeu_ps(lanes[0], x0); _mm_storeu_ps(lanes[1], y0);
+    _mm_storeu_ps(lanes[2], x1); _mm_storeu_ps(lanes[3], y1);
+    float bx0 = lanes[0][0], by0 = lanes[1][0], bx1 = lanes[2][0], by1 = lanes[3][0];
+    for (int k = 1; k < 4; k++) {
+        bx0 = std::min(bx0, lanes[0][k]); by0 = std::min(by0, lanes[1][k]);
+        bx1 = std::max(bx1, lanes[2][k]); by1 = std::max(by1, lanes[3][k]);
+    }
+    for (; i < count; i++) {
+        bx0 = std::min(bx0, xs[i]); by0 = std::min(by0, ys[i]);
+        bx1 = std::max(bx1, xs[i]); by1 = std::max(by1, ys[i]);
+    }
+    *minX = bx0; *minY = by0; *maxX = bx1; *maxY = by1;
+}
+
+static int nearestPointSSE2(const float* xs, const float* ys, size_t count, float px, float py, float* distanceSq) {
+    if (count < 4) return nearestPointScalar(xs, ys, count, px, py, distanceSq);
+
+    // Svaka traka pamti svoj minimum i indeks; stroga nejednakost zadrzava manji indeks
+    __m128 vx = _mm_set1_ps(px), vy = _mm_set1_ps(py);
+    __m128 bestSq = _mm_set1_ps(INFINITY);
+    __m128i bestIndex = _mm_setzero_si128();
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), vy);
+        __m128 sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 less = _mm_cmplt_ps(sq, bestSq);
+        bestSq = _mm_or_ps(_mm_and_ps(less, sq), _mm_andnot_ps(less, bestSq));
+        __m128i mask = _mm_castps_si128(less);
+        bestIndex = _mm_or_si128(_mm_and_si128(mask, index), _mm_andnot_si128(mask, bestIndex));
+        index = _mm_add_epi32(index, step);
+    }
+
+    float laneSq[4];
+    int laneIndex[4];
+    _mm_storeu_ps(laneSq, bestSq);
+    _mm_storeu_si128((__m128i*)laneIndex, bestIndex);
+    int best = laneIndex[0];
+    float bestValue = laneSq[0];
+    for (int k = 1; k < 4; k++) {
+        if (laneSq[k] < bestValue || (laneSq[k] == bestValue && laneIndex[k] < best)) {
+            best = laneIndex[k];
+            bestValue = laneSq[k];
+        }
+    }
+    for (; i < count; i++) {
+        float dx = xs[i] - px, dy = ys[i] - py;
+        float sq = dx * dx + dy * dy;
+        if (sq < bestValue) {
+            best = (int)i;
+            bestValue = sq;
+        }
+    }
+    if (distanceSq) *distanceSq = bestValue;
+    return best;
+}
+
+// ---------------- AVX2 (8 tacaka) ----------------
+
+TARGET_AVX2 static void distancesToPointAVX2(const float* xs, const float* ys, size_t count, float px, float py, float* out) {
+    __m256 vx = _mm256_set1_ps(px), vy = _mm256_set1_ps(py);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), vx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), vy);
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))));
+    }
+    distancesToPointSSE2(xs + i, ys + i, count - i, px, py, out + i);
+}
+
+TARGET_AVX2 static void segmentLengthsAVX2(const float* xs, const float* ys, size_t count, float* out) {
+    size_t i = 0;
+    for (; i + 9 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i + 1), _mm256_loadu_ps(xs + i));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i + 1), _mm256_loadu_ps(ys + i));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))));
+    }
+    if (i < count) segmentLengthsSSE2(xs + i, ys + i, count - i, out + i);
+}
+
+TARGET_AVX2 static void transformAVX2(const float* xs, const float* ys, size_t count, float scaleX, float scaleY,
+    float offsetX, float offsetY, float* outX, float* outY) {
+    __m256 sx = _mm256_set1_ps(scaleX), sy = _mm256_set1_ps(scaleY);
+    __m256 ox = _mm256_set1_ps(offsetX), oy = _mm256_set1_ps(offsetY);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(xs + i), sx), ox));
+        _mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(ys + i), sy), oy));
+    }
+    transformSSE2(xs + i, ys + i, count - i, scaleX, scaleY, offsetX, offsetY, outX + i, outY + i);
+}
+
+TARGET_AVX2 static void boundingBoxAVX2(const float* xs, const float* ys, size_t count,
+    float* minX, float* minY, float* maxX, float* maxY) {
+    if (count < 8) {
+        boundingBoxSSE2(xs, ys, count, minX, minY, maxX, maxY);
+        return;
+    }
+    __m256 x0 = _mm256_loadu_ps(xs), x1 = x0, y0 = _mm256_loadu_ps(ys), y1 = y0;
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i);
+        x0 = _mm256_min_ps(x0, x); x1 = _mm256_max_ps(x1, x);
+        y0 = _mm256_min_ps(y0, y); y1 = _mm256_max_ps(y1, y);
+    }
+    float lanes[4][8];
+    _mm256_storeu_ps(lanes[0], x0); _mm256_storeu_ps(lanes[1], y0);
+    _mm256_storeu_ps(lanes[2], x1); _mm256_storeu_ps(lanes[3], y1);
+    float bx0 = lanes[0][0], by0 = lanes[1][0], bx1 = lanes[2][0], by1 = lanes[3][0];
+    for (int k = 1; k < 8; k++) {
+        bx0 = std::min(bx0, lanes[0][k]); by0 = std::min(by0, lanes[1][k]);
+        bx1 = std::max(bx1, lanes[2][k]); by1 = std::max(by1, lanes[3][k]);
+    }
+    for (; i < count; i++) {
+        bx0 = std::min(bx0, xs[i]); by0 = std::min(by0, ys[i]);
+        bx1 = std::max(bx1, xs[i]); by1 = std::max(by1, ys[i]);
+    }
+    *minX = bx0; *minY = by0; *maxX = bx1; *maxY = by1;
+}
+
+TARGET_AVX2 static int nearestPointAVX2(const float* xs, const float* ys, size_t count, float px, float py, float* distanceSq) {
+    if (count < 8) return nearestPointSSE2(xs, ys, count, px, py, distanceSq);
+
+    __m256 vx = _mm256_set1_ps(px), vy = _mm256_set1_ps(py);
+    __m256 bestSq = _mm256_set1_ps(INFINITY);
+    __m256i bestIndex = _mm256_setzero_si256();
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), vx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), vy);
+        __m256 sq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 less = _mm256_cmp_ps(sq, bestSq, _CMP_LT_OQ);
+        bestSq = _mm256_blendv_ps(bestSq, sq, less);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(less));
+        index = _mm256_add_epi32(index, step);
+    }
+
+    float laneSq[8];
+    int laneIndex[8];
+    _mm256_storeu_ps(laneSq, bestSq);
+    _mm256_storeu_si256((__m256i*)laneIndex, bestIndex);
+    int best = laneIndex[0];
+    float bestValue = laneSq[0];
+    for (int k = 1; k < 8; k++) {
+        if (laneSq[k] < bestValue || (laneSq[k] == bestValue && laneIndex[k] < best)) {
+            best = laneIndex[k];
+            bestValue = laneSq[k];
+        }
+    }
+    for (; i < count; i++) {
+        float dx = xs[i] - px, dy = ys[i] - py;
+        float sq = dx * dx + dy * dy;
+        if (sq < bestValue) {
+            best = (int)i;
+            bestValue = sq;
+        }
+    }
+    if (distanceSq) *distanceSq = bestValue;
+    return best;
+}
+
+static bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 6) != 6) return false; // OS cuva YMM registre
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // GEOMETRY_SIMD
+
+bool getGeometryKernels(KernelSet set, GeometryKernels& out) {
+    switch (set) {
+    case KernelSet::Scalar:
+        out = { set, distancesToPointScalar, segmentLengthsScalar, transformScalar, boundingBoxScalar, nearestPointScalar };
+        return true;
+#ifdef GEOMETRY_SIMD
+    case KernelSet::SSE2: // Deo osnovnog x86-64 skupa
+        out = { set, distancesToPointSSE2, segmentLengthsSSE2, transformSSE2, boundingBoxSSE2, nearestPointSSE2 };
+        return true;
+    case KernelSet::AVX2:
+        if (!cpuHasAVX2()) return false;
+        out = { set, distancesToPointAVX2, segmentLengthsAVX2, transformAVX2, boundingBoxAVX2, nearestPointAVX2 };
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+KernelSet initGeometryKernels() {
+    for (int set = (int)KernelSet::Count - 1; set >= 0; set--) {
+        if (getGeometryKernels((KernelSet)set, geometryKernels)) break;
+    }
+    std::cout << "Geometrijske funkcije: " << kernelSetName(geometryKernels.set) << std::endl;
+    return geometryKernels.set;
+}
+
+const char* kernelSetName(KernelSet set) {
+    switch (set) {
+    case KernelSet::Scalar: return "skalarno";
+    case KernelSet::SSE2: return "SSE2";
+    case KernelSet::AVX2: return "AVX2";
+    default: return "?";
+    }
+}
+
+void benchmarkGeometryKernels() {
+    const size_t POINTS = 1 << 16;      // Staje u L2, meri se racun a ne memorija
+    const int REPEATS = 200;
+
+    std::vector<float> xs(POINTS), ys(POINTS), outX(POINTS), outY(POINTS);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < POINTS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        xs[i] = (seed >> 8) / 16777216.0f;
+        seed = seed * 1664525u + 1013904223u;
+        ys[i] = (seed >> 8) / 16777216.0f;
+    }
+
+    // Najbolje od REPEATS merenja, u milionima tacaka po sekundi
+    auto measure = [&](auto&& kernel) {
+        double best = 1e30;
+        for (int r = 0; r < REPEATS; r++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            kernel();
+            double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            best = std::min(best, seconds);
+        }
+        return POINTS / best / 1.0e6;
+    };
+
+    std::cout << "--- Geometry kernels (" << POINTS << " tacaka, Mpts/s) ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    volatile float sink = 0.0f; // Da kompajler ne izbaci pozive
+    for (int set = 0; set < (int)KernelSet::Count; set++) {
+        GeometryKernels k;
+        if (!getGeometryKernels((KernelSet)set, k)) continue;
+
+        float minX = 0, minY = 0, maxX = 0, maxY = 0, distanceSq = 0;
+        double distance = measure([&] { k.distancesToPoint(xs.data(), ys.data(), POINTS, 0.5f, 0.5f, outX.data()); sink = outX[7]; });
+        double segments = measure([&] { k.segmentLengths(xs.data(), ys.data(), POINTS, outX.data()); sink = outX[7]; });
+        double transform = measure([&] { k.transform(xs.data(), ys.data(), POINTS, 2.0f, 2.0f, -1.0f, -1.0f, outX.data(), outY.data()); sink = outY[7]; });
+        double bbox = measure([&] { k.boundingBox(xs.data(), ys.data(), POINTS, &minX, &minY, &maxX, &maxY); sink = maxX; });
+        double nearest = measure([&] { sink = (float)k.nearestPoint(xs.data(), ys.data(), POINTS, 0.25f, 0.75f, &distanceSq); });
+
+        std::cout << std::setw(9) << kernelSetName(k.set)
+            << " | distance " << distance
+            << " | segments " << segments
+            << " | transform " << transform
+            << " | bbox " << bbox
+            << " | nearest " << nearest << std::endl;
+    }
+    (void)sink;
+}
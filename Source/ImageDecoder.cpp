@@ -0,0 +1,716 @@
+#include "../Header/ImageDecoder.h"
+#include "../Header/FileIO.h"
+#include "../Header/JobSystem.h"
+#include "../Header/PngWriter.h"
+#include "../Header/stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+static const unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static uint32_t get32BigEndian(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void flipRows(unsigned char* pixels, int width, int height) {
+    size_t stride = (size_t)width * 4;
+    std::vector<unsigned char> row(stride);
+    for (int top = 0, bottom = height - 1; top < bottom; top++, bottom--) {
+        memcpy(row.data(), pixels + top * stride, stride);
+        memcpy(pixels + top * stride, pixels + bottom * stride, stride);
+        memcpy(pixels + bottom * stride, row.data(), stride);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Inflate (RFC 1951): stored, fiksni i dinamicki Huffman blokovi
+
+static const int FAST_BITS = 10;
+
+static const uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const uint8_t CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Kanonski Huffman kod. Kodovi do FAST_BITS bitova se dekodiraju jednim pogledom u tabelu
+// (ulaz = duzina << 9 | simbol), duzi se traze poredjenjem sa granicama po duzini
+struct Huffman {
+    uint16_t fast[1 << FAST_BITS];
+    uint32_t maxCode[17];       // Prvi kod (poravnat na 16 bitova) koji je duzi od date duzine
+    uint16_t firstCode[16];
+    uint16_t firstSymbol[16];
+    uint16_t symbols[288];
+
+    bool Build(const uint8_t* lengths, int count) {
+        int counts[16] = {};
+        for (int i = 0; i < count; i++) counts[lengths[i]]++;
+        counts[0] = 0;
+        memset(fast, 0, sizeof(fast));
+
+        uint16_t nextCode[16];
+        int code = 0, symbol = 0;
+        for (int length = 1; length < 16; length++) {
+            nextCode[length] = (uint16_t)code;
+            firstCode[length] = (uint16_t)code;
+            firstSymbol[length] = (uint16_t)symbol;
+            code += counts[length];
+            if (counts[length] && code - 1 >= (1 << length)) return false; // Preplavljen kod
+            maxCode[length] = (uint32_t)code << (16 - length);
+            code <<= 1;
+            symbol += counts[length];
+        }
+        maxCode[16] = 0x10000;
+
+        for (int i = 0; i < count; i++) {
+            int length = lengths[i];
+            if (length == 0) continue;
+            int slot = nextCode[length] - firstCode[length] + firstSymbol[length];
+            symbols[slot] = (uint16_t)i;
+            if (length <= FAST_BITS) {
+                int reversed = 0;
+                for (int bit = 0; bit < length; bit++)
+                    reversed |= ((nextCode[length] >> bit) & 1) << (length - 1 - bit);
+                for (int j = reversed; j < (1 << FAST_BITS); j += 1 << length)
+                    fast[j] = (uint16_t)((length << 9) | i);
+            }
+            nextCode[length]++;
+        }
+        return true;
+    }
+};
+
+// Citanje bitova od najnizeg, do 64 bita unapred. Posle kraja ulaza pune se nule i broji
+// koliko je takvih bajtova dodato, pa se prekoracenje otkriva na kraju bloka
+struct BitReader {
+    const unsigned char* p;
+    const unsigned char* end;
+    uint64_t bits;
+    int count;
+    size_t padding;
+
+    BitReader(const unsigned char* data, size_t size) : p(data), end(data + size), bits(0), count(0), padding(0) {}
+
+    void Refill() {
+        while (count <= 56) {
+            uint64_t byte = 0;
+            if (p < end) byte = *p++;
+            else padding++;
+            bits |= byte << count;
+            count += 8;
+        }
+    }
+    uint32_t Take(int n) {
+        if (count < n) Refill();
+        uint32_t value = (uint32_t)(bits & ((1ull << n) - 1));
+        bits >>= n;
+        count -= n;
+        return value;
+    }
+    bool Overrun() const { return padding * 8 > (size_t)count; }
+
+    int Decode(const Huffman& huffman) {
+        if (count < 16) Refill();
+        uint16_t entry = huffman.fast[bits & ((1 << FAST_BITS) - 1)];
+        if (entry) {
+            int length = entry >> 9;
+            bits >>= length;
+            count -= length;
+            return entry & 511;
+        }
+        uint32_t reversed = 0;
+        for (int bit = 0; bit < 16; bit++) reversed |= (uint32_t)((bits >> bit) & 1) << (15 - bit);
+        int length = FAST_BITS + 1;
+        while (length < 16 && reversed >= huffman.maxCode[length]) length++;
+        if (length >= 16) return -1;
+        int slot = (int)(reversed >> (16 - length)) - huffman.firstCode[length] + huffman.firstSymbol[length];
+        if (slot < 0 || slot >= 288) return -1;
+        bits >>= length;
+        count -= length;
+        return huffman.symbols[slot];
+    }
+};
+
+static const Huffman* fixedTables() {
+    static Huffman tables[2];
+    static bool built = [] {
+        uint8_t lengths[288];
+        for (int i = 0; i < 144; i++) lengths[i] = 8;
+        for (int i = 144; i < 256; i++) lengths[i] = 9;
+        for (int i = 256; i < 280; i++) lengths[i] = 7;
+        for (int i = 280; i < 288; i++) lengths[i] = 8;
+        tables[0].Build(lengths, 288);
+        for (int i = 0; i < 30; i++) lengths[i] = 5;
+        tables[1].Build(lengths, 30);
+        return true;
+    }();
+    (void)built;
+    return tables;
+}
+
+static bool readDynamicTables(BitReader& in, Huffman& literals, Huffman& distances) {
+    int literalCount = in.Take(5) + 257;
+    int distanceCount = in.Take(5) + 1;
+    int codeLengthCount = in.Take(4) + 4;
+    if (literalCount > 286 || distanceCount > 30) return false;
+
+    uint8_t codeLengths[19] = {};
+    for (int i = 0; i < codeLengthCount; i++) codeLengths[CODE_LENGTH_ORDER[i]] = (uint8_t)in.Take(3);
+    Huffman codeLengthCode;
+    if (!codeLengthCode.Build(codeLengths, 19)) return false;
+
+    uint8_t lengths[286 + 30];
+    int total = literalCount + distanceCount, n = 0;
+    while (n < total) {
+        int symbol = in.Decode(codeLengthCode);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[n++] = (uint8_t)symbol;
+            continue;
+        }
+        int repeat;
+        uint8_t value = 0;
+        if (symbol == 16) {
+            if (n == 0) return false;
+            repeat = 3 + in.Take(2);
+            value = lengths[n - 1];
+        }
+        else if (symbol == 17) repeat = 3 + in.Take(3);
+        else repeat = 11 + in.Take(7);
+        if (n + repeat > total) return false;
+        memset(lengths + n, value, repeat);
+        n += repeat;
+    }
+    return literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+}
+
+// Raspakuje blokove dok se izlaz ne popuni ili ne prodje poslednji blok.
+// Reference unazad ne smeju preci pocetak dst - traka mora biti samostalna
+static bool inflate(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize, size_t& written) {
+    BitReader in(src, srcSize);
+    unsigned char* out = dst;
+    unsigned char* outEnd = dst + dstSize;
+    Huffman dynamicLiterals, dynamicDistances;
+    bool final = false;
+
+    while (!final && out < outEnd) {
+        final = in.Take(1) != 0;
+        int type = in.Take(2);
+        if (type == 0) {
+            in.Take(in.count & 7); // Poravnanje na bajt
+            uint32_t length = in.Take(16);
+            uint32_t complement = in.Take(16);
+            if ((length ^ 0xFFFF) != complement) return false;
+            // Bitovi koji su vec procitani unapred se prvo vracaju iz bafera
+            while (length > 0 && in.count >= 8) {
+                if (out >= outEnd) return false;
+                *out++ = (unsigned char)in.Take(8);
+                length--;
+            }
+            if (length > (size_t)(in.end - in.p) || length > (size_t)(outEnd - out)) return false;
+            memcpy(out, in.p, length);
+            out += length;
+            in.p += length;
+            continue;
+        }
+        if (type == 3) return false;
+
+        const Huffman* literals;
+        const Huffman* distances;
+        if (type == 1) {
+            literals = &fixedTables()[0];
+            distances = &fixedTables()[1];
+        }
+        else {
+            if (!readDynamicTables(in, dynamicLiterals, dynamicDistances)) return false;
+            literals = &dynamicLiterals;
+            distances = &dynamicDistances;
+        }
+
+        for (;;) {
+            int symbol = in.Decode(*literals);
+            if (symbol < 256) {
+                if (symbol < 0 || out >= outEnd) return false;
+                *out++ = (unsigned char)symbol;
+                continue;
+            }
+            if (symbol == 256) break;
+            symbol -= 257;
+            if (symbol >= 29) return false;
+            size_t length = LENGTH_BASE[symbol] + in.Take(LENGTH_EXTRA[symbol]);
+            int distanceSymbol = in.Decode(*distances);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+            size_t distance = DISTANCE_BASE[distanceSymbol] + in.Take(DISTANCE_EXTRA[distanceSymbol]);
+            if (distance > (size_t)(out - dst) || length > (size_t)(outEnd - out)) return false;
+
+            const unsigned char* from = out - distance;
+            if (distance >= length) memcpy(out, from, length);
+            else for (size_t i = 0; i < length; i++) out[i] = from[i];
+            out += length;
+        }
+        if (in.Overrun()) return false;
+    }
+    written = out - dst;
+    return !in.Overrun();
+}
+
+// ---------------------------------------------------------------------------------------------
+// PNG filteri
+
+static inline unsigned char paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (unsigned char)a;
+    return (unsigned char)(pb <= pc ? b : c);
+}
+
+// rows: redovi oblika [filter][stride bajtova], defiltriraju se na mestu.
+// previous je defiltriran red iznad prvog (nule za prvi red slike)
+static bool unfilterRows(unsigned char* rows, int count, size_t stride, int bpp, const unsigned char* previous) {
+    for (int r = 0; r < count; r++) {
+        unsigned char* row = rows + r * (stride + 1);
+        int filter = row[0];
+        unsigned char* x = row + 1;
+        const unsigned char* up = previous;
+        switch (filter) {
+        case 0:
+            break;
+        case 1:
+            for (size_t i = bpp; i < stride; i++) x[i] = (unsigned char)(x[i] + x[i - bpp]);
+            break;
+        case 2:
+            for (size_t i = 0; i < stride; i++) x[i] = (unsigned char)(x[i] + up[i]);
+            break;
+        case 3:
+            for (int i = 0; i < bpp; i++) x[i] = (unsigned char)(x[i] + (up[i] >> 1));
+            for (size_t i = bpp; i < stride; i++) x[i] = (unsigned char)(x[i] + ((x[i - bpp] + up[i]) >> 1));
+            break;
+        case 4:
+            for (int i = 0; i < bpp; i++) x[i] = (unsigned char)(x[i] + up[i]);
+            for (size_t i = bpp; i < stride; i++) x[i] = (unsigned char)(x[i] + paeth(x[i - bpp], up[i], up[i - bpp]));
+            break;
+        default:
+            return false;
+        }
+        previous = x;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Paralelno dekodiranje traka
+
+struct IdatSegment {
+    uint64_t streamOffset;
+    const unsigned char* data;
+    size_t size;
+};
+
+struct StripInfo {
+    int firstRow;
+    int rows;
+    uint64_t streamOffset;
+    uint64_t bytes;
+};
+
+// Pokazivac na bajtove trake u zlib toku; kopira u scratch samo ako traka prelazi vise IDAT chunk-ova
+static const unsigned char* gatherStrip(const std::vector<IdatSegment>& segments, uint64_t offset, uint64_t bytes,
+    std::vector<unsigned char>& scratch) {
+    size_t first = 0;
+    while (first < segments.size() && segments[first].streamOffset + segments[first].size <= offset) first++;
+    if (first == segments.size()) return nullptr;
+    const IdatSegment& segment = segments[first];
+    if (offset + bytes <= segment.streamOffset + segment.size)
+        return segment.data + (offset - segment.streamOffset);
+
+    scratch.resize((size_t)bytes);
+    uint64_t copied = 0;
+    for (size_t i = first; i < segments.size() && copied < bytes; i++) {
+        uint64_t from = offset + copied - segments[i].streamOffset;
+        uint64_t take = std::min<uint64_t>(segments[i].size - from, bytes - copied);
+        memcpy(scratch.data() + copied, segments[i].data + from, (size_t)take);
+        copied += take;
+    }
+    return copied == bytes ? scratch.data() : nullptr;
+}
+
+// Defiltrirani redovi trake (RGB ili RGBA) u RGBA izlaz
+static void expandRows(const unsigned char* rows, const StripInfo& strip, int width, int height, int channels,
+    bool bottomUp, unsigned char* output) {
+    size_t stride = (size_t)width * channels;
+    for (int r = 0; r < strip.rows; r++) {
+        const unsigned char* src = rows + r * (stride + 1) + 1;
+        int y = strip.firstRow + r;
+        unsigned char* dst = output + (size_t)(bottomUp ? height - 1 - y : y) * width * 4;
+        if (channels == 4) {
+            memcpy(dst, src, stride);
+            continue;
+        }
+        for (int x = 0; x < width; x++, src += 3, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+        }
+    }
+}
+
+unsigned char* decodeStripPng(const unsigned char* data, size_t size, int* width, int* height,
+    bool bottomUp, int threadCount, ImageDecodeStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (size < 8 || memcmp(data, PNG_SIGNATURE, 8) != 0) return nullptr;
+
+    int w = 0, h = 0, channels = 0;
+    std::vector<IdatSegment> segments;
+    uint64_t streamSize = 0;
+    const unsigned char* table = nullptr;
+    uint32_t tableSize = 0;
+
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        uint32_t length = get32BigEndian(data + pos);
+        const unsigned char* type = data + pos + 4;
+        const unsigned char* body = data + pos + 8;
+        if (length > size - pos - 12) return nullptr;
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length < 13) return nullptr;
+            w = (int)get32BigEndian(body);
+            h = (int)get32BigEndian(body + 4);
+            int bitDepth = body[8], colorType = body[9], interlace = body[12];
+            if (bitDepth != 8 || interlace != 0 || (colorType != 2 && colorType != 6)) return nullptr;
+            channels = colorType == 6 ? 4 : 3;
+        }
+        else if (memcmp(type, "IDAT", 4) == 0) {
+            segments.push_back({ streamSize, body, length });
+            streamSize += length;
+        }
+        else if (memcmp(type, PngWriter::STRIP_CHUNK, 4) == 0) {
+            table = body;
+            tableSize = length;
+        }
+        else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + (size_t)length;
+    }
+    if (w <= 0 || h <= 0 || !table || tableSize < 8 || segments.empty()) return nullptr;
+    if (get32BigEndian(table) != 1) return nullptr;
+
+    // Trake pocinju posle dvobajtnog zlib zaglavlja i redom pokrivaju sve redove
+    uint32_t stripCount = get32BigEndian(table + 4);
+    if (stripCount == 0 || tableSize != 8 + (uint64_t)stripCount * 12) return nullptr;
+    unsigned char zlibHeader[2];
+    std::vector<unsigned char> headerScratch;
+    const unsigned char* header = gatherStrip(segments, 0, 2, headerScratch);
+    if (!header) return nullptr;
+    memcpy(zlibHeader, header, 2);
+    if ((zlibHeader[0] & 0x0F) != 8 || (zlibHeader[1] & 0x20) || ((zlibHeader[0] << 8) | zlibHeader[1]) % 31)
+        return nullptr;
+
+    std::vector<StripInfo> strips(stripCount);
+    uint64_t offset = 2;
+    int row = 0;
+    for (uint32_t i = 0; i < stripCount; i++) {
+        const unsigned char* entry = table + 8 + i * 12;
+        strips[i].firstRow = row;
+        strips[i].rows = (int)get32BigEndian(entry);
+        strips[i].streamOffset = offset;
+        strips[i].bytes = ((uint64_t)get32BigEndian(entry + 4) << 32) | get32BigEndian(entry + 8);
+        if (strips[i].rows <= 0 || strips[i].rows > h - row) return nullptr;
+        row += strips[i].rows;
+        offset += strips[i].bytes;
+    }
+    if (row != h || offset > streamSize) return nullptr;
+
+    unsigned char* output = (unsigned char*)malloc((size_t)w * h * 4);
+    if (!output) return nullptr;
+
+    // Traka ciji prvi red ne zavisi od reda iznad (filter None/Sub, ili prvi red slike)
+    // zavrsava se odmah; ostale cekaju prethodnu traku i rade se redom posle niti
+    size_t stride = (size_t)w * channels;
+    std::vector<std::vector<unsigned char>> deferred(stripCount);
+    std::atomic<uint32_t> nextStrip(0);
+    std::atomic<bool> failed(false);
+
+    auto work = [&]() {
+        std::vector<unsigned char> rows, compressed;
+        const std::vector<unsigned char> zeroRow(stride, 0);
+        for (uint32_t i = nextStrip++; i < stripCount && !failed; i = nextStrip++) {
+            const StripInfo& strip = strips[i];
+            const unsigned char* source = gatherStrip(segments, strip.streamOffset, strip.bytes, compressed);
+            size_t expected = (size_t)strip.rows * (stride + 1), written = 0;
+            rows.resize(expected);
+            if (!source || !inflate(source, (size_t)strip.bytes, rows.data(), expected, written) || written != expected) {
+                failed = true;
+                break;
+            }
+            if (i > 0 && rows[0] >= 2) {
+                deferred[i].swap(rows);
+                continue;
+            }
+            if (!unfilterRows(rows.data(), strip.rows, stride, channels, zeroRow.data())) {
+                failed = true;
+                break;
+            }
+            expandRows(rows.data(), strip, w, h, channels, bottomUp, output);
+        }
+    };
+
+    // Pomocnici su poslovi u JobSystem-u; pozivalac radi isto i ceka ih (pomazuci drugim poslovima)
+    int threads = std::min(threadCount > 0 ? threadCount : jobSystem.Concurrency(), jobSystem.Concurrency());
+    threads = std::min<int>(threads, (int)stripCount);
+    std::vector<JobSystem::JobHandle> helpers;
+    for (int t = 1; t < threads; t++) helpers.push_back(jobSystem.Submit(work));
+    work();
+    for (const JobSystem::JobHandle& helper : helpers) jobSystem.Wait(helper);
+
+    // Red iznad odlozene trake se vraca iz vec popunjenog RGBA izlaza
+    std::vector<unsigned char> previous(stride);
+    for (uint32_t i = 0; i < stripCount && !failed; i++) {
+        if (deferred[i].empty()) continue;
+        const StripInfo& strip = strips[i];
+        int y = strip.firstRow - 1;
+        const unsigned char* above = output + (size_t)(bottomUp ? h - 1 - y : y) * w * 4;
+        for (int x = 0; x < w; x++)
+            for (int c = 0; c < channels; c++) previous[x * channels + c] = above[x * 4 + c];
+        if (!unfilterRows(deferred[i].data(), strip.rows, stride, channels, previous.data())) failed = true;
+        else expandRows(deferred[i].data(), strip, w, h, channels, bottomUp, output);
+    }
+    if (failed) {
+        free(output);
+        return nullptr;
+    }
+
+    *width = w;
+    *height = h;
+    if (stats) {
+        stats->backend = ImageBackend::StripPng;
+        stats->threads = threads;
+        stats->strips = (int)stripCount;
+        stats->fileBytes = size;
+        stats->milliseconds = millisecondsSince(start);
+    }
+    return output;
+}
+
+bool inflateZlib(const unsigned char* src, size_t size, unsigned char* dst, size_t dstSize, size_t* written) {
+    if (size < 2 || (src[0] & 0x0F) != 8 || (src[1] & 0x20) || ((src[0] << 8) | src[1]) % 31) return false;
+    size_t count = 0;
+    if (!inflate(src + 2, size - 2, dst, dstSize, count)) return false;
+    *written = count;
+    return true;
+}
+
+unsigned char* decodeImageMemoryRGBA(const unsigned char* data, size_t size, int* width, int* height, bool bottomUp,
+    ImageDecodeStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    unsigned char* pixels = decodeStripPng(data, size, width, height, bottomUp, 0, stats);
+    if (pixels) return pixels;
+
+    int channels;
+    if (size == 0 || size > (size_t)INT32_MAX) return nullptr;
+    pixels = stbi_load_from_memory(data, (int)size, width, height, &channels, 4);
+    if (!pixels) return nullptr;
+    if (bottomUp) flipRows(pixels, *width, *height);
+    if (stats) {
+        stats->backend = ImageBackend::Stb;
+        stats->threads = 1;
+        stats->strips = 1;
+        stats->fileBytes = size;
+        stats->milliseconds = millisecondsSince(start);
+    }
+    return pixels;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Kes traka za obican PNG
+
+// Trake kao kod izvoza mape, samo nize da bi i mapa od 1080 redova imala dovoljno traka
+static const int STRIP_ROWS = 64;
+// Manje slike (ikone) stb dekodira brze nego sto bi se isplatio kes
+static const size_t STRIP_CACHE_MIN_BYTES = 1024 * 1024;
+static const char* const STRIP_CACHE_SUFFIX = ".strips.png";
+
+// Upis preko "path.tmp" i zamene imena, pa citalac nikad ne vidi pola fajla
+static bool writeStripPng(const char* path, const unsigned char* rgba, int width, int height, int channels) {
+    std::string temporary = std::string(path) + ".tmp";
+    PngWriter writer;
+    if (!writer.Begin(temporary.c_str(), width, height, channels)) return false;
+    std::vector<unsigned char> packed((size_t)width * STRIP_ROWS * channels);
+    PngWriter::Strip strip;
+    bool ok = true;
+    for (int y = 0; y < height && ok; y += STRIP_ROWS) {
+        int rows = std::min(STRIP_ROWS, height - y);
+        const unsigned char* src = rgba + (size_t)y * width * 4;
+        for (size_t i = 0, n = (size_t)width * rows; i < n; i++)
+            memcpy(&packed[i * channels], src + i * 4, channels);
+        PngWriter::CompressStrip(packed.data(), width, rows, channels, strip);
+        ok = writer.WriteStrip(strip);
+    }
+    if (ok) ok = writer.End();
+    else writer.Abort();
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(temporary, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+// Kes vazi dok je noviji od originala (izmenjena mapa pravi novi kes)
+static bool stripCacheFresh(const char* path, const std::string& cachePath) {
+    std::error_code ec;
+    auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
+    if (ec) return false;
+    auto sourceTime = std::filesystem::last_write_time(path, ec);
+    return !ec && cacheTime >= sourceTime;
+}
+
+// Kopija piksela se u pozadini upisuje kao PNG sa trakama; najvise jednom po putanji u toku
+// rada (i kad upis ne uspe, npr. direktorijum samo za citanje)
+static void scheduleStripCache(const char* path, const std::string& cachePath, const unsigned char* pixels,
+    int width, int height, int channels, bool bottomUp) {
+    static std::mutex mutex;
+    static std::set<std::string> attempted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!attempted.insert(path).second) return;
+    }
+
+    std::shared_ptr<std::vector<unsigned char>> copy =
+        std::make_shared<std::vector<unsigned char>>(pixels, pixels + (size_t)width * height * 4);
+    jobSystem.Submit([copy, cachePath, width, height, channels, bottomUp]() {
+        if (bottomUp) flipRows(copy->data(), width, height);
+        if (!writeStripPng(cachePath.c_str(), copy->data(), width, height, channels))
+            std::cout << "Kes traka nije upisan: " << cachePath << std::endl;
+    });
+}
+
+unsigned char* decodeImageRGBA(const char* path, int* width, int* height, bool bottomUp, ImageDecodeStats* stats) {
+    // Obican PNG je jedan deflate tok i dekodira se na jednoj niti; zato se za veliki PNG
+    // pri prvom ucitavanju pored njega ostavi ista slika sa trakama, koja se posle cita paralelno
+    std::string cachePath = std::string(path) + STRIP_CACHE_SUFFIX;
+    if (stripCacheFresh(path, cachePath)) {
+        MappedFile cache;
+        if (cache.Open(cachePath.c_str())) {
+            unsigned char* pixels = decodeStripPng(cache.Data(), cache.Size(), width, height, bottomUp, 0, stats);
+            if (pixels) return pixels;
+        }
+    }
+
+    MappedFile file;
+    if (!file.Open(path) || file.Size() == 0) return nullptr;
+    ImageDecodeStats local = {};
+    unsigned char* pixels = decodeImageMemoryRGBA(file.Data(), file.Size(), width, height, bottomUp, &local);
+    if (stats) *stats = local;
+
+    int w, h, channels;
+    if (pixels && local.backend == ImageBackend::Stb && file.Size() >= STRIP_CACHE_MIN_BYTES &&
+        memcmp(file.Data(), PNG_SIGNATURE, 8) == 0 &&
+        stbi_info_from_memory(file.Data(), (int)file.Size(), &w, &h, &channels)) {
+        // Siva slika postaje RGB, sa alfom RGBA - isto sto stb vraca u 4 kanala
+        scheduleStripCache(path, cachePath, pixels, *width, *height, channels == 2 || channels == 4 ? 4 : 3, bottomUp);
+    }
+    return pixels;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Benchmark
+
+static const int SYNTHETIC_WIDTH = 16384;
+static const int SYNTHETIC_HEIGHT = 4096;
+
+static double megabytesPerSecond(int width, int height, double milliseconds) {
+    return (double)width * height * 4 / (1024.0 * 1024.0) / (milliseconds / 1000.0);
+}
+
+static void benchmarkFile(const char* label, const char* path, bool stripFile) {
+    MappedFile file;
+    if (!file.Open(path)) return;
+    std::cout << label << " (" << file.Size() / (1024.0 * 1024.0) << " MB):" << std::endl;
+
+    int width = 0, height = 0, channels;
+    auto start = std::chrono::steady_clock::now();
+    unsigned char* reference = stbi_load_from_memory(file.Data(), (int)file.Size(), &width, &height, &channels, 4);
+    double stbMs = millisecondsSince(start);
+    if (!reference) return;
+    std::cout << "  stb_image:           " << std::setw(8) << stbMs << " ms, "
+        << megabytesPerSecond(width, height, stbMs) << " MB/s" << std::endl;
+
+    if (stripFile) {
+        int hardware = jobSystem.Concurrency();
+        for (int threads = 1; threads <= hardware; threads = threads == hardware ? hardware + 1 : hardware) {
+            ImageDecodeStats stats = {};
+            int w = 0, h = 0;
+            unsigned char* pixels = decodeStripPng(file.Data(), file.Size(), &w, &h, false, threads, &stats);
+            bool same = pixels && w == width && h == height && memcmp(pixels, reference, (size_t)w * h * 4) == 0;
+            std::cout << "  trake, " << std::setw(2) << stats.threads << " niti:      " << std::setw(8) << stats.milliseconds
+                << " ms, " << megabytesPerSecond(width, height, stats.milliseconds) << " MB/s, " << stats.strips
+                << " traka" << (same ? "" : " - RAZLIKA OD stb!") << std::endl;
+            free(pixels);
+        }
+    }
+    stbi_image_free(reference);
+}
+
+void benchmarkImageDecode(const char* mapPath) {
+    const char* mapStripPath = "decode_benchmark_map.png";
+    const char* syntheticPath = "decode_benchmark_16k.png";
+
+    int mapWidth, mapHeight, channels;
+    unsigned char* map = stbi_load(mapPath, &mapWidth, &mapHeight, &channels, 4);
+    if (!map) {
+        std::cout << "Decode benchmark: ne mogu da ucitam " << mapPath << std::endl;
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << "--- Image decode benchmark ---" << std::endl;
+    benchmarkFile("mapa, originalni PNG", mapPath, false);
+    if (writeStripPng(mapStripPath, map, mapWidth, mapHeight, 4))
+        benchmarkFile("mapa, PNG sa trakama", mapStripPath, true);
+
+    // Sinteticka mapa 16k x 4k (RGB, kao izvoz): mapa ponavljana sa pomerajem po redu ploca,
+    // da sadrzaj lici na stvarnu mapu a ne bude savrseno ponovljiv
+    {
+        std::vector<unsigned char> synthetic((size_t)SYNTHETIC_WIDTH * SYNTHETIC_HEIGHT * 4);
+        for (int y = 0; y < SYNTHETIC_HEIGHT; y++) {
+            int tileRow = y / mapHeight;
+            const unsigned char* src = map + (size_t)(y % mapHeight) * mapWidth * 4;
+            unsigned char* dst = synthetic.data() + (size_t)y * SYNTHETIC_WIDTH * 4;
+            for (int x = 0; x < SYNTHETIC_WIDTH; x++)
+                memcpy(dst + x * 4, src + ((x + tileRow * 517) % mapWidth) * 4, 4);
+        }
+        bool written = writeStripPng(syntheticPath, synthetic.data(), SYNTHETIC_WIDTH, SYNTHETIC_HEIGHT, 3);
+        synthetic.clear();
+        synthetic.shrink_to_fit();
+        if (written) benchmarkFile("sinteticka mapa 16384x4096", syntheticPath, true);
+    }
+
+    stbi_image_free(map);
+    remove(mapStripPath);
+    remove(syntheticPath);
+}
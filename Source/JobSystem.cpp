@@ -0,0 +1,281 @@
+#include "../Header/JobSystem.h"
+#include "../Header/FrameStats.h"
+#include <algorithm>
+#include <chrono>
+
+JobSystem jobSystem;
+
+struct JobSystem::Job {
+    Function function;
+    std::atomic<int> pending;           // Nezavrsene zavisnosti (+1 dok Create ne zavrsi)
+    std::atomic<bool> done;
+    bool mainThread;
+    std::mutex mutex;                   // Stiti done pri upisu i dependents
+    std::vector<JobHandle> dependents;  // Cekaju na ovaj posao
+};
+
+// Indeks radne niti u workers; -1 za glavnu i ostale niti
+static thread_local int currentWorker = -1;
+
+JobSystem::JobSystem()
+    : sleeping(0), waiting(0), running(false), mainThread(std::this_thread::get_id()), nextWorker(0),
+    queued(0), mainQueued(0), submitted(0), executed(0), stolen(0), mainExecuted(0), lastFrame() {
+}
+
+JobSystem::~JobSystem() {
+    Stop();
+}
+
+void JobSystem::Start(int threadCount) {
+    Stop();
+    if (threadCount <= 0) threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    mainThread = std::this_thread::get_id();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = true;
+    }
+    // Svi redovi postoje pre nego sto prva nit pocne da krade
+    for (int i = 0; i < threadCount; i++)
+        workers.emplace_back(new Worker());
+    for (int i = 0; i < threadCount; i++)
+        workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers)
+        if (worker->thread.joinable()) worker->thread.join();
+    workers.clear();
+}
+
+void JobSystem::WorkerLoop(int index) {
+    currentWorker = index;
+    while (true) {
+        bool wasStolen;
+        JobHandle job = Take(index, wasStolen);
+        if (job) {
+            if (wasStolen) stolen++;
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (!running && queued == 0) return;
+        sleeping++;
+        wake.wait(lock, [this] { return !running || queued > 0; });
+        sleeping--;
+    }
+}
+
+JobSystem::JobHandle JobSystem::Create(Function function, bool onMainThread, const std::vector<JobHandle>& dependencies) {
+    JobHandle job = std::make_shared<Job>();
+    job->function = std::move(function);
+    job->pending = 1 + (int)dependencies.size();
+    job->done = false;
+    job->mainThread = onMainThread;
+    submitted++;
+
+    for (const JobHandle& dependency : dependencies) {
+        if (dependency) {
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if (!dependency->done) {
+                dependency->dependents.push_back(job);
+                continue;
+            }
+        }
+        job->pending--;
+    }
+    if (--job->pending == 0) Schedule(job);
+    return job;
+}
+
+JobSystem::JobHandle JobSystem::Submit(Function function, const std::vector<JobHandle>& dependencies) {
+    return Create(std::move(function), false, dependencies);
+}
+
+JobSystem::JobHandle JobSystem::SubmitMainThread(Function function, const std::vector<JobHandle>& dependencies) {
+    return Create(std::move(function), true, dependencies);
+}
+
+void JobSystem::Schedule(const JobHandle& job) {
+    if (job->mainThread) {
+        std::lock_guard<std::mutex> lock(mainMutex);
+        mainJobs.push_back(job);
+        mainQueued++;
+        return;
+    }
+    if (workers.empty()) {
+        Execute(job);
+        return;
+    }
+
+    int index = currentWorker >= 0 ? currentWorker : (int)(nextWorker++ % workers.size());
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->jobs.push_back(job);
+    }
+    queued++;
+    // Brava izmedju upisa u red i budjenja: nit koja upravo zaspi ne propusti posao
+    if (sleeping > 0 || waiting > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+        if (waiting > 0) finished.notify_all();
+    }
+}
+
+JobSystem::JobHandle JobSystem::Take(int index, bool& wasStolen) {
+    wasStolen = false;
+    if (queued == 0) return nullptr;
+    int count = (int)workers.size();
+    if (index >= 0) {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            JobHandle job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queued--;
+            return job;
+        }
+    }
+
+    int start = index >= 0 ? index + 1 : 0;
+    for (int i = 0; i < count; i++) {
+        Worker& victim = *workers[(start + i) % count];
+        if ((start + i) % count == index) continue;
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) continue;
+        JobHandle job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        queued--;
+        wasStolen = true;
+        return job;
+    }
+    return nullptr;
+}
+
+JobSystem::JobHandle JobSystem::TakeMain() {
+    std::lock_guard<std::mutex> lock(mainMutex);
+    if (mainJobs.empty()) return nullptr;
+    JobHandle job = std::move(mainJobs.front());
+    mainJobs.pop_front();
+    mainQueued--;
+    return job;
+}
+
+void JobSystem::Execute(const JobHandle& job) {
+    job->function();
+    job->function = nullptr;    // Oslobodi uhvacene podatke odmah, ne tek sa poslednjom referencom
+    (job->mainThread ? mainExecuted : executed)++;
+    Complete(job);
+}
+
+void JobSystem::Complete(const JobHandle& job) {
+    std::vector<JobHandle> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done = true;
+        dependents.swap(job->dependents);
+    }
+    for (const JobHandle& dependent : dependents)
+        if (--dependent->pending == 0) Schedule(dependent);
+
+    if (waiting > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        finished.notify_all();
+    }
+}
+
+bool JobSystem::IsDone(const JobHandle& job) const {
+    return !job || job->done;
+}
+
+void JobSystem::WaitStep(const JobHandle& job) {
+    bool wasStolen;
+    JobHandle other = Take(currentWorker, wasStolen);
+    if (other) {
+        if (wasStolen) stolen++;
+        Execute(other);
+        return;
+    }
+
+    // Posao radi druga nit; budi se kada se nesto zavrsi ili pojavi nov posao
+    waiting++;
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        finished.wait_for(lock, std::chrono::milliseconds(1), [&] {
+            return IsDone(job) || queued > 0;
+        });
+    }
+    waiting--;
+}
+
+void JobSystem::Wait(const JobHandle& job) {
+    // Pomaze samo sa poslovima radnih niti: posao glavne niti bi mogao da menja stanje koje
+    // pozivalac upravo koristi (npr. uvoz koji dodaje rute usred ParallelFor nad rutama)
+    while (!IsDone(job)) WaitStep(job);
+}
+
+void JobSystem::WaitMainThread(const JobHandle& job) {
+    // Pozivalac je izabrao da ceka posao glavne niti, pa ovde sme da ih izvrsava
+    while (!IsDone(job)) {
+        if (RunMainThreadJobs(1.0) == 0) WaitStep(job);
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain, const RangeFunction& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(1, grain);
+    size_t parts = (count + grain - 1) / grain;
+    int helpers = (int)std::min<size_t>(parts, (size_t)Concurrency()) - 1;
+
+    std::atomic<size_t> next(0);
+    auto run = [&]() {
+        for (size_t begin = next.fetch_add(grain); begin < count; begin = next.fetch_add(grain))
+            body(begin, std::min(count, begin + grain));
+    };
+    std::vector<JobHandle> jobs;
+    for (int i = 0; i < helpers; i++) jobs.push_back(Submit(run));
+    run();
+    for (const JobHandle& job : jobs) Wait(job);
+}
+
+int JobSystem::RunMainThreadJobs(double budgetMs) {
+    // Samo nit sa GL kontekstom, i ne iz posla koji je ova funkcija vec pokrenula
+    static thread_local bool draining = false;
+    if (draining || std::this_thread::get_id() != mainThread.load()) return 0;
+    draining = true;
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    while (JobHandle job = TakeMain()) {
+        Execute(job);
+        count++;
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs) break;
+    }
+    draining = false;
+    return count;
+}
+
+JobSystem::Counters JobSystem::GetCounters() const {
+    Counters counters;
+    counters.submitted = submitted;
+    counters.executed = executed;
+    counters.stolen = stolen;
+    counters.mainExecuted = mainExecuted;
+    counters.queued = queued;
+    counters.mainQueued = mainQueued;
+    return counters;
+}
+
+void JobSystem::UpdateFrameStats() {
+    Counters now = GetCounters();
+    frameStats.jobsExecuted = (unsigned int)(now.executed - lastFrame.executed);
+    frameStats.jobsStolen = (unsigned int)(now.stolen - lastFrame.stolen);
+    frameStats.jobsMainThread = (unsigned int)(now.mainExecuted - lastFrame.mainExecuted);
+    frameStats.jobQueueDepth = (unsigned int)(std::max(0, now.queued) + std::max(0, now.mainQueued));
+    lastFrame = now;
+}
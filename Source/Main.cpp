@@ -3,20 +3,45 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <memory>
+#include <atomic>
 #include "../Header/Util.h"
 #include "../Header/BitmapFont.h"
+#include "../Header/ShaderReloader.h"
+#include "../Header/SpriteRenderer.h"
+#include "../Header/CommandList.h"
+#include "../Header/FrameArena.h"
+#include "../Header/FrameStats.h"
+#include "../Header/GLState.h"
+#include "../Header/Camera.h"
+#include "../Header/Geometry.h"
+#include "../Header/RouteCollection.h"
+#include "../Header/RouteRenderer.h"
+#include "../Header/RouteImport.h"
+#include "../Header/RouteFile.h"
+#include "../Header/ImageDecoder.h"
+#include "../Header/RouteJournal.h"
+#include "../Header/MapExport.h"
+#include "../Header/Samplers.h"
+#include "../Header/VirtualTexture.h"
+#include "../Header/MapSource.h"
+#include "../Header/Geodesy.h"
+#include "../Header/GeometryKernels.h"
+#include "../Header/StreamBuffer.h"
+#include "../Header/JobSystem.h"
+#include "../Header/TripleBuffer.h"
 
 // Konstante
 const unsigned int WINDOW_WIDTH = 1200;
 const unsigned int WINDOW_HEIGHT = 800;
 const float MAP_ZOOM = 0.15f; // Pokazuje 1% mape u režimu hodanja
-const float WALK_SPEED = 0.002f; // Brzina kretanja
+const float WALK_SPEED = 0.15f; // Brzina kretanja (NDC u sekundi)
 const float POINT_RADIUS = 0.015f; // Radijus tačke za klik detekciju
 const int CIRCLE_SEGMENTS = 20;
+const float ZOOM_STEP = 0.85f; // Faktor zoom-a po jednom "kliku" točkića
 BitmapFont* bitmapFont = nullptr;
 unsigned int fontShader;
 unsigned int fontTexture;
@@ -68,40 +93,88 @@ void toggleFullscreen() {
 }
 
 
-// Strukture
-struct Point {
-    float x, y;
-    Point(float x = 0, float y = 0) : x(x), y(y) {}
-};
-
-struct Line {
-    Point start, end;
-    float distance;
-};
-
 // Globalne promenljive za stanje
 enum Mode { WALKING, MEASURING };
 Mode currentMode = WALKING;
 
 // Stanje hodanja
 Point mapOffset(0.0f, 0.0f); // Pozicija kamere na mapi
-float walkingDistance = 0.0f;
+double walkingDistance = 0.0; // Metri
 
 // Stanje merenja
-std::vector<Point> measurePoints;
-std::vector<Line> measureLines;
-float totalMeasureDistance = 0.0f;
+RouteCollection routes; // Sve rute; menja ih nit događaja, ostale niti čitaju objavljene verzije
+RouteRenderer routeRenderer; // GPU opsezi ruta za ekran (render nit; izvoz ima svoj)
+int activeRoute = -1; // Ruta koju klikovi menjaju (N započinje novu, prethodna ostaje na mapi)
+DistanceEngine distanceEngine; // Map space -> geografske koordinate -> metri (Vincenty)
+std::vector<float> hitX, hitY; // Tačke rute u NDC (SoA) za proveru klika
+ImportedTracks importedTracks; // Sesija pri pokretanju
+RouteFile routeFile; // Sesija: Ctrl+S i pri zatvaranju snima, pri pokretanju učitava
+const char* ROUTE_SESSION_PATH = "session.route";
+const char* MAP_CONTROL_POINTS_PATH = "Resources/novi-sad-map-0.geo"; // Georeferenca PNG mape
+// Bez georeference: približna skala (centar Novog Sada, ~1 km po širini kao stara skala "* 1000").
+// Rastojanja su tada samo orijentaciona, a naslov prozora to naglašava
+const double APPROX_MAP_LAT = 45.2551, APPROX_MAP_LON = 19.8452, APPROX_MAP_WIDTH_METERS = 1000.0;
+std::string windowTitle = "Map Measurement Tool";
+bool mapScaleApproximate = false;
+RouteJournal routeJournal; // Izmene posle poslednjeg snimanja, upis na pozadinskoj niti (oporavak posle pada)
+const char* ROUTE_JOURNAL_PATH = "session.journal";
+MapExport mapExport; // P: trenutni pogled (mapa + rute) u PNG EXPORT_SIZE x EXPORT_SIZE, u pozadini
+const int EXPORT_SIZE = 16384;
+CommandList exportCommands;
+const double MAIN_THREAD_JOB_BUDGET_MS = 4.0; // GL poslovi iz JobSystem-a po frejmu; ostatak čeka sledeći
+
+// Kamere: u merenju je slobodna (točkić + desni taster), u hodanju prati mapOffset
+Camera measureCamera;
+Camera walkCamera;
+bool isPanning = false;
+double lastCursorX = 0.0, lastCursorY = 0.0;
 
 // OpenGL objekti
-unsigned int mapShader, colorShader, iconShader;
-unsigned int mapVAO, mapVBO;
+unsigned int spriteShader, colorShader, pointShader, virtualMapShader, feedbackShader;
 unsigned int pinVAO, pinVBO;
-unsigned int pointVAO, pointVBO;
-unsigned int lineVAO, lineVBO;
-unsigned int iconVAO, iconVBO;
-unsigned int mapTexture;
+SpriteRenderer* spriteRenderer = nullptr; // Mapa, ikone i pozadina teksta (jedan program, instancirano)
+unsigned int viewUBO; // ViewParams: matrica pogleda map space -> NDC
+
+// Svaki podsistem snima svoje komande, a RenderQueue ih sortira i izvršava u jednom prolazu
+CommandList mapHudCommands, routeCommands, textCommands;
+RenderQueue renderQueue;
+unsigned int mapTexture; // 0 ako je mapa veća od GL_MAX_TEXTURE_SIZE (tada samo virtuelna tekstura)
+VirtualTexture* virtualMap = nullptr; // Mapa kao kes stranica koje se vide
+MapSource* mapSource = nullptr; // PNG u memoriji, ili MBTiles/GeoTIFF iz argumenata (čita se po pločicama)
+bool useVirtualMap = false; // F9
 unsigned int walkIconTexture, measureIconTexture, centerIconTexture, textBgTexture, potpisTexture;
 
+// Ponovno učitavanje šejdera kada se fajl izmeni (bez restarta)
+ShaderReloader shaderReloader;
+
+// Nit događaja (GLFW) obrađuje ulaz i menja stanje, a render nit (vlasnik GL konteksta) crta.
+// Posle svakog koraka nit događaja upiše stanje potrebno za crtanje u svoju kopiju i objavi
+// je (trostruki bafer); render nit na početku frejma uzme najnoviju. Akcije koje zovu GL
+// (izvoz, filteri, benchmark) su brojači: render nit izvrši razliku od poslednjeg viđenog,
+// pa se pritisak tastera ne gubi ni kada render nit preskoči međukopije.
+struct RenderRequests {
+    unsigned int exportToggles;     // P
+    unsigned int mapFilterSteps;    // F5
+    unsigned int lodBiasSteps;      // F6
+    unsigned int samplerBenchmarks; // F8
+};
+
+struct FrameSnapshot {
+    Mode mode;
+    Camera camera;                  // Aktivna kamera (hodanje ili merenje)
+    double distance;                // Pređena u hodanju ili ukupna dužina aktivne rute
+    float walkVelocityX, walkVelocityY; // Map space u sekundi, za prefetch stranica mape
+    int framebufferWidth, framebufferHeight;
+    bool useVirtualMap;
+    RouteSnapshotPtr routes;        // Objavljena verzija ruta (bez brava)
+    RenderRequests requests;
+};
+
+TripleBuffer<FrameSnapshot> snapshots;
+RenderRequests renderRequests = {}; // Nit događaja povećava
+std::atomic<bool> renderRunning(false);
+const double UPDATE_RATE = 250.0; // Najmanje koraka niti događaja u sekundi (kretanje, kamera)
+
 // Funkcija za konverziju screen koordinata u NDC
 Point screenToNDC(double xpos, double ypos) {
     float x = (xpos / windowedWidth) * 2.0f - 1.0f;
@@ -110,18 +183,12 @@ Point screenToNDC(double xpos, double ypos) {
 }
 
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
-
+    // Viewport postavlja render nit kada vidi novu veličinu u kopiji stanja
     // AŽURIRAJ NOVE globalne vrijednosti
     windowedWidth = width;
     windowedHeight = height;
 }
 
-// Funkcija za računanje distance
-float calculateDistance(Point p1, Point p2) {
-    return sqrt((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
-}
-
 // Callback za klik miša
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
@@ -149,55 +216,240 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
 
         if (currentMode == MEASURING) {
 
-            int clickedIndex = -1;
-            for (int i = 0; i < measurePoints.size(); i++) {
-                // Pretvaramo map space u NDC radi poređenja
-                Point mpNDC;
-                mpNDC.x = measurePoints[i].x * 2.0f - 1.0f;
-                mpNDC.y = measurePoints[i].y * 2.0f - 1.0f;
-
-                if (calculateDistance(mpNDC, clickPos) < POINT_RADIUS) {
-                    clickedIndex = i;
-                    break;
-                }
-            }
+            // Sve tačke aktivne rute kroz kameru u NDC odjednom, pa najbliža tački klika
+            const RouteStore& route = routes.Store(activeRoute);
+            size_t count = route.Size();
+            hitX.resize(count);
+            hitY.resize(count);
+            float view[16];
+            measureCamera.GetViewMatrix(view);
+            geometryKernels.transform(route.X(), route.Y(), count, view[0], view[5], view[12], view[13],
+                hitX.data(), hitY.data());
+
+            float nearestSq = 0.0f;
+            int clickedIndex = geometryKernels.nearestPoint(hitX.data(), hitY.data(), count, clickPos.x, clickPos.y, &nearestSq);
+            if (clickedIndex != -1 && nearestSq >= POINT_RADIUS * POINT_RADIUS)
+                clickedIndex = -1;
 
             if (clickedIndex != -1) {
                 // Brisanje tačke
-                measurePoints.erase(measurePoints.begin() + clickedIndex);
+                routes.Erase(activeRoute, clickedIndex, distanceEngine);
+                routeJournal.Record(RouteJournal::Op::Erase, (uint32_t)clickedIndex);
             }
             else {
-                // Dodavanje nove tačke – konverzija NDC -> map space [0,1]
+                // Dodavanje nove tačke – konverzija NDC -> map space [0,1] kroz kameru
                 Point mapSpace;
-                mapSpace.x = (clickPos.x + 1.0f) / 2.0f;
-                mapSpace.y = (clickPos.y + 1.0f) / 2.0f;
-                measurePoints.push_back(mapSpace);
+                measureCamera.NDCToMap(clickPos.x, clickPos.y, mapSpace.x, mapSpace.y);
+                routes.Append(activeRoute, mapSpace, distanceEngine);
+                routeJournal.Record(RouteJournal::Op::Append, 0, mapSpace.x, mapSpace.y);
             }
+        }
+    }
 
-            // Rekonstrukcija linija
-            measureLines.clear();
-            totalMeasureDistance = 0.0f;
-            for (int i = 0; i < measurePoints.size() - 1; i++) {
-                Line line;
-                line.start = measurePoints[i];
-                line.end = measurePoints[i + 1];
-                line.distance = calculateDistance(line.start, line.end) * 1000.0f;
-                measureLines.push_back(line);
-                totalMeasureDistance += line.distance;
-            }
+    // Desni taster prevlači mapu u režimu merenja
+    if (button == GLFW_MOUSE_BUTTON_RIGHT) {
+        isPanning = (action == GLFW_PRESS && currentMode == MEASURING);
+        glfwGetCursorPos(window, &lastCursorX, &lastCursorY);
+    }
+}
+
+// Točkić miša - zoom oko kursora u režimu merenja
+void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
+    if (currentMode != MEASURING) return;
+
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+    Point cursor = screenToNDC(xpos, ypos);
+    measureCamera.ZoomAt(cursor.x, cursor.y, powf(ZOOM_STEP, (float)yoffset));
+}
+
+void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
+    if (!isPanning) return;
+
+    Point current = screenToNDC(xpos, ypos);
+    Point last = screenToNDC(lastCursorX, lastCursorY);
+    measureCamera.Pan(current.x - last.x, current.y - last.y);
+    lastCursorX = xpos;
+    lastCursorY = ypos;
+}
+
+
+
+
+
+// Uvoz snimljenih staza (GPX/GeoJSON, prevlačenje fajla na prozor ili argument komandne linije):
+// čitanje i parsiranje u map space je posao na radnoj niti, a kada se završi, nit događaja
+// (koja menja rute) od svake staze napravi novu rutu, sa dužinama i LOD-om paralelno po stazama.
+// Prozor ne stoji dok se veliki fajl parsira; aktivna ruta (za klikove) ostaje ista.
+struct PendingImport {
+    std::string path;
+    RouteImporter importer;
+    ImportedTracks tracks;
+    RouteImportStats stats;
+    bool ok;
+    JobSystem::JobHandle job;
+};
+std::vector<std::shared_ptr<PendingImport>> pendingImports; // Nit događaja
+
+void importRouteFile(const char* path) {
+    if (mapScaleApproximate)
+        std::cout << "Uvoz " << path << ": mapa nije kalibrisana, polozaj rute je priblizan" << std::endl;
+    std::shared_ptr<PendingImport> work = std::make_shared<PendingImport>();
+    work->path = path;
+    work->ok = false;
+    GeoReference reference = distanceEngine.Reference();
+    work->job = jobSystem.Submit([work, reference] {
+        work->ok = work->importer.Import(work->path.c_str(), reference, work->tracks, work->stats);
+    });
+    pendingImports.push_back(work);
+}
+
+void applyFinishedImports() {
+    for (size_t i = 0; i < pendingImports.size();) {
+        std::shared_ptr<PendingImport> work = pendingImports[i];
+        if (!jobSystem.IsDone(work->job)) {
+            i++;
+            continue;
         }
+        pendingImports.erase(pendingImports.begin() + i);
+        if (!work->ok) continue;
+
+        double start = glfwGetTime();
+        routes.AddTracks(work->tracks, distanceEngine);
+        double distanceSeconds = glfwGetTime() - start;
+
+        const RouteImportStats& stats = work->stats;
+        std::cout << std::fixed << std::setprecision(2)
+            << "Uvoz " << work->path << ": " << stats.points << " tacaka, " << stats.tracks << " staza, "
+            << stats.bytes / (1024.0 * 1024.0) << " MB | parsiranje " << stats.seconds << " s ("
+            << std::setprecision(0) << stats.PointsPerSecond() << " tacaka/s)"
+            << std::setprecision(2) << " | duzine " << distanceSeconds * 1000.0 << " ms" << std::endl;
+        currentMode = MEASURING;
     }
 }
 
+JobSystem::JobHandle benchmarkJob; // Nit događaja; F7/F10/F12 jedan po jedan
 
+void runBenchmark(const char* name, JobSystem::Function benchmark) {
+    // Na radnoj niti: merenje traje sekundama, a na niti događaja bi zaledilo ulaz i prozor
+    if (!jobSystem.IsDone(benchmarkJob)) {
+        std::cout << name << ": prethodni benchmark jos radi" << std::endl;
+        return;
+    }
+    benchmarkJob = jobSystem.Submit(std::move(benchmark));
+}
 
+// Sve rute sa tačkama u binarni fajl sesije (atomično - prekid ne ostavlja pola fajla),
+// pa dnevnik kreće iznova od aktivne rute (njen indeks u fajlu, ako ima tačaka).
+// Čita objavljenu verziju ruta, kao render nit i izvoz
+void saveSession() {
+    routes.Publish();
+    RouteSnapshotPtr snapshot = routes.Snapshot();
+    routeFile.Begin();
+    uint32_t savedRoutes = 0, activeIndex = RouteJournal::NO_ROUTE;
+    for (int id = 0; id < snapshot->Count(); id++) {
+        const RouteData* route = snapshot->Route(id);
+        if (!route || route->store.Empty()) continue;
+        const RouteStore& store = route->store;
+        if (id == activeRoute) activeIndex = savedRoutes;
+        routeFile.AddRoute(store.X(), store.Y(), store.Size());
+        savedRoutes++;
+    }
+    RouteFileStats stats;
+    if (routeFile.Write(ROUTE_SESSION_PATH, stats)) {
+        routeJournal.Reset(activeIndex);
+        std::cout << std::fixed << std::setprecision(2) << "Sesija snimljena: " << stats.routes << " ruta, "
+            << stats.points << " tacaka, " << stats.bytes << " B za " << stats.milliseconds << " ms" << std::endl;
+    }
+}
+
+// Rute iz prethodne sesije (ako fajl postoji); dužine se računaju paketno kao pri uvozu
+void loadSession() {
+    RouteFileStats stats;
+    if (!RouteFile::Load(ROUTE_SESSION_PATH, importedTracks, stats)) return;
 
+    routes.AddTracks(importedTracks, distanceEngine);
+    std::cout << std::fixed << std::setprecision(2) << "Sesija ucitana: " << stats.routes << " ruta, "
+        << stats.points << " tacaka za " << stats.milliseconds << " ms" << std::endl;
+}
+
+// Izmene iz dnevnika posle učitane sesije (rute iz sesije imaju id = indeks u fajlu)
+void replayJournal() {
+    std::vector<RouteJournal::Entry> entries;
+    if (!RouteJournal::Read(ROUTE_JOURNAL_PATH, entries)) return;
+
+    size_t replayed = 0;
+    for (const RouteJournal::Entry& entry : entries) {
+        switch (entry.op) {
+        case RouteJournal::Op::Resume:
+            activeRoute = routes.IsAlive((int)entry.arg) ? (int)entry.arg : -1;
+            continue;
+        case RouteJournal::Op::NewRoute:
+            activeRoute = routes.Create();
+            break;
+        case RouteJournal::Op::Append:
+            if (activeRoute < 0) activeRoute = routes.Create();
+            routes.Append(activeRoute, Point(entry.x, entry.y), distanceEngine);
+            break;
+        case RouteJournal::Op::Erase:
+            if (activeRoute < 0 || entry.arg >= routes.Store(activeRoute).Size()) continue;
+            routes.Erase(activeRoute, entry.arg, distanceEngine);
+            break;
+        default:
+            continue;
+        }
+        replayed++;
+    }
+    if (replayed > 0) std::cout << "Dnevnik: ponovljeno " << replayed << " izmena posle poslednjeg snimanja" << std::endl;
+}
+
+void dropCallback(GLFWwindow* window, int count, const char** paths) {
+    for (int i = 0; i < count; i++) importRouteFile(paths[i]);
+}
 
 // Callback za tastaturu
 void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (key == GLFW_KEY_R && action == GLFW_PRESS) {
         currentMode = (currentMode == WALKING) ? MEASURING : WALKING;
     }
+    if (key == GLFW_KEY_N && action == GLFW_PRESS && currentMode == MEASURING &&
+        !routes.Store(activeRoute).Empty()) {
+        activeRoute = routes.Create(); // Trenutna ruta ostaje iscrtana, klikovi idu u novu
+        routeJournal.Record(RouteJournal::Op::NewRoute);
+    }
+    if (key == GLFW_KEY_S && action == GLFW_PRESS && (mods & GLFW_MOD_CONTROL)) {
+        saveSession();
+    }
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        renderRequests.exportToggles++; // Počinje (ili prekida) ga render nit, sa kamerom iz kopije stanja
+    }
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        profilingEnabled = !profilingEnabled;
+        if (!profilingEnabled) glfwSetWindowTitle(window, windowTitle.c_str());
+    }
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS) {
+        renderRequests.mapFilterSteps++;
+    }
+    if (key == GLFW_KEY_F6 && action == GLFW_PRESS) {
+        renderRequests.lodBiasSteps++;
+    }
+    if (key == GLFW_KEY_F7 && action == GLFW_PRESS) {
+        // stb_image naspram paralelnog dekodera (privremeni fajlovi)
+        runBenchmark("Decode benchmark", [] { benchmarkImageDecode("Resources/novi-sad-map-0.png"); });
+    }
+    if (key == GLFW_KEY_F8 && action == GLFW_PRESS) {
+        renderRequests.samplerBenchmarks++; // Izvršava se na početku sledećeg frejma
+    }
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS && mapTexture != 0) {
+        useVirtualMap = !useVirtualMap; // Render nit ispisuje promenu
+    }
+    if (key == GLFW_KEY_F10 && action == GLFW_PRESS) {
+        runBenchmark("Geometry benchmark", benchmarkGeometryKernels); // Samo CPU, ne dira GL stanje
+    }
+    if (key == GLFW_KEY_F12 && action == GLFW_PRESS) {
+        // Binarni format ruta naspram teksta (privremeni fajlovi u radnom direktorijumu)
+        runBenchmark("Route file benchmark", benchmarkRouteFile);
+    }
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
 
         if (isFullscreen) {
@@ -209,29 +461,6 @@ void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
     }
 }
 
-// Inicijalizacija mape
-void initMap() {
-    float mapVertices[] = {
-        // Pozicije      // Texture coords
-        -1.0f, -1.0f,    0.0f, 0.0f,
-         1.0f, -1.0f,    1.0f, 0.0f,
-         1.0f,  1.0f,    1.0f, 1.0f,
-        -1.0f,  1.0f,    0.0f, 1.0f
-    };
-
-    glGenVertexArrays(1, &mapVAO);
-    glGenBuffers(1, &mapVBO);
-
-    glBindVertexArray(mapVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, mapVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(mapVertices), mapVertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-}
-
 // Inicijalizacija pina
 void initPin() {
     std::vector<float> pinVertices;
@@ -261,100 +490,304 @@ void initPin() {
     glEnableVertexAttribArray(0);
 }
 
-// Inicijalizacija ikona
-void initIcons() {
-    float iconVertices[] = {
-        //  aPos(x,y)       aTexCoord(u,v)
-        -0.5f, -0.5f,       0.0f, 0.0f,
-         0.5f, -0.5f,       1.0f, 0.0f,
-         0.5f,  0.5f,       1.0f, 1.0f,
-        -0.5f,  0.5f,       0.0f, 1.0f
-    };
+// Mapa i HUD (ikona režima, pin u centru, potpis, pozadina za tekst)
+void recordMapAndHud(CommandList& list, const FrameSnapshot& frame) {
+    // Jedina promena po frejmu za mapu i rutu: matrica pogleda aktivne kamere
+    float view[16];
+    frame.camera.GetViewMatrix(view);
+    list.Upload(GL_UNIFORM_BUFFER, viewUBO, view, sizeof(view));
+
+    spriteRenderer->Begin();
+    spriteRenderer->AddMap(frame.useVirtualMap ? virtualMap->CacheTexture() : mapTexture);
+    if (frame.mode == WALKING)
+        spriteRenderer->Add(centerIconTexture, 0.0f, 0.0f, 0.15f); // Pin u centru ekrana
+
+    // Ikona režima u gornjem desnom uglu
+    spriteRenderer->Add(frame.mode == WALKING ? walkIconTexture : measureIconTexture, 0.78f, 0.78f, 0.3f);
+    // Potpis u donjem desnom uglu
+    spriteRenderer->Add(potpisTexture, 0.80f, -0.75f, 0.3f, potpisAlpha);
+    // Pozadina za tekst u gornjem levom uglu
+    spriteRenderer->Add(textBgTexture, -0.735f, 0.735f, 0.4f);
+
+    spriteRenderer->Record(list, spriteShader, frame.useVirtualMap ? virtualMapShader : 0);
+}
+
+// Linije i tačke svih ruta - jedan poziv za linije i jedan za tačke (multi-draw), na nivou detalja
+// koji odgovara zoom-u. Rute van pogleda se preskaču; zoom/pan menja samo uView.
+void recordRoute(CommandList& list, const FrameSnapshot& frame) {
+    if (frame.mode != MEASURING) return;
+    routeRenderer.Record(list, *frame.routes, colorShader, pointShader, frame.camera, frame.framebufferWidth);
+}
 
-    glGenVertexArrays(1, &iconVAO);
-    glGenBuffers(1, &iconVBO);
+// Distanca (pređena u hodanju ili ukupna izmerena) na pozadini za tekst
+void recordText(CommandList& list, const FrameSnapshot& frame) {
+    int displayNumber = static_cast<int>(frame.distance); // samo ceo broj, bez decimala
+    const char* text = frameArena.Format(nullptr, "%d", displayNumber); // Bez heap-a, važi do kraja frejma
+    bitmapFont->RecordText(list, text, 75.0f, 95.0f, 0.7f, 0.0f, 0.0f, 0.0f);
+}
 
-    glBindVertexArray(iconVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, iconVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(iconVertices), iconVertices, GL_STATIC_DRAW);
+// Jedna pločica izvoza: mapa i rute kroz kameru pločice, bez HUD-a i teksta
+void renderExportTile(const Camera& camera, int pixels, RouteRenderer& exportRenderer, const RouteSnapshot& exportRoutes) {
+    exportCommands.Clear();
+    float view[16];
+    camera.GetViewMatrix(view);
+    exportCommands.Upload(GL_UNIFORM_BUFFER, viewUBO, view, sizeof(view));
+
+    bool useVirtual = snapshots.Read().useVirtualMap; // Render nit čita svoju kopiju stanja
+    spriteRenderer->Begin();
+    spriteRenderer->AddMap(useVirtual ? virtualMap->CacheTexture() : mapTexture);
+    spriteRenderer->Record(exportCommands, spriteShader, useVirtual ? virtualMapShader : 0);
+    exportRenderer.Record(exportCommands, exportRoutes, colorShader, pointShader, camera, pixels);
+
+    if (useVirtual) virtualMap->Bind();
+    renderQueue.Submit(exportCommands);
+}
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+// Poredi cenu popunjavanja (fill rate) svake konfiguracije samplera mape: mapa se iscrta
+// SAMPLER_BENCH_OVERDRAW puta jedna preko druge (jedan instancirani poziv), a GPU vreme meri
+// GL_TIME_ELAPSED upit. Dva pogleda: cela mapa (malo umanjenje) i udaljena (~5x umanjenje).
+void runSamplerBenchmark(int viewportWidth, int viewportHeight) {
+    if (mapTexture == 0) {
+        std::cout << "Sampler benchmark: mapa je samo virtuelna tekstura" << std::endl;
+        return;
+    }
+    const int SAMPLER_BENCH_OVERDRAW = 32;
+    const int SAMPLER_BENCH_REPEATS = 5;
+    const float views[] = { 1.0f, 3.0f };
+
+    MapFilter savedFilter = samplers.GetMapFilter();
+    int savedBias = samplers.GetLodBiasIndex();
+
+    unsigned int query;
+    glGenQueries(1, &query);
+    CommandList list;
+    Camera benchCamera;
+
+    std::cout << "--- Sampler benchmark (" << SAMPLER_BENCH_OVERDRAW << "x mapa, " << viewportWidth << "x" << viewportHeight << ") ---" << std::endl;
+    for (float zoom : views) {
+        benchCamera.Set(0.5f, 0.5f, zoom);
+        float view[16];
+        benchCamera.GetViewMatrix(view);
+        // Deo ekrana koji mapa pokriva
+        double pixels = (double)viewportWidth * viewportHeight / (zoom * zoom) * SAMPLER_BENCH_OVERDRAW;
+
+        for (int config = 0; config < (int)MapFilter::Count + Samplers::LOD_BIAS_COUNT - 1; config++) {
+            // Prvo sve konfiguracije filtriranja (bias 0), pa trilinearno sa ostalim bias-ima
+            MapFilter filter = config < (int)MapFilter::Count ? (MapFilter)config : MapFilter::Trilinear;
+            int bias = config < (int)MapFilter::Count ? 0 : config - (int)MapFilter::Count + 1;
+            samplers.SetMapFilter(filter);
+            samplers.SetLodBiasIndex(bias);
+
+            list.Clear();
+            list.Upload(GL_UNIFORM_BUFFER, viewUBO, view, sizeof(view));
+            spriteRenderer->Begin();
+            for (int i = 0; i < SAMPLER_BENCH_OVERDRAW; i++)
+                spriteRenderer->AddMap(mapTexture);
+            spriteRenderer->Record(list, spriteShader);
+
+            renderQueue.Submit(list); // Zagrevanje
+            glFinish();
+
+            GLuint64 best = ~(GLuint64)0;
+            for (int r = 0; r < SAMPLER_BENCH_REPEATS; r++) {
+                glBeginQuery(GL_TIME_ELAPSED, query);
+                renderQueue.Submit(list);
+                glEndQuery(GL_TIME_ELAPSED);
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+                if (ns < best) best = ns;
+            }
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+            std::cout << std::fixed << std::setprecision(3)
+                << "zoom " << zoom << " | " << Samplers::FilterName(filter)
+                << " | bias " << samplers.GetLodBias()
+                << " | " << best / 1.0e6 << " ms"
+                << " | " << pixels / (best / 1.0e9) / 1.0e6 << " Mpix/s" << std::endl;
+        }
+    }
+
+    glDeleteQueries(1, &query);
+    samplers.SetMapFilter(savedFilter);
+    samplers.SetLodBiasIndex(savedBias);
+    glClear(GL_COLOR_BUFFER_BIT);
 }
 
 
-// Iscrtavanje linija
-void drawLines() {
-    if (measureLines.empty()) return;
+// Stanje potrebno za crtanje u kopiju koju render nit uzima (nit događaja)
+void publishSnapshot(float walkVelocityX, float walkVelocityY) {
+    FrameSnapshot& frame = snapshots.Write();
+    frame.mode = currentMode;
+    frame.camera = (currentMode == WALKING) ? walkCamera : measureCamera;
+    frame.distance = (currentMode == WALKING) ? walkingDistance : routes.Store(activeRoute).TotalLength();
+    frame.walkVelocityX = walkVelocityX;
+    frame.walkVelocityY = walkVelocityY;
+    frame.framebufferWidth = windowedWidth;
+    frame.framebufferHeight = windowedHeight;
+    frame.useVirtualMap = useVirtualMap;
+    routes.Publish(); // Izmene ruta od prethodnog koraka (nova verzija samo ako ih ima)
+    frame.routes = routes.Snapshot();
+    frame.requests = renderRequests;
+    snapshots.Publish();
+}
+
+// Jedan korak niti događaja: gotovi uvozi, kretanje i kamera za proteklih dt sekundi
+void update(float dt) {
+    applyFinishedImports();
 
-    glUseProgram(colorShader);
+    float walkVelocityX = 0.0f, walkVelocityY = 0.0f;
+    if (currentMode == WALKING) {
+        // Obrada inputa za kretanje
+        Point lastMapOffset = mapOffset;
+        float step = WALK_SPEED * dt;
 
-    for (const auto& line : measureLines) {
-        // Konvertuj iz map space [0,1] u NDC [-1,1]
-        float startX = line.start.x * 2.0f - 1.0f;
-        float startY = line.start.y * 2.0f - 1.0f;
-        float endX = line.end.x * 2.0f - 1.0f;
-        float endY = line.end.y * 2.0f - 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+            mapOffset.y += step;  // Gore
+        }
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+            mapOffset.y -= step;  // Dole (BILO JE -, TREBA +)
+        }
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+            mapOffset.x -= step;  // Levo
+        }
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+            mapOffset.x += step;  // Desno
+        }
 
-        float lineVertices[] = {
-            startX, startY,
-            endX,   endY
-        };
+        // Ograniči kretanje na granicu mape
+        mapOffset.x = fmax(-0.5f + MAP_ZOOM, fmin(0.5f - MAP_ZOOM, mapOffset.x));
+        mapOffset.y = fmax(-0.5f + MAP_ZOOM, fmin(0.5f - MAP_ZOOM, mapOffset.y));
 
-        glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(lineVertices), lineVertices, GL_DYNAMIC_DRAW);
+        // Ažuriraj pređenu distancu
+        // Pretvori mapOffset u map space (isto kao measuring mode)
+        Point lastGlobal(lastMapOffset.x + 0.5f, lastMapOffset.y + 0.5f);
+        Point currentGlobal(mapOffset.x + 0.5f, mapOffset.y + 0.5f);
+        walkingDistance += distanceEngine.Distance(lastGlobal, currentGlobal);
 
-        glBindVertexArray(lineVAO);
-        unsigned int colorLoc = glGetUniformLocation(colorShader, "uColor");
-        glUniform4f(colorLoc, 0.0f, 0.0f, 0.0f, 1.0f); // Crna linija
+        // Isti isečak mape kao ranije: centar (0.5 + mapOffset), vidi se MAP_ZOOM mape
+        walkCamera.Set(0.5f + mapOffset.x, 0.5f + mapOffset.y, MAP_ZOOM);
 
-        glLineWidth(2.0f);
-        glDrawArrays(GL_LINES, 0, 2);
+        // Brzina (map space u sekundi) za prefetch stranica mape u pravcu kretanja
+        if (dt > 0.0f) {
+            walkVelocityX = (mapOffset.x - lastMapOffset.x) / dt;
+            walkVelocityY = (mapOffset.y - lastMapOffset.y) / dt;
+        }
+    }
+    else {
+        measureCamera.Update(dt);
     }
-}
-
 
-// Iscrtavanje tačaka
-void drawPoints() {
-    if (measurePoints.empty()) return;
+    publishSnapshot(walkVelocityX, walkVelocityY);
+}
 
-    glUseProgram(colorShader);
+// Akcije sa tastature koje zovu GL, od poslednjeg frejma (render nit)
+void handleRenderRequests(const FrameSnapshot& frame, RenderRequests& handled) {
+    if (handled.samplerBenchmarks != frame.requests.samplerBenchmarks) {
+        runSamplerBenchmark(frame.framebufferWidth, frame.framebufferHeight);
+        handled.samplerBenchmarks = frame.requests.samplerBenchmarks;
+    }
+    for (; handled.mapFilterSteps != frame.requests.mapFilterSteps; handled.mapFilterSteps++)
+        samplers.NextMapFilter();
+    for (; handled.lodBiasSteps != frame.requests.lodBiasSteps; handled.lodBiasSteps++)
+        samplers.NextLodBias();
+    for (; handled.exportToggles != frame.requests.exportToggles; handled.exportToggles++) {
+        if (mapExport.IsActive()) mapExport.Cancel();
+        else mapExport.Start("export.png", EXPORT_SIZE, frame.camera, frame.routes); // Sve pločice iste rute
+    }
+}
 
-    for (const auto& point : measurePoints) {
-        std::vector<float> circleVertices;
-        float radius = 0.01f;
+// Render nit: od pokretanja do kraja je vlasnik GL konteksta i crta najnoviju kopiju stanja,
+// pa spor frejm ne zadržava obradu ulaza (i obrnuto)
+void renderLoop() {
+    glfwMakeContextCurrent(window);
+    jobSystem.SetMainThread(); // GL poslovi iz JobSystem-a se izvršavaju ovde
 
-        // Konvertuj map space [0,1] -> NDC [-1,1]
-        float ndcX = point.x * 2.0f - 1.0f;
-        float ndcY = point.y * 2.0f - 1.0f;
+    RenderRequests handled = {};
+    int viewportWidth = 0, viewportHeight = 0;
+    snapshots.Update();
+    bool virtualMapShown = snapshots.Read().useVirtualMap;
 
-        // Centar kruga
-        circleVertices.push_back(ndcX);
-        circleVertices.push_back(ndcY);
+    while (renderRunning) {
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        snapshots.Update();
+        const FrameSnapshot& frame = snapshots.Read();
+        beginFrameStats();
+        uint64_t heapAtStart = threadHeapAllocations();
+        streamBuffer.BeginFrame();
+
+        if (frame.framebufferWidth != viewportWidth || frame.framebufferHeight != viewportHeight) {
+            viewportWidth = frame.framebufferWidth;
+            viewportHeight = frame.framebufferHeight;
+            glViewport(0, 0, viewportWidth, viewportHeight);
+        }
+        glClear(GL_COLOR_BUFFER_BIT);
 
-        // Generisanje kruga oko centra
-        for (int i = 0; i <= CIRCLE_SEGMENTS; i++) {
-            float angle = i * 2.0f * 3.14159f / CIRCLE_SEGMENTS;
-            circleVertices.push_back(cos(angle) * radius + ndcX);
-            circleVertices.push_back(sin(angle) * radius + ndcY);
+        handleRenderRequests(frame, handled);
+        if (frame.useVirtualMap != virtualMapShown) {
+            virtualMapShown = frame.useVirtualMap;
+            std::cout << "Virtuelna tekstura mape: " << (virtualMapShown ? "ukljucena" : "iskljucena")
+                << " (stranica u kesu: " << virtualMap->ResidentPages() << ")" << std::endl;
         }
 
-        glBindBuffer(GL_ARRAY_BUFFER, pointVBO);
-        glBufferData(GL_ARRAY_BUFFER, circleVertices.size() * sizeof(float), circleVertices.data(), GL_DYNAMIC_DRAW);
+        // Zameni šejdere koji su u međuvremenu ponovo kompajlirani
+        if (shaderReloader.Update()) {
+            bitmapFont->SetShader(fontShader);
+            renderQueue.InvalidatePrograms();
+        }
 
-        glBindVertexArray(pointVAO);
-        unsigned int colorLoc = glGetUniformLocation(colorShader, "uColor");
-        glUniform4f(colorLoc, 0.0f, 0.0f, 0.0f, 1.0f); // Bela tačka
+        // Poslovi sa radnih niti koji moraju na GL nit
+        jobSystem.RunMainThreadJobs(MAIN_THREAD_JOB_BUDGET_MS);
+
+        // Stranice mape u pravcu kretanja se traže unapred
+        if (frame.useVirtualMap && frame.mode == WALKING)
+            virtualMap->Prefetch(frame.camera.centerX, frame.camera.centerY, frame.camera.zoom,
+                frame.walkVelocityX, frame.walkVelocityY, frame.framebufferWidth);
+
+        // Snimi komande po podsistemima (ne dira GL), pa ih izvrši u jednom sortiranom prolazu
+        mapHudCommands.Clear();
+        routeCommands.Clear();
+        textCommands.Clear();
+        recordMapAndHud(mapHudCommands, frame);
+        recordRoute(routeCommands, frame);
+        recordText(textCommands, frame);
+        if (frame.useVirtualMap) virtualMap->Bind();
+        renderQueue.Submit({ &mapHudCommands, &routeCommands, &textCommands });
+
+        // Feedback za sledeći frejm: koje stranice mape su se videle (isti uView)
+        if (frame.useVirtualMap)
+            virtualMap->Update(feedbackShader, frame.framebufferWidth, frame.framebufferHeight);
+
+        // Izvoz napreduje nekoliko pločica po frejmu (posle ekrana, pa uView ostaje njegov tek do sledećeg frejma)
+        if (mapExport.IsActive())
+            mapExport.Update(renderExportTile, frame.framebufferWidth, frame.framebufferHeight);
+
+        streamBuffer.EndFrame();
+        jobSystem.UpdateFrameStats();
+        frameStats.journalRecordMaxUs = routeJournal.TakeFrameRecordMicros();
+        // Privremeni podaci frejma (tekst, verteksi, upisi u bafere) su u arenama; u stabilnom
+        // stanju frejm ne ide na heap
+        frameStats.arenaBytes = (unsigned int)(frameArena.FrameBytes() + mapHudCommands.arena.FrameBytes() +
+            routeCommands.arena.FrameBytes() + textCommands.arena.FrameBytes());
+        frameArena.Reset(); // Spajanje blokova ide na heap, pa se broji u ovom frejmu
+        frameStats.heapAllocations = (unsigned int)(threadHeapAllocations() - heapAtStart);
+        endFrameStats();
+        glfwSwapBuffers(window);
 
-        glDrawArrays(GL_TRIANGLE_FAN, 0, CIRCLE_SEGMENTS + 2);
+        // --- frame limiter ---
+        auto frameEnd = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<float> frameDuration = frameEnd - frameStart;
+        float frameTime = 1.0f / 75.0f; // 75 FPS
+        if (frameDuration.count() < frameTime) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<float>(frameTime - frameDuration.count())
+            );
+        }
     }
+
+    glfwMakeContextCurrent(NULL);
 }
 
 
-int main() {
+int main(int argc, char** argv) {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -367,302 +800,196 @@ int main() {
     glfwMakeContextCurrent(window);
     if (glewInit() != GLEW_OK) return endProgram("GLEW nije uspeo da se inicijalizuje.");
 
+    initGeometryKernels(); // Skalarno / SSE2 / AVX2 prema procesoru
+    jobSystem.Start(); // Radne niti za dekodiranje, stranice mape, uvoz i geometriju ruta
+
+    // Pošalji šejdere na kompajliranje odmah nakon kreiranja konteksta - drajver ih
+    // kompajlira paralelno dok mi učitavamo kursor i teksture (status se čita tek u finishShaders)
+    initParallelShaderCompile();
+    spriteShader = submitShader("Shaders/sprite.vert", "Shaders/sprite.frag");
+    colorShader = submitShader("Shaders/color.vert", "Shaders/color.frag");
+    pointShader = submitShader("Shaders/point.vert", "Shaders/point.frag");
+    fontShader = submitShader("Shaders/font.vert", "Shaders/font.frag");
+    virtualMapShader = submitShader("Shaders/sprite.vert", "Shaders/map.frag");
+    feedbackShader = submitShader("Shaders/feedback.vert", "Shaders/feedback.frag");
+
     // Callbacks
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetKeyCallback(window, keyCallback);
+    glfwSetScrollCallback(window, scrollCallback);
+    glfwSetCursorPosCallback(window, cursorPosCallback);
+    glfwSetDropCallback(window, dropCallback);
 
     // Učitaj kursor kompasa
     GLFWcursor* compassCursor = loadImageToCursor("Resources/compass.png");
     if (compassCursor) glfwSetCursor(window, compassCursor);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glState.SetBlend(true);
+    glState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Izvor mape: baza pločica ili GeoTIFF iz argumenata (npr. Kostur.exe grad.mbtiles),
+    // inače PNG iz Resources. Pločice se čitaju tek kada ih virtuelna tekstura zatraži.
+    for (int i = 1; i < argc && !mapSource; i++)
+        if (isMapSourcePath(argv[i])) mapSource = openMapSource(argv[i]);
+
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    if (!mapSource) {
+        // Učitaj teksture
+        int mapWidth, mapHeight;
+        unsigned char* mapPixels = loadImagePixels("Resources/novi-sad-map-0.png", &mapWidth, &mapHeight);
+        if (mapPixels == NULL) {
+            std::cout << "GRESKA: Mapa nije ucitana!" << std::endl;
+            return -1;  // Zaustavi program da vidiš grešku
+        }
+        mapSource = new ImageMapSource(mapPixels, mapWidth, mapHeight);
+        // Obična tekstura samo ako mapa staje u jednu
+        if (mapWidth <= maxTextureSize && mapHeight <= maxTextureSize)
+            mapTexture = createTextureRGBA(mapPixels, mapWidth, mapHeight, true);
+        freeImagePixels(mapPixels);
+    }
+    if (mapTexture == 0) useVirtualMap = true;
+    // Georeferenca: ivice iz izvora (MBTiles/GeoTIFF), inače dve kontrolne tačke iz fajla pored PNG mape
+    double south, west, north, east;
+    if (mapSource->GeoBounds(south, west, north, east)) // Rastojanja u metrima prate izvor
+        distanceEngine.Reference().SetBounds(south, west, north, east);
+    else if (!distanceEngine.Reference().LoadControlPoints(MAP_CONTROL_POINTS_PATH)) {
+        distanceEngine.Reference().SetCenter(APPROX_MAP_LAT, APPROX_MAP_LON, APPROX_MAP_WIDTH_METERS,
+            (double)mapSource->Width() / mapSource->Height());
+        mapScaleApproximate = true;
+        windowTitle += " - NEKALIBRISANA SKALA (~1 km po sirini)";
+        glfwSetWindowTitle(window, windowTitle.c_str());
+        std::cout << "UPOZORENJE: mapa nema georeferencu (" << MAP_CONTROL_POINTS_PATH << ": dva reda \"x y lat lon\"); "
+            << "rastojanja su priblizna, a uvezene rute mogu biti pomerene" << std::endl;
+    }
 
-    // Kreiraj šejdere
-    mapShader = createShader("Shaders/map.vert", "Shaders/map.frag");
-    colorShader = createShader("Shaders/color.vert", "Shaders/color.frag");
-    iconShader = createShader("Shaders/icon.vert", "Shaders/icon.frag");    
-    fontShader = createShader("Shaders/font.vert", "Shaders/font.frag");
-    // Učitaj teksture
-    mapTexture = loadImageToTexture("Resources/novi-sad-map-0.png");
-    fontTexture = loadImageToTextureRGBA("Resources/font.png");
-    textBgTexture = loadImageToTextureRGBA("Resources/skrol.png");
+    // Virtuelna tekstura uvek postoji (F9)
+    virtualMap = new VirtualTexture();
+    virtualMap->Init(mapSource);
+    std::cout << "mapTexture ID: " << mapTexture << (useVirtualMap ? " (virtuelna tekstura)" : "") << std::endl;
 
-    std::cout << "mapTexture ID: " << mapTexture << std::endl;  // Mora biti > 0
+    // Ikone se dekodiraju paralelno, teksture se prave ovde
+    const char* iconPaths[] = { "Resources/font.png", "Resources/skrol.png", "Resources/walk.png",
+        "Resources/ruler.png", "Resources/centar.png", "Resources/potpis.png" };
+    unsigned iconTextures[6];
+    loadImagesToTexturesRGBA(iconPaths, iconTextures, 6);
+    fontTexture = iconTextures[0];
+    textBgTexture = iconTextures[1];
+    walkIconTexture = iconTextures[2];
+    measureIconTexture = iconTextures[3];
+    centerIconTexture = iconTextures[4];
+    potpisTexture = iconTextures[5];
 
-    if (mapTexture == 0) {
-        std::cout << "GRESKA: Mapa nije ucitana!" << std::endl;
-        return -1;  // Zaustavi program da vidiš grešku
-    }
-    walkIconTexture = loadImageToTextureRGBA("Resources/walk.png");
-    measureIconTexture = loadImageToTextureRGBA("Resources/ruler.png");
-    centerIconTexture = loadImageToTextureRGBA("Resources/centar.png");
-    potpisTexture = loadImageToTextureRGBA("Resources/potpis.png");
+    // Sačekaj da se šejderi završe (do sada su se kompajlirali u pozadini) i ispiši greške
+    finishShaders();
 
 
+    // Prsten za dinamičke vertekse (instance sprite-ova, tekst) - VAO-i ispod pokazuju na njega
+    streamBuffer.Init();
 
     // Inicijalizuj geometriju
-    initMap();
     initPin();
-    initIcons();
+    spriteRenderer = new SpriteRenderer();
+    spriteRenderer->Init();
     
     //DA LI SEOVDJE INICIJALIZUJE FONT???????
     bitmapFont = new BitmapFont();
     bitmapFont->Init(fontTexture, fontShader, 10, 1, '0');
 
-    // Inicijalizuj VAO/VBO za tačke i linije
-    glGenVertexArrays(1, &pointVAO);
-    glGenBuffers(1, &pointVBO);
-    glBindVertexArray(pointVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, pointVBO);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glGenVertexArrays(1, &lineVAO);
-    glGenBuffers(1, &lineVBO);
-    glBindVertexArray(lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    // Zajednički VAO/VBO/EBO ruta - linije (GL_LINE_STRIP) i tačke (GL_POINTS) dele iste podatke
+    routeRenderer.Init();
+    // Sesija, pa izmene iz dnevnika (posle pada); zatim se sve snimi i dnevnik počne iznova
+    // od aktivne rute (ako je poslednja ruta bila nezavršena, nastavlja se)
+    loadSession();
+    activeRoute = -1;
+    replayJournal();
+    if (activeRoute < 0) activeRoute = routes.Create();
+    saveSession(); // Dnevnik se prazni tek kada je sesija (sa ponovljenim izmenama) na disku
+    routeJournal.Start(ROUTE_JOURNAL_PATH);
+    for (int i = 1; i < argc; i++)
+        if (!isMapSourcePath(argv[i])) importRouteFile(argv[i]);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    // Sampler objekti za mapu, ikone i font (filtriranje, wrap, anizotropija, LOD bias)
+    samplers.Init();
+    glLineWidth(2.0f);
+
+    // Uniform bafer pogleda (linije imaju samo aPos, pa je aOffset za njih (0, 0))
+    glGenBuffers(1, &viewUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, viewUBO);
+    glBufferData(GL_UNIFORM_BUFFER, 16 * sizeof(float), NULL, GL_STREAM_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, VIEW_UBO_BINDING, viewUBO);
+    renderQueue.RegisterUniformBlock("ViewParams", VIEW_UBO_BINDING);
+    renderQueue.RegisterUniformBlock("VirtualTextureParams", VirtualTexture::PARAMS_BINDING);
+    renderQueue.RegisterSampler("uIndirection", VirtualTexture::INDIRECTION_UNIT);
+
+    // Inicijalizacija je vezivala objekte direktno (ne kroz glState)
+    glState.Invalidate();
+
+    // Prati izmene šejdera - kompajliraju se na pozadinskoj niti sa deljenim kontekstom
+    shaderReloader.Watch(&spriteShader, "Shaders/sprite.vert", "Shaders/sprite.frag");
+    shaderReloader.Watch(&colorShader, "Shaders/color.vert", "Shaders/color.frag");
+    shaderReloader.Watch(&pointShader, "Shaders/point.vert", "Shaders/point.frag");
+    shaderReloader.Watch(&fontShader, "Shaders/font.vert", "Shaders/font.frag");
+    shaderReloader.Watch(&virtualMapShader, "Shaders/sprite.vert", "Shaders/map.frag");
+    shaderReloader.Watch(&feedbackShader, "Shaders/feedback.vert", "Shaders/feedback.frag");
+    shaderReloader.Start(window);
 
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
-    Point lastMapOffset = mapOffset;
-
+    // Veličina framebuffer-a (callback javlja samo promene), prva kopija stanja, pa GL
+    // kontekst prelazi na render nit
+    glfwGetFramebufferSize(window, &windowedWidth, &windowedHeight);
+    publishSnapshot(0.0f, 0.0f);
+    glfwMakeContextCurrent(NULL);
+    renderRunning = true;
+    std::thread renderThread(renderLoop);
+
+    // Nit događaja: callback-ovi se izvršavaju čim ulaz stigne (ne čekaju kraj frejma), a
+    // korak kretanja i kamere ide posle svakog talasa događaja, najmanje UPDATE_RATE puta u sekundi
+    double lastUpdateTime = glfwGetTime();
+    std::string title;
     while (!glfwWindowShouldClose(window)) {
-        auto frameStart = std::chrono::high_resolution_clock::now();
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        if (currentMode == WALKING) {
-            // Obrada inputa za kretanje
-            lastMapOffset = mapOffset;
-
-            if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-                mapOffset.y += WALK_SPEED;  // Gore
-            }
-            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-                mapOffset.y -= WALK_SPEED;  // Dole (BILO JE -, TREBA +)
-            }
-            if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-                mapOffset.x -= WALK_SPEED;  // Levo
-            }
-            if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-                mapOffset.x += WALK_SPEED;  // Desno
-            }
-
-            // Ograniči kretanje na granicu mape
-            mapOffset.x = fmax(-0.5f + MAP_ZOOM, fmin(0.5f - MAP_ZOOM, mapOffset.x));
-            mapOffset.y = fmax(-0.5f + MAP_ZOOM, fmin(0.5f - MAP_ZOOM, mapOffset.y));
-
-            // Ažuriraj pređenu distancu
-            // Pretvori mapOffset u map space (isto kao measuring mode)
-            // MAP_ZOOM je 0.15 -> pokriva samo 15% mape
-            float visibleMapSize = MAP_ZOOM * 2.0f; // 0.3 u NDC
-            Point lastGlobal((lastMapOffset.x + 0.5f) / 1.0f,
-                (lastMapOffset.y + 0.5f) / 1.0f);
-
-            Point currentGlobal((mapOffset.x + 0.5f) / 1.0f,
-                (mapOffset.y + 0.5f) / 1.0f);
-
-            walkingDistance += calculateDistance(lastGlobal, currentGlobal) * 1000.0f;
-
-
-            // Iscrtaj mapu (zoom-ovanu)
-            glUseProgram(mapShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mapTexture);
-            glUniform1i(glGetUniformLocation(mapShader, "uTexture"), 0);
-            glUniform2f(glGetUniformLocation(mapShader, "uOffset"), mapOffset.x, mapOffset.y);
-            glUniform1f(glGetUniformLocation(mapShader, "uZoom"), MAP_ZOOM);
-
-            glBindVertexArray(mapVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // Iscrtaj pin
-            // --- Iscrtaj pin IKONU U CENTRU EKRANA ---
-            glUseProgram(iconShader);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, centerIconTexture);    // stavi pin ikoncu ako imaš
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-
-
-            // Centar ekrana
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), 0.0f, 0.0f);
-
-            // Veličina (probaj 0.1f ili 0.15f)
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.15f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // Iscrtaj ikonu za hodanje
-            glUseProgram(iconShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, walkIconTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-
+        glfwWaitEventsTimeout(1.0 / UPDATE_RATE);
+        double now = glfwGetTime();
+        update((float)(now - lastUpdateTime));
+        lastUpdateTime = now;
 
-            // pozicija ikone u gornjem desnom uglu
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), 0.78f, 0.78f);
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.3f);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // Ikonica za potpis
-            glUseProgram(iconShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, potpisTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), potpisAlpha);
-
-
-            // pozicija ikone u donjem desnom uglu
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), 0.80f, -0.75f);
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.3f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // --- POZADINA ZA TEKST --- //
-            glUseProgram(iconShader);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textBgTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-
-
-            // Pozicija (NDC koordinate) — npr. gornji levi deo ekrana
-            float bx = -0.735f;  
-            float by =  0.735f;  
-
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), bx, by);
-
-            // Skaliranje pozadine (širina/visina)
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.4f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-            // TODO: Ispiši distancu na ekranu (potreban text rendering)
-            //std::stringstream ss;
-            //ss << std::fixed << std::setprecision(2);
-            //ss << walkingDistance;
-            //bitmapFont->RenderText(ss.str(), 75.0f, 95.0f, 0.7f, 0.0f, 0.0f, 0.0f); // Bela boja
-            // Dobij glavni broj pre nule
-            int displayNumber = static_cast<int>(walkingDistance); // samo ceo broj, bez decimala
-            std::stringstream ss;
-            ss << displayNumber;
-            bitmapFont->RenderText(ss.str(), 75.0f, 95.0f, 0.7f, 0.0f, 0.0f, 0.0f);
-
-
-        }
-        else { // MEASURING mode
-            // Iscrtaj celu mapu
-            glUseProgram(mapShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mapTexture);
-            glUniform1i(glGetUniformLocation(mapShader, "uTexture"), 0);
-            glUniform2f(glGetUniformLocation(mapShader, "uOffset"), 0.0f, 0.0f);
-            glUniform1f(glGetUniformLocation(mapShader, "uZoom"), 1.0f);
-
-            glBindVertexArray(mapVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // Iscrtaj linije i tačke
-            drawLines();
-            drawPoints();
-
-            // Iscrtaj ikonu za merenje
-            glUseProgram(iconShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, measureIconTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), 0.78f, 0.78f);
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.3f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // Ikonica za potpis
-            glUseProgram(iconShader);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, potpisTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), potpisAlpha);
-
-
-            // pozicija ikone u donjem desnom uglu
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), 0.80f, -0.75f);
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.3f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-            // --- POZADINA ZA TEKST --- //
-            glUseProgram(iconShader);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, textBgTexture);
-            glUniform1i(glGetUniformLocation(iconShader, "uTexture"), 0);
-            glUniform1f(glGetUniformLocation(iconShader, "uAlpha"), 1.0f);
-
-            // Pozicija (NDC koordinate) — npr. gornji levi deo ekrana
-            float bx = -0.735f;
-            float by = 0.735f;
-
-            glUniform2f(glGetUniformLocation(iconShader, "uPos"), bx, by);
-
-            // Skaliranje pozadine (širina/visina)
-            glUniform1f(glGetUniformLocation(iconShader, "uScale"), 0.4f);
-
-            glBindVertexArray(iconVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-
-            // TODO: Ispiši ukupnu distancu (potreban text rendering)
-            int displayNumber = static_cast<int>(totalMeasureDistance); // samo ceo broj
-            std::stringstream ss;
-            ss << displayNumber;
-            bitmapFont->RenderText(ss.str(), 75.0f, 95.0f, 0.7f, 0.0f, 0.0f, 0.0f);
-
-        }
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-        
-        // --- frame limiter ---
-        auto frameEnd = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<float> frameDuration = frameEnd - frameStart;
-        float frameTime = 1.0f / 75.0f; // 75 FPS
-        if (frameDuration.count() < frameTime) {
-            std::this_thread::sleep_for(
-                std::chrono::duration<float>(frameTime - frameDuration.count())
-            );
-        }
+        // Naslov prozora sme da menja samo ova nit
+        if (takeFrameStatsTitle(title) && profilingEnabled) glfwSetWindowTitle(window, title.c_str());
     }
 
+    renderRunning = false;
+    renderThread.join();
+    glfwMakeContextCurrent(window); // GL objekti se brišu na ovoj niti
+
     // Cleanup
-    glDeleteVertexArrays(1, &mapVAO);
-    glDeleteBuffers(1, &mapVBO);
+    mapExport.Cancel();
+    saveSession();
+    routeJournal.Stop();
+    RouteJournal::Stats journalStats = routeJournal.GetStats();
+    std::cout << std::fixed << std::setprecision(3) << "Dnevnik: " << journalStats.records << " zapisa, "
+        << journalStats.syncs << " fsync, max kasnjenje klika " << journalStats.maxRecordMicros
+        << " us, max do diska " << journalStats.maxDurableMillis << " ms" << std::endl;
+    shaderReloader.Stop();
     glDeleteVertexArrays(1, &pinVAO);
     glDeleteBuffers(1, &pinVBO);
-    glDeleteVertexArrays(1, &pointVAO);
-    glDeleteBuffers(1, &pointVBO);
-    glDeleteVertexArrays(1, &lineVAO);
-    glDeleteBuffers(1, &lineVBO);
-    glDeleteVertexArrays(1, &iconVAO);
-    glDeleteBuffers(1, &iconVBO);
-
-    glDeleteProgram(mapShader);
+    routeRenderer.Destroy();
+    glDeleteBuffers(1, &viewUBO);
+    samplers.Destroy();
+    streamBuffer.Destroy();
+
+    glDeleteProgram(spriteShader);
     glDeleteProgram(colorShader);
-    glDeleteProgram(iconShader);
+    glDeleteProgram(pointShader);
+    glDeleteProgram(virtualMapShader);
+    glDeleteProgram(feedbackShader);
+    glDeleteTextures(1, &mapTexture);
+    delete virtualMap; // Čeka poslove koji čitaju izvor
+    jobSystem.Stop();
+    delete mapSource;
+    delete spriteRenderer;
     delete bitmapFont;
     glDeleteProgram(fontShader);
     glfwDestroyWindow(window);
@@ -0,0 +1,268 @@
+#include "../Header/MapExport.h"
+#include "../Header/Camera.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+MapExport::MapExport()
+    : size(0), tilesPerSide(0), left(0.0f), top(0.0f), tileZoom(0.0f), nextTile(0), active(false),
+    startTime(0.0), fbo(0), colorBuffer(0), readbacks(), readbackHead(0), readbackCount(0),
+    nextToWrite(0), bandsInFlight(0), failed(false) {
+}
+
+MapExport::~MapExport() {
+    // GL objekti se brisu u Cancel/Finish (dok kontekst postoji)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        toCompress.clear();
+    }
+    for (const JobSystem::JobHandle& job : jobs) jobSystem.Wait(job);
+}
+
+bool MapExport::Start(const char* exportPath, int requestedSize, const Camera& camera, const RouteSnapshotPtr& exportRoutes) {
+    if (active) return false;
+
+    path = exportPath;
+    tilesPerSide = std::max(1, (requestedSize + TILE_SIZE - 1) / TILE_SIZE);
+    size = tilesPerSide * TILE_SIZE;
+    if (!writer.Begin(path.c_str(), size, size, 3)) {
+        std::cout << "GRESKA: Ne mogu da napravim " << path << std::endl;
+        return false;
+    }
+
+    // Isti kvadrat mape koji kamera prikazuje, podeljen na tilesPerSide x tilesPerSide plocica
+    left = camera.centerX - camera.zoom * 0.5f;
+    top = camera.centerY + camera.zoom * 0.5f;
+    tileZoom = camera.zoom / tilesPerSide;
+    nextTile = 0;
+    nextToWrite = 0;
+    bandsInFlight = 0;
+    failed = false;
+
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, TILE_SIZE, TILE_SIZE);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        std::cout << "GRESKA: FBO za izvoz nije kompletan" << std::endl;
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteFramebuffers(1, &fbo);
+        writer.Abort();
+        return false;
+    }
+
+    for (Readback& readback : readbacks) {
+        glGenBuffers(1, &readback.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, TILE_SIZE * TILE_SIZE * 4, NULL, GL_STREAM_READ);
+        readback.fence = nullptr;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackHead = readbackCount = 0;
+    routeRenderer.Init();
+    routes = exportRoutes;
+
+    active = true;
+    startTime = glfwGetTime();
+    std::cout << "Izvoz " << path << ": " << size << "x" << size << ", " << tilesPerSide * tilesPerSide
+        << " plocica, do " << MaxBands() << " traka u memoriji" << std::endl;
+    return true;
+}
+
+void MapExport::CompressNext() {
+    std::unique_ptr<Band> band;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (toCompress.empty()) return; // Izvoz je prekinut
+        band = std::move(toCompress.front());
+        toCompress.pop_front();
+    }
+
+    // RGBA -> RGB na mestu (alfa posle blending-a nije providnost slike)
+    unsigned char* pixels = band->pixels.data();
+    size_t count = (size_t)size * TILE_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        pixels[i * 3] = pixels[i * 4];
+        pixels[i * 3 + 1] = pixels[i * 4 + 1];
+        pixels[i * 3 + 2] = pixels[i * 4 + 2];
+    }
+    PngWriter::Strip strip;
+    PngWriter::CompressStrip(pixels, size, TILE_SIZE, 3, strip);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    freeBuffers.push_back(std::move(band->pixels));
+    compressed[band->index] = std::move(strip);
+    // Upis ide redom; nit koja je zavrsila traku na redu upisuje i sve gotove iza nje
+    while (!compressed.empty() && compressed.begin()->first == nextToWrite) {
+        if (!writer.WriteStrip(compressed.begin()->second)) failed = true;
+        compressed.erase(compressed.begin());
+        nextToWrite++;
+        bandsInFlight--;
+    }
+}
+
+void MapExport::CollectReadbacks(bool wait) {
+    while (readbackCount > 0) {
+        Readback& readback = readbacks[readbackHead];
+        GLenum status = glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000ull : 0);
+        if (status == GL_TIMEOUT_EXPIRED) return;
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+
+        int column = readback.tile % tilesPerSide;
+        int row = readback.tile / tilesPerSide;
+        Band* band = nullptr;
+        for (std::unique_ptr<Band>& candidate : filling)
+            if (candidate->index == row) band = candidate.get();
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+        const unsigned char* data = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+            TILE_SIZE * TILE_SIZE * 4, GL_MAP_READ_BIT);
+        if (data && band) {
+            // glReadPixels daje redove odozdo; u traci je prvi red gornji
+            size_t rowBytes = TILE_SIZE * 4;
+            for (int y = 0; y < TILE_SIZE; y++) {
+                memcpy(band->pixels.data() + ((size_t)(TILE_SIZE - 1 - y) * size + (size_t)column * TILE_SIZE) * 4,
+                    data + y * rowBytes, rowBytes);
+            }
+        }
+        if (data) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        readbackHead = (readbackHead + 1) % READBACK_SLOTS;
+        readbackCount--;
+
+        if (band && ++band->tilesCopied == tilesPerSide) {
+            for (size_t i = 0; i < filling.size(); i++) {
+                if (filling[i].get() != band) continue;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    toCompress.push_back(std::move(filling[i]));
+                }
+                filling.erase(filling.begin() + i);
+                jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                    [](const JobSystem::JobHandle& job) { return jobSystem.IsDone(job); }), jobs.end());
+                jobs.push_back(jobSystem.Submit([this] { CompressNext(); }));
+                break;
+            }
+        }
+    }
+}
+
+void MapExport::RenderTile(const RenderFunction& render) {
+    int column = nextTile % tilesPerSide;
+    int row = nextTile / tilesPerSide;
+
+    if (column == 0) {
+        // Nova traka: prostor iz recikliranih bafera (broj traka u memoriji je ogranicen)
+        std::unique_ptr<Band> band(new Band());
+        band->index = row;
+        band->tilesCopied = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bandsInFlight++;
+            if (!freeBuffers.empty()) {
+                band->pixels = std::move(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+        band->pixels.resize((size_t)size * TILE_SIZE * 4);
+        filling.push_back(std::move(band));
+    }
+
+    Camera tileCamera(left + (column + 0.5f) * tileZoom, top - (row + 0.5f) * tileZoom, tileZoom);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, TILE_SIZE, TILE_SIZE);
+    glClear(GL_COLOR_BUFFER_BIT);
+    render(tileCamera, TILE_SIZE, routeRenderer, *routes);
+
+    int slot = (readbackHead + readbackCount) % READBACK_SLOTS;
+    Readback& readback = readbacks[slot];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    glReadPixels(0, 0, TILE_SIZE, TILE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.tile = nextTile;
+    readbackCount++;
+    nextTile++;
+}
+
+void MapExport::Update(const RenderFunction& render, int windowWidth, int windowHeight) {
+    if (!active) return;
+
+    CollectReadbacks(false);
+
+    int total = tilesPerSide * tilesPerSide;
+    int rendered = 0;
+    while (rendered < TILES_PER_FRAME && nextTile < total && readbackCount < READBACK_SLOTS) {
+        if (nextTile % tilesPerSide == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (bandsInFlight >= MaxBands()) break; // Kompresija kasni - sacekaj sledeci frejm
+        }
+        RenderTile(render);
+        rendered++;
+    }
+    if (rendered > 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, windowWidth, windowHeight);
+    }
+
+    bool done;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = nextToWrite == tilesPerSide || failed;
+    }
+    if (done) Finish(!failed);
+}
+
+void MapExport::Finish(bool ok) {
+    // Trake koje jos nisu zapocete se odbacuju; zapocete se dovrse
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        toCompress.clear();
+    }
+    for (const JobSystem::JobHandle& job : jobs) jobSystem.Wait(job);
+    jobs.clear();
+
+    // Citanja koja su jos na GPU (kod prekida)
+    for (Readback& readback : readbacks) {
+        if (readback.fence) glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+        glDeleteBuffers(1, &readback.pbo);
+        readback.pbo = 0;
+    }
+    readbackCount = 0;
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &fbo);
+    colorBuffer = fbo = 0;
+    routeRenderer.Destroy();
+    routes = nullptr;
+
+    filling.clear();
+    toCompress.clear();
+    compressed.clear();
+    freeBuffers.clear();
+    active = false;
+
+    if (ok && writer.End()) {
+        std::cout << std::fixed << std::setprecision(2) << "Izvoz gotov: " << path << ", "
+            << writer.CompressedBytes() / (1024.0 * 1024.0) << " MB za " << glfwGetTime() - startTime << " s" << std::endl;
+    }
+    else {
+        writer.Abort();
+        remove(path.c_str());
+        std::cout << "Izvoz " << path << " prekinut" << std::endl;
+    }
+}
+
+void MapExport::Cancel() {
+    if (active) Finish(false);
+}
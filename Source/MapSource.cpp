@@ -0,0 +1,182 @@
+#include "../Header/MapSource.h"
+#include "../Header/GeoTiffSource.h"
+#include "../Header/MbTilesSource.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Boja plocice koja ne postoji u izvoru (retka baza, rupa u GeoTIFF-u)
+static const unsigned char BACKGROUND[4] = { 0xE0, 0xE0, 0xE0, 0xFF };
+
+int MapSource::LevelWidth(int level) const {
+    return std::max(1, width >> level);
+}
+
+int MapSource::LevelHeight(int level) const {
+    return std::max(1, height >> level);
+}
+
+void MapSource::ReadRegion(int level, int x, int y, int w, int h, unsigned char* rgba) {
+    if (HasLevel(level)) {
+        ReadNative(level, x, y, w, h, rgba);
+        return;
+    }
+
+    // 2x2 prosek finijeg nivoa (kao pravljenje piramide); ivica se ponavlja kod neparnih velicina
+    int fineWidth = LevelWidth(level - 1), fineHeight = LevelHeight(level - 1);
+    int fx = x * 2, fy = y * 2;
+    int fw = std::min(w * 2, fineWidth - fx), fh = std::min(h * 2, fineHeight - fy);
+    std::vector<unsigned char> fine((size_t)fw * fh * 4);
+    ReadRegion(level - 1, fx, fy, fw, fh, fine.data());
+
+    for (int row = 0; row < h; row++) {
+        int y0 = std::min(row * 2, fh - 1), y1 = std::min(row * 2 + 1, fh - 1);
+        for (int col = 0; col < w; col++) {
+            int x0 = std::min(col * 2, fw - 1), x1 = std::min(col * 2 + 1, fw - 1);
+            for (int c = 0; c < 4; c++) {
+                int sum = fine[((size_t)y0 * fw + x0) * 4 + c] + fine[((size_t)y0 * fw + x1) * 4 + c]
+                    + fine[((size_t)y1 * fw + x0) * 4 + c] + fine[((size_t)y1 * fw + x1) * 4 + c];
+                rgba[((size_t)row * w + col) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+
+ImageMapSource::ImageMapSource(const unsigned char* rgba, int imageWidth, int imageHeight) {
+    width = imageWidth;
+    height = imageHeight;
+
+    Level base;
+    base.width = width;
+    base.height = height;
+    base.pixels.assign(rgba, rgba + (size_t)width * height * 4);
+    levels.push_back(std::move(base));
+
+    // Svaki sledeci nivo je 2x2 prosek prethodnog, do 1x1
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const Level& src = levels.back();
+        Level dst;
+        dst.width = std::max(1, src.width / 2);
+        dst.height = std::max(1, src.height / 2);
+        dst.pixels.resize((size_t)dst.width * dst.height * 4);
+        for (int y = 0; y < dst.height; y++) {
+            int y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+            for (int x = 0; x < dst.width; x++) {
+                int x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src.pixels[((size_t)y0 * src.width + x0) * 4 + c]
+                        + src.pixels[((size_t)y0 * src.width + x1) * 4 + c]
+                        + src.pixels[((size_t)y1 * src.width + x0) * 4 + c]
+                        + src.pixels[((size_t)y1 * src.width + x1) * 4 + c];
+                    dst.pixels[((size_t)y * dst.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(std::move(dst));
+    }
+}
+
+void ImageMapSource::ReadNative(int level, int x, int y, int w, int h, unsigned char* rgba) {
+    const Level& src = levels[level];
+    for (int row = 0; row < h; row++)
+        memcpy(rgba + (size_t)row * w * 4, &src.pixels[(((size_t)(y + row)) * src.width + x) * 4], (size_t)w * 4);
+}
+
+// ---------------------------------------------------------------------------------------------
+
+TiledMapSource::TiledMapSource() : tileSize(256) {}
+
+bool TiledMapSource::FetchTile(int level, int tileX, int tileY, std::vector<unsigned char>& pixels) {
+    uint64_t key = ((uint64_t)(level + 1) << 48) | ((uint64_t)tileY << 24) | (uint64_t)tileX;
+    size_t tileBytes = (size_t)tileSize * tileSize * 4;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = cacheIndex.find(key);
+        if (found != cacheIndex.end()) {
+            cache.splice(cache.begin(), cache, found->second);
+            if (found->second->present) pixels = found->second->pixels;
+            return found->second->present;
+        }
+    }
+
+    // Citanje i dekodiranje van brave; ako dve niti traze istu plocicu, obe je ucitaju
+    pixels.resize(tileBytes);
+    bool present = LoadTile(level, tileX, tileY, pixels.data());
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cacheIndex.count(key)) return present;
+    if ((int)cache.size() >= CACHE_TILES) {
+        cacheIndex.erase(cache.back().key);
+        cache.pop_back();
+    }
+    cache.push_front(CachedTile{ key, present ? pixels : std::vector<unsigned char>(), present });
+    cacheIndex[key] = cache.begin();
+    return present;
+}
+
+void TiledMapSource::ReadNative(int level, int x, int y, int w, int h, unsigned char* rgba) {
+    int originX, originY;
+    TileOrigin(level, originX, originY);
+    int gx0 = x + originX, gy0 = y + originY;
+    int firstX = gx0 / tileSize, lastX = (gx0 + w - 1) / tileSize;
+    int firstY = gy0 / tileSize, lastY = (gy0 + h - 1) / tileSize;
+
+    std::vector<unsigned char> tile;
+    for (int ty = firstY; ty <= lastY; ty++) {
+        for (int tx = firstX; tx <= lastX; tx++) {
+            // Presek plocice i pravougaonika, u koordinatama mreze
+            int left = std::max(gx0, tx * tileSize), right = std::min(gx0 + w, (tx + 1) * tileSize);
+            int bottom = std::max(gy0, ty * tileSize), top = std::min(gy0 + h, (ty + 1) * tileSize);
+            bool present = FetchTile(level, tx, ty, tile);
+
+            for (int gy = bottom; gy < top; gy++) {
+                unsigned char* dst = rgba + ((size_t)(gy - gy0) * w + (left - gx0)) * 4;
+                if (present) {
+                    const unsigned char* src = &tile[((size_t)(gy - ty * tileSize) * tileSize + (left - tx * tileSize)) * 4];
+                    memcpy(dst, src, (size_t)(right - left) * 4);
+                }
+                else {
+                    for (int gx = left; gx < right; gx++, dst += 4) memcpy(dst, BACKGROUND, 4);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+
+static std::string lowerExtension(const char* path) {
+    std::string name = path;
+    size_t dot = name.find_last_of('.');
+    if (dot == std::string::npos) return std::string();
+    std::string extension = name.substr(dot + 1);
+    for (char& c : extension) c = (char)tolower((unsigned char)c);
+    return extension;
+}
+
+bool isMapSourcePath(const char* path) {
+    std::string extension = lowerExtension(path);
+    return extension == "mbtiles" || extension == "tif" || extension == "tiff";
+}
+
+MapSource* openMapSource(const char* path) {
+    std::string extension = lowerExtension(path);
+    if (extension == "mbtiles") {
+        MbTilesSource* source = new MbTilesSource();
+        if (source->Open(path)) return source;
+        delete source;
+    }
+    else if (extension == "tif" || extension == "tiff") {
+        GeoTiffSource* source = new GeoTiffSource();
+        if (source->Open(path)) return source;
+        delete source;
+    }
+    else {
+        std::cout << "Izvor mape: nepoznat format " << path << std::endl;
+    }
+    return nullptr;
+}
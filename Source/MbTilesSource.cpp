@@ -0,0 +1,479 @@
+#include "../Header/MbTilesSource.h"
+#include "../Header/ImageDecoder.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static const double PI = 3.14159265358979323846;
+
+enum PageType { PAGE_TABLE_INTERIOR = 0x05, PAGE_TABLE_LEAF = 0x0D };
+
+static uint32_t get32BigEndian(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t get16BigEndian(const unsigned char* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// SQLite varint: do 9 bajtova, 7 bita po bajtu (deveti svih 8), najvisi prvi
+static bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& value) {
+    value = 0;
+    for (int i = 0; i < 9; i++) {
+        if (p >= end) return false;
+        unsigned char byte = *p++;
+        if (i == 8) {
+            value = (value << 8) | byte;
+            return true;
+        }
+        value = (value << 7) | (byte & 0x7F);
+        if (!(byte & 0x80)) return true;
+    }
+    return true;
+}
+
+// Citanje formata baze (https://www.sqlite.org/fileformat.html), samo tabele sa rowid
+struct SqliteReader {
+    const unsigned char* data;
+    size_t size;
+    uint32_t pageSize, usableSize;
+
+    struct Cell {
+        uint32_t page;
+        uint32_t offset;
+        int64_t rowid;
+        uint64_t payloadSize;
+        const unsigned char* local;
+        uint32_t localSize;
+        uint32_t overflowPage;
+    };
+
+    struct Column {
+        uint64_t serialType;
+        uint64_t offset;    // U sadrzaju (payload) zapisa
+        uint64_t size;
+    };
+
+    const unsigned char* Page(uint32_t page) const {
+        if (page == 0 || (uint64_t)page * pageSize > size) return nullptr;
+        return data + (size_t)(page - 1) * pageSize;
+    }
+
+    bool ParseLeafCell(uint32_t page, uint32_t offset, Cell& cell) const {
+        const unsigned char* base = Page(page);
+        if (!base || offset >= usableSize) return false;
+        const unsigned char* p = base + offset;
+        const unsigned char* end = base + usableSize;
+        uint64_t rowid;
+        if (!getVarint(p, end, cell.payloadSize) || !getVarint(p, end, rowid)) return false;
+
+        // Koliko sadrzaja staje u samu celiju (ostatak ide u lanac prelivnih stranica)
+        uint64_t maxLocal = usableSize - 35;
+        uint64_t minLocal = (uint64_t)(usableSize - 12) * 32 / 255 - 23;
+        uint64_t local = cell.payloadSize;
+        if (local > maxLocal) {
+            local = minLocal + (cell.payloadSize - minLocal) % (usableSize - 4);
+            if (local > maxLocal) local = minLocal;
+        }
+        if (p + local + (local < cell.payloadSize ? 4 : 0) > end) return false;
+
+        cell.page = page;
+        cell.offset = offset;
+        cell.rowid = (int64_t)rowid;
+        cell.local = p;
+        cell.localSize = (uint32_t)local;
+        cell.overflowPage = local < cell.payloadSize ? get32BigEndian(p + local) : 0;
+        return true;
+    }
+
+    bool ReadPayload(const Cell& cell, uint64_t offset, uint64_t length, unsigned char* out) const {
+        if (offset + length > cell.payloadSize) return false;
+        uint64_t copied = 0;
+        if (offset < cell.localSize) {
+            copied = std::min<uint64_t>(length, cell.localSize - offset);
+            memcpy(out, cell.local + offset, (size_t)copied);
+        }
+
+        // Prelivna stranica: 4 bajta sledece stranice, pa usableSize - 4 bajta sadrzaja
+        uint64_t chunk = usableSize - 4;
+        uint64_t position = cell.localSize;
+        uint32_t page = cell.overflowPage;
+        uint64_t hops = cell.payloadSize / chunk + 2; // Zastita od petlje u ostecenoj bazi
+        while (copied < length) {
+            const unsigned char* pageData = Page(page);
+            if (!pageData || hops-- == 0) return false;
+            uint64_t want = offset + copied;
+            if (want < position + chunk) {
+                uint64_t take = std::min<uint64_t>(length - copied, position + chunk - want);
+                memcpy(out + copied, pageData + 4 + (want - position), (size_t)take);
+                copied += take;
+            }
+            position += chunk;
+            page = get32BigEndian(pageData);
+        }
+        return true;
+    }
+
+    bool ParseRecord(const Cell& cell, std::vector<Column>& columns) const {
+        columns.clear();
+        unsigned char first[9];
+        uint64_t firstBytes = std::min<uint64_t>(9, cell.payloadSize);
+        if (!ReadPayload(cell, 0, firstBytes, first)) return false;
+        const unsigned char* p = first;
+        uint64_t headerSize;
+        if (!getVarint(p, first + firstBytes, headerSize) || headerSize > cell.payloadSize || headerSize > 65536)
+            return false;
+
+        std::vector<unsigned char> header((size_t)headerSize);
+        if (!ReadPayload(cell, 0, headerSize, header.data())) return false;
+        p = header.data() + (p - first);
+        const unsigned char* end = header.data() + header.size();
+        uint64_t body = headerSize;
+        while (p < end) {
+            uint64_t type;
+            if (!getVarint(p, end, type)) return false;
+            uint64_t bytes;
+            if (type <= 4) bytes = type;
+            else if (type == 5) bytes = 6;
+            else if (type == 6 || type == 7) bytes = 8;
+            else if (type < 12) bytes = 0;
+            else bytes = (type - 12) / 2;
+            columns.push_back({ type, body, bytes });
+            body += bytes;
+        }
+        return body <= cell.payloadSize;
+    }
+
+    // Celobrojna kolona; NULL u koloni INTEGER PRIMARY KEY znaci rowid
+    bool Integer(const Cell& cell, const Column& column, int64_t& value) const {
+        if (column.serialType == 0) {
+            value = cell.rowid;
+            return true;
+        }
+        if (column.serialType == 8 || column.serialType == 9) {
+            value = column.serialType - 8;
+            return true;
+        }
+        if (column.serialType < 1 || column.serialType > 6) return false;
+        unsigned char bytes[8];
+        if (!ReadPayload(cell, column.offset, column.size, bytes)) return false;
+        value = (bytes[0] & 0x80) ? -1 : 0; // Znak se prosiruje
+        for (uint64_t i = 0; i < column.size; i++) value = (int64_t)(((uint64_t)value << 8) | bytes[i]);
+        return true;
+    }
+
+    // Tekst ili blob kao bajtovi
+    bool Bytes(const Cell& cell, const Column& column, std::string& value) const {
+        if (column.serialType < 12) {
+            // Celobrojni kljuc (npr. tile_id kao broj) u istom obliku kao tekst
+            int64_t number;
+            if (!Integer(cell, column, number)) return false;
+            value = std::to_string(number);
+            return true;
+        }
+        value.resize((size_t)column.size);
+        return column.size == 0 || ReadPayload(cell, column.offset, column.size, (unsigned char*)&value[0]);
+    }
+
+    // Poziva onCell(const Cell&) za svaki red tabele (redosled stabla)
+    template <typename Function>
+    bool ScanTable(uint32_t root, Function onCell) const {
+        std::vector<uint32_t> stack(1, root);
+        size_t visited = 0, pageCount = size / pageSize;
+        while (!stack.empty()) {
+            uint32_t page = stack.back();
+            stack.pop_back();
+            const unsigned char* base = Page(page);
+            if (!base || ++visited > pageCount) return false;
+            const unsigned char* header = base + (page == 1 ? 100 : 0);
+            int type = header[0];
+            uint16_t cellCount = get16BigEndian(header + 3);
+            const unsigned char* pointers = header + (type == PAGE_TABLE_INTERIOR ? 12 : 8);
+            if (pointers + cellCount * 2 > base + usableSize) return false;
+
+            if (type == PAGE_TABLE_INTERIOR) {
+                stack.push_back(get32BigEndian(header + 8)); // Najdesnije dete
+                for (int i = 0; i < cellCount; i++) {
+                    uint16_t offset = get16BigEndian(pointers + i * 2);
+                    if ((uint32_t)offset + 4 > usableSize) return false;
+                    stack.push_back(get32BigEndian(base + offset));
+                }
+            }
+            else if (type == PAGE_TABLE_LEAF) {
+                for (int i = 0; i < cellCount; i++) {
+                    Cell cell;
+                    if (!ParseLeafCell(page, get16BigEndian(pointers + i * 2), cell)) return false;
+                    onCell(cell);
+                }
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Imena kolona iz "CREATE TABLE ime (a tip, b tip, ..., ogranicenja)" po redosledu
+static std::vector<std::string> columnNames(const std::string& sql) {
+    std::vector<std::string> names;
+    size_t open = sql.find('('), close = sql.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) return names;
+
+    int depth = 0;
+    std::string part;
+    auto finish = [&names](const std::string& text) {
+        size_t start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) return;
+        std::string name;
+        char quote = 0;
+        if (text[start] == '"' || text[start] == '`' || text[start] == '[') {
+            quote = text[start] == '[' ? ']' : text[start];
+            start++;
+        }
+        for (size_t i = start; i < text.size(); i++) {
+            char c = text[i];
+            if (quote ? c == quote : (isspace((unsigned char)c) != 0)) break;
+            name += (char)tolower((unsigned char)c);
+        }
+        if (!quote && (name == "primary" || name == "unique" || name == "constraint" || name == "check" || name == "foreign"))
+            return;
+        names.push_back(name);
+    };
+    for (size_t i = open + 1; i < close; i++) {
+        char c = sql[i];
+        if (c == '(') depth++;
+        if (c == ')') depth--;
+        if (c == ',' && depth == 0) {
+            finish(part);
+            part.clear();
+        }
+        else {
+            part += c;
+        }
+    }
+    finish(part);
+    return names;
+}
+
+static int columnIndex(const std::vector<std::string>& names, const char* name) {
+    for (size_t i = 0; i < names.size(); i++)
+        if (names[i] == name) return (int)i;
+    return -1;
+}
+
+uint64_t MbTilesSource::TileKey(int zoom, int column, int row) {
+    return ((uint64_t)zoom << 58) | ((uint64_t)row << 29) | (uint64_t)column;
+}
+
+MbTilesSource::MbTilesSource()
+    : pageSize(0), usableSize(0), minZoom(0), maxZoom(0), minColumn(0), minRow(0), columns(0), rows(0) {
+}
+
+bool MbTilesSource::Open(const char* path) {
+    if (!file.Open(path)) {
+        std::cout << "MBTiles: ne mogu da otvorim " << path << std::endl;
+        return false;
+    }
+    const unsigned char* data = file.Data();
+    if (file.Size() < 100 || memcmp(data, "SQLite format 3", 16) != 0) {
+        std::cout << "MBTiles: " << path << " nije SQLite baza" << std::endl;
+        return false;
+    }
+    pageSize = get16BigEndian(data + 16);
+    if (pageSize == 1) pageSize = 65536;
+    usableSize = pageSize - data[20];
+    if (pageSize < 512 || (pageSize & (pageSize - 1)) || usableSize < 480 || get32BigEndian(data + 56) != 1) {
+        std::cout << "MBTiles: nepodrzana baza (velicina stranice ili kodiranje teksta)" << std::endl;
+        return false;
+    }
+    SqliteReader reader = { data, file.Size(), pageSize, usableSize };
+
+    // Sema: tip, ime, tabela, korenska stranica, SQL
+    struct SchemaEntry {
+        std::string type;
+        uint32_t root;
+        std::string sql;
+    };
+    std::unordered_map<std::string, SchemaEntry> schema;
+    std::vector<SqliteReader::Column> record;
+    bool ok = reader.ScanTable(1, [&](const SqliteReader::Cell& cell) {
+        if (!reader.ParseRecord(cell, record) || record.size() < 5) return;
+        std::string type, name, sql;
+        int64_t root = 0;
+        if (!reader.Bytes(cell, record[0], type) || !reader.Bytes(cell, record[1], name)
+            || !reader.Integer(cell, record[3], root) || !reader.Bytes(cell, record[4], sql))
+            return;
+        schema[name] = { type, (uint32_t)root, sql };
+    });
+    if (!ok) {
+        std::cout << "MBTiles: ostecena sema baze" << std::endl;
+        return false;
+    }
+
+    auto findTable = [&schema](const char* name) -> const SchemaEntry* {
+        auto found = schema.find(name);
+        return found != schema.end() && found->second.type == "table" ? &found->second : nullptr;
+    };
+
+    // Indeks plocica: direktno iz "tiles", ili "map" (koordinate -> tile_id) + "images" (tile_id -> podaci)
+    const SchemaEntry* tilesTable = findTable("tiles");
+    const SchemaEntry* mapTable = findTable("map");
+    const SchemaEntry* imagesTable = findTable("images");
+    bool first = true;
+    auto addTile = [&](int64_t zoom, int64_t column, int64_t row, const TileRef& ref) {
+        if (zoom < 0 || zoom > 29 || column < 0 || row < 0 || column >= (1ll << zoom) || row >= (1ll << zoom)) return;
+        tiles[TileKey((int)zoom, (int)column, (int)row)] = ref;
+        if (first) {
+            minZoom = maxZoom = (int)zoom;
+            first = false;
+        }
+        minZoom = std::min(minZoom, (int)zoom);
+        maxZoom = std::max(maxZoom, (int)zoom);
+    };
+
+    if (tilesTable) {
+        std::vector<std::string> names = columnNames(tilesTable->sql);
+        int zoomColumn = columnIndex(names, "zoom_level"), columnColumn = columnIndex(names, "tile_column");
+        int rowColumn = columnIndex(names, "tile_row"), dataColumn = columnIndex(names, "tile_data");
+        if (zoomColumn < 0 || columnColumn < 0 || rowColumn < 0 || dataColumn < 0) {
+            std::cout << "MBTiles: tabela tiles nema ocekivane kolone" << std::endl;
+            return false;
+        }
+        ok = reader.ScanTable(tilesTable->root, [&](const SqliteReader::Cell& cell) {
+            int64_t zoom, column, row;
+            if (!reader.ParseRecord(cell, record) || (int)record.size() <= dataColumn) return;
+            if (!reader.Integer(cell, record[zoomColumn], zoom) || !reader.Integer(cell, record[columnColumn], column)
+                || !reader.Integer(cell, record[rowColumn], row))
+                return;
+            addTile(zoom, column, row, TileRef{ cell.page, (uint16_t)cell.offset, (uint16_t)dataColumn });
+        });
+    }
+    else if (mapTable && imagesTable) {
+        std::vector<std::string> mapNames = columnNames(mapTable->sql), imageNames = columnNames(imagesTable->sql);
+        int zoomColumn = columnIndex(mapNames, "zoom_level"), columnColumn = columnIndex(mapNames, "tile_column");
+        int rowColumn = columnIndex(mapNames, "tile_row"), mapIdColumn = columnIndex(mapNames, "tile_id");
+        int dataColumn = columnIndex(imageNames, "tile_data"), imageIdColumn = columnIndex(imageNames, "tile_id");
+        if (zoomColumn < 0 || columnColumn < 0 || rowColumn < 0 || mapIdColumn < 0 || dataColumn < 0 || imageIdColumn < 0) {
+            std::cout << "MBTiles: tabele map/images nemaju ocekivane kolone" << std::endl;
+            return false;
+        }
+
+        std::unordered_map<std::string, TileRef> images;
+        std::string id;
+        ok = reader.ScanTable(imagesTable->root, [&](const SqliteReader::Cell& cell) {
+            if (!reader.ParseRecord(cell, record) || (int)record.size() <= std::max(dataColumn, imageIdColumn)) return;
+            if (reader.Bytes(cell, record[imageIdColumn], id))
+                images[id] = TileRef{ cell.page, (uint16_t)cell.offset, (uint16_t)dataColumn };
+        });
+        ok = ok && reader.ScanTable(mapTable->root, [&](const SqliteReader::Cell& cell) {
+            int64_t zoom, column, row;
+            if (!reader.ParseRecord(cell, record) || (int)record.size() <= mapIdColumn) return;
+            if (!reader.Integer(cell, record[zoomColumn], zoom) || !reader.Integer(cell, record[columnColumn], column)
+                || !reader.Integer(cell, record[rowColumn], row) || !reader.Bytes(cell, record[mapIdColumn], id))
+                return;
+            auto found = images.find(id);
+            if (found != images.end()) addTile(zoom, column, row, found->second);
+        });
+    }
+    else {
+        std::cout << "MBTiles: baza nema tabelu tiles ni map/images" << std::endl;
+        return false;
+    }
+    if (!ok || tiles.empty()) {
+        std::cout << "MBTiles: " << (ok ? "baza nema plocica" : "ostecena tabela plocica") << std::endl;
+        return false;
+    }
+
+    // Obuhvat = plocice najveceg zooma
+    int maxColumn = 0, maxRow = 0;
+    first = true;
+    uint64_t sampleKey = 0;
+    for (const auto& tile : tiles) {
+        if ((int)(tile.first >> 58) != maxZoom) continue;
+        int c = (int)(tile.first & ((1u << 29) - 1)), r = (int)((tile.first >> 29) & ((1u << 29) - 1));
+        if (first) {
+            minColumn = maxColumn = c;
+            minRow = maxRow = r;
+            sampleKey = tile.first;
+            first = false;
+        }
+        minColumn = std::min(minColumn, c);
+        maxColumn = std::max(maxColumn, c);
+        minRow = std::min(minRow, r);
+        maxRow = std::max(maxRow, r);
+    }
+    columns = maxColumn - minColumn + 1;
+    rows = maxRow - minRow + 1;
+
+    // Velicina plocice iz jedne dekodirane plocice (256 ili 512); vektorske plocice se ne dekodiraju
+    std::vector<unsigned char> sample;
+    int sampleWidth = 0, sampleHeight = 0;
+    unsigned char* pixels = nullptr;
+    if (ReadTileData(tiles[sampleKey], sample))
+        pixels = decodeImageMemoryRGBA(sample.data(), sample.size(), &sampleWidth, &sampleHeight, true);
+    bool raster = pixels && sampleWidth == sampleHeight && sampleWidth >= 64 && sampleWidth <= 4096;
+    free(pixels);
+    if (!raster) {
+        std::cout << "MBTiles: plocice nisu PNG/JPEG rasteri (vektorske plocice nisu podrzane)" << std::endl;
+        return false;
+    }
+    tileSize = sampleWidth;
+    width = columns * tileSize;
+    height = rows * tileSize;
+
+    std::cout << "MBTiles " << path << ": " << tiles.size() << " plocica, zoom " << minZoom << "-" << maxZoom
+        << ", " << width << "x" << height << " na zoomu " << maxZoom << ", plocice " << tileSize << std::endl;
+    return true;
+}
+
+bool MbTilesSource::ReadTileData(const TileRef& ref, std::vector<unsigned char>& data) const {
+    SqliteReader reader = { file.Data(), file.Size(), pageSize, usableSize };
+    SqliteReader::Cell cell;
+    std::vector<SqliteReader::Column> record;
+    if (!reader.ParseLeafCell(ref.page, ref.cell, cell) || !reader.ParseRecord(cell, record)) return false;
+    if (ref.column >= record.size() || record[ref.column].serialType < 12) return false;
+    const SqliteReader::Column& column = record[ref.column];
+    data.resize((size_t)column.size);
+    return reader.ReadPayload(cell, column.offset, column.size, data.data());
+}
+
+bool MbTilesSource::HasLevel(int level) const {
+    int zoom = maxZoom - level;
+    return zoom >= minZoom;
+}
+
+void MbTilesSource::TileOrigin(int level, int& originX, int& originY) const {
+    // Mreza nivoa je mreza plocica zooma (maxZoom - level), od juznog/zapadnog ugla sveta
+    originX = (int)(((int64_t)minColumn * tileSize) >> level);
+    originY = (int)(((int64_t)minRow * tileSize) >> level);
+}
+
+bool MbTilesSource::LoadTile(int level, int tileX, int tileY, unsigned char* rgba) {
+    auto found = tiles.find(TileKey(maxZoom - level, tileX, tileY));
+    if (found == tiles.end()) return false;
+
+    std::vector<unsigned char> data;
+    if (!ReadTileData(found->second, data)) return false;
+    int w = 0, h = 0;
+    unsigned char* pixels = decodeImageMemoryRGBA(data.data(), data.size(), &w, &h, true);
+    bool ok = pixels && w == tileSize && h == tileSize;
+    if (ok) memcpy(rgba, pixels, (size_t)tileSize * tileSize * 4);
+    free(pixels);
+    return ok;
+}
+
+bool MbTilesSource::GeoBounds(double& south, double& west, double& north, double& east) const {
+    // Web Mercator: kolona -> duzina linearno, red (TMS, od juga) -> sirina preko Mercatora
+    double tilesPerSide = (double)(1ll << maxZoom);
+    auto latitude = [](double v) { return atan(sinh(PI * (2.0 * v - 1.0))) * 180.0 / PI; };
+    west = minColumn / tilesPerSide * 360.0 - 180.0;
+    east = (minColumn + columns) / tilesPerSide * 360.0 - 180.0;
+    south = latitude(minRow / tilesPerSide);
+    north = latitude((minRow + rows) / tilesPerSide);
+    return true;
+}
@@ -0,0 +1,317 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "../Header/PngWriter.h"
+#include "../Header/RouteFile.h"
+#include <algorithm>
+#include <cstring>
+
+const char PngWriter::STRIP_CHUNK[5] = "stRP";
+
+static const uint32_t ADLER_MOD = 65521;
+
+static void put32BigEndian(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+}
+
+static uint32_t adler32(const unsigned char* data, size_t size) {
+    uint32_t a = 1, b = 0;
+    while (size > 0) {
+        // 5552 je najvise bajtova pre nego sto b moze da prekoraci 32 bita
+        size_t n = std::min(size, (size_t)5552);
+        size -= n;
+        while (n-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+// Adler-32 nadovezanih podataka iz Adler-32 delova (kao adler32_combine u zlib-u)
+static uint32_t adler32Combine(uint32_t first, uint32_t second, size_t secondSize) {
+    uint32_t remainder = (uint32_t)(secondSize % ADLER_MOD);
+    uint32_t a1 = first & 0xFFFF, b1 = first >> 16;
+    uint32_t a2 = second & 0xFFFF, b2 = second >> 16;
+    uint64_t a = (uint64_t)a1 + a2 + ADLER_MOD - 1;
+    uint64_t b = ((uint64_t)remainder * a1) % ADLER_MOD + b1 + b2 + ADLER_MOD - remainder;
+    return (uint32_t)((b % ADLER_MOD) << 16 | (a % ADLER_MOD));
+}
+
+// --- Deflate (fiksni Huffman) ---
+
+class BitWriter {
+private:
+    std::vector<unsigned char>& out;
+    uint64_t bits;
+    int count;
+
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : out(out), bits(0), count(0) {}
+
+    void Put(uint32_t value, int length) {
+        bits |= (uint64_t)value << count;
+        count += length;
+        if (count >= 32) {
+            unsigned char bytes[4] = { (unsigned char)bits, (unsigned char)(bits >> 8),
+                (unsigned char)(bits >> 16), (unsigned char)(bits >> 24) };
+            out.insert(out.end(), bytes, bytes + 4);
+            bits >>= 32;
+            count -= 32;
+        }
+    }
+
+    // Dopuni do celog bajta i ispisi sve sto je ostalo u baferu
+    void AlignToByte() {
+        if (count % 8 != 0) Put(0, 8 - count % 8);
+        while (count > 0) {
+            out.push_back((unsigned char)bits);
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+};
+
+static uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t result = 0;
+    for (int i = 0; i < length; i++) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+// Fiksni kodovi (RFC 1951, 3.2.6), vec obrnuti jer deflate pise Huffman kod od najviseg bita
+struct FixedCodes {
+    uint32_t literal[288];
+    int literalLength[288];
+    uint32_t distance[30];
+
+    FixedCodes() {
+        for (int i = 0; i < 288; i++) {
+            uint32_t code;
+            int length;
+            if (i < 144) { code = 0x30 + i; length = 8; }
+            else if (i < 256) { code = 0x190 + (i - 144); length = 9; }
+            else if (i < 280) { code = i - 256; length = 7; }
+            else { code = 0xC0 + (i - 280); length = 8; }
+            literal[i] = reverseBits(code, length);
+            literalLength[i] = length;
+        }
+        for (int i = 0; i < 30; i++) distance[i] = reverseBits(i, 5);
+    }
+};
+
+static const FixedCodes fixedCodes;
+
+static const int LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const int LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const int DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const int DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const int WINDOW_SIZE = 32768;
+static const int HASH_BITS = 15;
+static const int MAX_CHAIN = 8;
+static const int MIN_MATCH = 3;
+static const int MAX_MATCH = 258;
+
+static void putLiteral(BitWriter& writer, int symbol) {
+    writer.Put(fixedCodes.literal[symbol], fixedCodes.literalLength[symbol]);
+}
+
+static void putMatch(BitWriter& writer, int length, int distance) {
+    int l = 28;
+    while (LENGTH_BASE[l] > length) l--;
+    putLiteral(writer, 257 + l);
+    if (LENGTH_EXTRA[l] > 0) writer.Put(length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+    int d = 29;
+    while (DISTANCE_BASE[d] > distance) d--;
+    writer.Put(fixedCodes.distance[d], 5);
+    if (DISTANCE_EXTRA[d] > 0) writer.Put(distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+}
+
+static uint32_t hash3(const unsigned char* p) {
+    return ((p[0] << 16 | p[1] << 8 | p[2]) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Jedan blok sa fiksnim kodovima (BFINAL = 0) + prazan stored blok za poravnanje na bajt
+static void deflateFixed(const unsigned char* data, size_t size, std::vector<unsigned char>& out) {
+    BitWriter writer(out);
+    writer.Put(0, 1);   // BFINAL
+    writer.Put(1, 2);   // BTYPE = fiksni Huffman
+
+    std::vector<int> head(1 << HASH_BITS, -1);
+    std::vector<int> previous(WINDOW_SIZE, -1);
+    size_t i = 0;
+    while (i < size) {
+        int bestLength = 0, bestDistance = 0;
+        if (i + MIN_MATCH <= size) {
+            uint32_t h = hash3(data + i);
+            int candidate = head[h];
+            int maxLength = (int)std::min((size_t)MAX_MATCH, size - i);
+            for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && (int)i - candidate <= WINDOW_SIZE; chain++) {
+                const unsigned char* a = data + candidate;
+                const unsigned char* b = data + i;
+                if (a[bestLength] == b[bestLength]) {
+                    int length = 0;
+                    while (length < maxLength && a[length] == b[length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = (int)i - candidate;
+                        if (length == maxLength) break;
+                    }
+                }
+                candidate = previous[candidate & (WINDOW_SIZE - 1)];
+            }
+            previous[i & (WINDOW_SIZE - 1)] = head[h];
+            head[h] = (int)i;
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            putMatch(writer, bestLength, bestDistance);
+            // Pozicije unutar poklapanja ulaze u hes (bez trazenja)
+            for (size_t k = i + 1; k < i + bestLength && k + MIN_MATCH <= size; k++) {
+                uint32_t h = hash3(data + k);
+                previous[k & (WINDOW_SIZE - 1)] = head[h];
+                head[h] = (int)k;
+            }
+            i += bestLength;
+        }
+        else {
+            putLiteral(writer, data[i]);
+            i++;
+        }
+    }
+    putLiteral(writer, 256); // Kraj bloka
+
+    // Prazan stored blok (sync flush): poravnanje na bajt, 00 00 FF FF
+    writer.Put(0, 1);
+    writer.Put(0, 2);
+    writer.AlignToByte();
+    const unsigned char empty[4] = { 0x00, 0x00, 0xFF, 0xFF };
+    out.insert(out.end(), empty, empty + 4);
+}
+
+void PngWriter::CompressStrip(const unsigned char* pixels, int width, int rows, int channels, Strip& out) {
+    size_t stride = (size_t)width * channels;
+    std::vector<unsigned char> filtered((stride + 1) * rows);
+    for (int y = 0; y < rows; y++) {
+        const unsigned char* row = pixels + stride * y;
+        unsigned char* dst = filtered.data() + (stride + 1) * y;
+        if (y == 0) {
+            dst[0] = 1; // Sub
+            for (size_t x = 0; x < stride; x++)
+                dst[1 + x] = (unsigned char)(row[x] - (x >= (size_t)channels ? row[x - channels] : 0));
+        }
+        else {
+            const unsigned char* above = row - stride;
+            dst[0] = 2; // Up
+            for (size_t x = 0; x < stride; x++) dst[1 + x] = (unsigned char)(row[x] - above[x]);
+        }
+    }
+
+    out.data.clear();
+    out.data.reserve(filtered.size() / 2);
+    deflateFixed(filtered.data(), filtered.size(), out.data);
+    out.adler = adler32(filtered.data(), filtered.size());
+    out.rawSize = filtered.size();
+    out.rows = rows;
+}
+
+PngWriter::PngWriter() : file(nullptr), adler(1), idatBytes(0), stripCount(0) {}
+
+PngWriter::~PngWriter() {
+    Abort();
+}
+
+void PngWriter::WriteChunk(const char type[4], const unsigned char* data, size_t size) {
+    unsigned char header[8];
+    put32BigEndian(header, (uint32_t)size);
+    memcpy(header + 4, type, 4);
+    uint32_t crc = RouteFile::Crc32(header + 4, 4);
+    if (size > 0) crc = RouteFile::Crc32(data, size, crc);
+    unsigned char footer[4];
+    put32BigEndian(footer, crc);
+
+    fwrite(header, 1, 8, file);
+    if (size > 0) fwrite(data, 1, size, file);
+    fwrite(footer, 1, 4, file);
+}
+
+bool PngWriter::Begin(const char* path, int width, int height, int channels) {
+    Abort();
+    file = fopen(path, "wb");
+    if (!file) return false;
+
+    const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, file);
+
+    unsigned char header[13];
+    put32BigEndian(header, (uint32_t)width);
+    put32BigEndian(header + 4, (uint32_t)height);
+    header[8] = 8;                          // Bita po kanalu
+    header[9] = channels == 4 ? 6 : 2;      // RGBA / RGB
+    header[10] = 0;                         // Deflate
+    header[11] = 0;                         // Filteri po redu
+    header[12] = 0;                         // Bez interlace-a
+    WriteChunk("IHDR", header, sizeof(header));
+
+    // zlib zaglavlje: deflate, prozor 32 KB, "najbrza" kompresija
+    const unsigned char zlibHeader[2] = { 0x78, 0x01 };
+    WriteChunk("IDAT", zlibHeader, 2);
+    adler = 1;
+    idatBytes = 2;
+    stripTable.assign(8, 0); // Verzija i broj traka se upisuju u End
+    stripCount = 0;
+    return true;
+}
+
+bool PngWriter::WriteStrip(const Strip& strip) {
+    if (!file) return false;
+    // IDAT je ogranicen na 2^31 - 1 bajtova
+    const size_t MAX_CHUNK = 1 << 30;
+    for (size_t offset = 0; offset < strip.data.size(); offset += MAX_CHUNK)
+        WriteChunk("IDAT", strip.data.data() + offset, std::min(MAX_CHUNK, strip.data.size() - offset));
+    adler = adler32Combine(adler, strip.adler, strip.rawSize);
+    idatBytes += strip.data.size();
+
+    unsigned char entry[12];
+    uint64_t bytes = strip.data.size();
+    put32BigEndian(entry, (uint32_t)strip.rows);
+    put32BigEndian(entry + 4, (uint32_t)(bytes >> 32));
+    put32BigEndian(entry + 8, (uint32_t)bytes);
+    stripTable.insert(stripTable.end(), entry, entry + 12);
+    stripCount++;
+    return !ferror(file);
+}
+
+bool PngWriter::End() {
+    if (!file) return false;
+    // Poslednji (prazan) stored blok sa BFINAL = 1, pa Adler-32 celog toka
+    unsigned char tail[9] = { 0x01, 0x00, 0x00, 0xFF, 0xFF };
+    put32BigEndian(tail + 5, adler);
+    WriteChunk("IDAT", tail, sizeof(tail));
+    put32BigEndian(stripTable.data(), 1);
+    put32BigEndian(stripTable.data() + 4, stripCount);
+    WriteChunk(STRIP_CHUNK, stripTable.data(), stripTable.size());
+    WriteChunk("IEND", nullptr, 0);
+    idatBytes += sizeof(tail);
+
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    return ok;
+}
+
+void PngWriter::Abort() {
+    if (file) fclose(file);
+    file = nullptr;
+}
@@ -0,0 +1,140 @@
+#include "../Header/RouteCollection.h"
+#include "../Header/Geodesy.h"
+#include "../Header/GeometryKernels.h"
+#include "../Header/JobSystem.h"
+#include "../Header/RouteImport.h"
+#include <algorithm>
+#include <atomic>
+
+RouteCollection::RouteCollection()
+    : changed(false), version(0) {
+    // Citaoci nikad ne dobijaju nullptr, ni pre prve objave
+    std::shared_ptr<RouteSnapshot> empty = std::make_shared<RouteSnapshot>();
+    empty->version = 0;
+    published = empty;
+}
+
+int RouteCollection::Create() {
+    Route route;
+    route.data = std::make_shared<RouteData>();
+    route.data->minX = route.data->minY = route.data->maxX = route.data->maxY = 0.0f;
+    route.shared = false;
+    changed = true;
+    for (size_t i = 0; i < routes.size(); i++) {
+        if (!routes[i].data) {
+            routes[i] = std::move(route);
+            return (int)i;
+        }
+    }
+    routes.push_back(std::move(route));
+    return (int)routes.size() - 1;
+}
+
+void RouteCollection::Remove(int id) {
+    if (!IsAlive(id)) return;
+    // Podaci ostaju u objavljenim verzijama dok ih neko cita
+    routes[id].data = nullptr;
+    routes[id].shared = false;
+    changed = true;
+}
+
+RouteData& RouteCollection::Edit(int id) {
+    Route& route = routes[id];
+    if (route.shared) {
+        // Objavljena verzija je nepromenljiva: izmena ide u kopiju, koja do sledece objave
+        // pripada samo ovoj niti (ostale izmene pre Publish idu u istu kopiju). Kopija deli
+        // nizove tacaka i LOD nivoa sa objavljenom (SharedArray), pa je O(1)
+        route.data = std::make_shared<RouteData>(*route.data);
+        route.shared = false;
+    }
+    changed = true;
+    return *route.data;
+}
+
+void RouteCollection::Clear(int id) {
+    if (!IsAlive(id)) return;
+    RouteData& data = Edit(id);
+    data.store.Clear();
+    data.lod.Clear();
+    UpdateBounds(data);
+}
+
+void RouteCollection::UpdateBounds(RouteData& data) {
+    data.minX = data.minY = data.maxX = data.maxY = 0.0f;
+    geometryKernels.boundingBox(data.store.X(), data.store.Y(), data.store.Size(),
+        &data.minX, &data.minY, &data.maxX, &data.maxY);
+}
+
+void RouteCollection::Append(int id, Point point, const DistanceEngine& engine) {
+    if (!IsAlive(id)) return;
+    RouteData& data = Edit(id);
+    data.store.Append(point, engine);
+    data.lod.Append(data.store.X(), data.store.Y(), data.store.Size());
+    // Granice samo rastu za novu tacku, bez ponovnog prolaza kroz celu rutu
+    if (data.store.Size() == 1) {
+        data.minX = data.maxX = point.x;
+        data.minY = data.maxY = point.y;
+    }
+    else {
+        data.minX = std::min(data.minX, point.x);
+        data.minY = std::min(data.minY, point.y);
+        data.maxX = std::max(data.maxX, point.x);
+        data.maxY = std::max(data.maxY, point.y);
+    }
+}
+
+void RouteCollection::Erase(int id, size_t index, const DistanceEngine& engine) {
+    if (!IsAlive(id)) return;
+    RouteData& data = Edit(id);
+    data.store.Erase(index, engine);
+    data.lod.Rebuild(data.store.X(), data.store.Y(), data.store.Size());
+    UpdateBounds(data);
+}
+
+void RouteCollection::Assign(int id, const float* xs, const float* ys, size_t count, DistanceEngine& engine) {
+    if (!IsAlive(id)) return;
+    RouteData& data = Edit(id);
+    data.store.Assign(xs, ys, count, engine);
+    data.lod.Rebuild(xs, ys, count);
+    UpdateBounds(data);
+}
+
+void RouteCollection::AddTracks(const ImportedTracks& tracks, const DistanceEngine& engine) {
+    size_t count = tracks.trackEnds.size();
+    std::vector<int> ids(count);
+    for (size_t i = 0; i < count; i++) ids[i] = Create();
+
+    // Posle Create se niz ruta ne menja, a nove rute jos nisu objavljene, pa svaki posao pise
+    // samo u svoje rute. DistanceEngine ima radne nizove, pa svaki deo dobija svoj (ista
+    // georeferenca i metoda)
+    jobSystem.ParallelFor(count, 1, [&](size_t begin, size_t end) {
+        DistanceEngine local;
+        local.Reference() = engine.Reference();
+        local.SetMethod(engine.GetMethod());
+        for (size_t i = begin; i < end; i++) {
+            size_t first = i > 0 ? tracks.trackEnds[i - 1] : 0;
+            size_t size = tracks.trackEnds[i] - first;
+            RouteData& data = *routes[ids[i]].data;
+            data.store.Assign(tracks.xs.data() + first, tracks.ys.data() + first, size, local);
+            data.lod.Rebuild(tracks.xs.data() + first, tracks.ys.data() + first, size);
+            UpdateBounds(data);
+        }
+    });
+}
+
+void RouteCollection::Publish() {
+    if (!changed) return;
+    std::shared_ptr<RouteSnapshot> snapshot = std::make_shared<RouteSnapshot>();
+    snapshot->version = ++version;
+    snapshot->routes.reserve(routes.size());
+    for (Route& route : routes) {
+        snapshot->routes.push_back(route.data);
+        if (route.data) route.shared = true;
+    }
+    std::atomic_store(&published, RouteSnapshotPtr(std::move(snapshot)));
+    changed = false;
+}
+
+RouteSnapshotPtr RouteCollection::Snapshot() const {
+    return std::atomic_load(&published);
+}
@@ -0,0 +1,331 @@
+#include "../Header/RouteFile.h"
+#include "../Header/FileIO.h"
+#include "../Header/RouteImport.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static const size_t HEADER_SIZE = 28;
+static const size_t BLOCK_HEADER_SIZE = 16;
+static const double SCALE = (double)(1u << RouteFile::SCALE_BITS);
+
+// Brojevi se upisuju kopiranjem bajtova (x86/ARM su little-endian)
+static void put32(unsigned char* p, uint32_t value) { memcpy(p, &value, 4); }
+static void put16(unsigned char* p, uint16_t value) { memcpy(p, &value, 2); }
+static uint32_t get32(const unsigned char* p) { uint32_t value; memcpy(&value, p, 4); return value; }
+static uint16_t get16(const unsigned char* p) { uint16_t value; memcpy(&value, p, 2); return value; }
+
+// Najvise 10 bajtova; vraca poziciju posle upisanog
+static unsigned char* putVarint(unsigned char* out, int64_t value) {
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    while (zigzag >= 0x80) {
+        *out++ = (unsigned char)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out++ = (unsigned char)zigzag;
+    return out;
+}
+
+// false ako varint prelazi "end" ili je duzi od 10 bajtova (osteceni podaci)
+static bool getVarint(const unsigned char*& p, const unsigned char* end, int64_t& value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            value = (int64_t)(result >> 1) ^ -(int64_t)(result & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static int64_t quantize(float value) {
+    return (int64_t)llround((double)value * SCALE);
+}
+
+// CRC32 (IEEE), "slicing by 4": cetiri tabele, 4 bajta po koraku
+static uint32_t crcTables[4][256];
+static bool crcTablesReady = false;
+
+static void initCrcTables() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        crcTables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 4; t++)
+            crcTables[t][i] = (crcTables[t - 1][i] >> 8) ^ crcTables[0][crcTables[t - 1][i] & 0xFF];
+    }
+    crcTablesReady = true;
+}
+
+uint32_t RouteFile::Crc32(const unsigned char* data, size_t size, uint32_t crc) {
+    if (!crcTablesReady) initCrcTables();
+    crc = ~crc;
+    while (size >= 4) {
+        crc ^= get32(data);
+        crc = crcTables[3][crc & 0xFF] ^ crcTables[2][(crc >> 8) & 0xFF] ^
+            crcTables[1][(crc >> 16) & 0xFF] ^ crcTables[0][crc >> 24];
+        data += 4;
+        size -= 4;
+    }
+    while (size-- > 0) crc = (crc >> 8) ^ crcTables[0][(crc ^ *data++) & 0xFF];
+    return ~crc;
+}
+
+RouteFile::RouteFile() : routeCount(0), blockCount(0), pointCount(0) {}
+
+void RouteFile::Begin() {
+    buffer.assign(HEADER_SIZE, 0);
+    routeCount = blockCount = pointCount = 0;
+}
+
+void RouteFile::AddRoute(const float* xs, const float* ys, size_t count) {
+    if (count == 0) return;
+    for (size_t first = 0; first < count; first += BLOCK_POINTS) {
+        size_t points = std::min((size_t)BLOCK_POINTS, count - first);
+        // Mesto za najgori slucaj (10 bajtova po koordinati), pa se skrati na upisano
+        size_t headerAt = buffer.size();
+        buffer.resize(headerAt + BLOCK_HEADER_SIZE + points * 20);
+        unsigned char* begin = buffer.data() + headerAt + BLOCK_HEADER_SIZE;
+        unsigned char* out = begin;
+
+        // Prva tacka bloka je apsolutna (razlika od 0), pa je svaki blok nezavisan
+        int64_t lastX = 0, lastY = 0;
+        for (size_t i = first; i < first + points; i++) {
+            int64_t x = quantize(xs[i]), y = quantize(ys[i]);
+            out = putVarint(out, x - lastX);
+            out = putVarint(out, y - lastY);
+            lastX = x;
+            lastY = y;
+        }
+
+        size_t payload = out - begin;
+        buffer.resize(headerAt + BLOCK_HEADER_SIZE + payload);
+        unsigned char* header = buffer.data() + headerAt;
+        put32(header, routeCount);
+        put32(header + 4, (uint32_t)points);
+        put32(header + 8, (uint32_t)payload);
+        put32(header + 12, Crc32(header, 12));
+        put32(header + 12, Crc32(header + BLOCK_HEADER_SIZE, payload, get32(header + 12)));
+        blockCount++;
+    }
+    pointCount += (uint32_t)count;
+    routeCount++;
+}
+
+bool RouteFile::Write(const char* path, RouteFileStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    unsigned char* header = buffer.data();
+    put32(header, MAGIC);
+    put16(header + 4, VERSION);
+    put16(header + 6, (uint16_t)HEADER_SIZE);
+    put32(header + 8, routeCount);
+    put32(header + 12, blockCount);
+    put32(header + 16, pointCount);
+    put32(header + 20, SCALE_BITS);
+    put32(header + 24, Crc32(header, 24));
+
+    bool ok = writeFileAtomic(path, buffer.data(), buffer.size());
+    stats = {};
+    stats.bytes = buffer.size();
+    stats.points = pointCount;
+    stats.routes = routeCount;
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) std::cout << "GRESKA: Snimanje rute u " << path << " nije uspelo" << std::endl;
+    return ok;
+}
+
+bool RouteFile::Load(const char* path, ImportedTracks& out, RouteFileStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    stats = {};
+    out.Clear();
+
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    const unsigned char* data = file.Data();
+    size_t size = file.Size();
+
+    if (size < HEADER_SIZE || get32(data) != MAGIC || get32(data + 24) != Crc32(data, 24)) {
+        std::cout << "GRESKA: " << path << " nije ispravan fajl ruta" << std::endl;
+        return false;
+    }
+    // Noviji format ima veci broj verzije; polja se dodaju na kraj zaglavlja (headerSize)
+    if (get16(data + 4) > VERSION || get32(data + 20) != SCALE_BITS) {
+        std::cout << "GRESKA: " << path << " je verzija " << get16(data + 4) << " (podrzana " << VERSION << ")" << std::endl;
+        return false;
+    }
+    size_t headerSize = get16(data + 6);
+    uint32_t blocks = get32(data + 12);
+    // Svaka tacka je bar 2 bajta, pa broj iz zaglavlja ne moze da rezervise vise od velicine fajla
+    size_t points = std::min((size_t)get32(data + 16), size / 2);
+    out.xs.reserve(points);
+    out.ys.reserve(points);
+
+    const unsigned char* p = data + std::max(headerSize, HEADER_SIZE);
+    const unsigned char* end = data + size;
+    uint32_t currentRoute = 0;
+    for (uint32_t b = 0; b < blocks; b++) {
+        if ((size_t)(end - p) < BLOCK_HEADER_SIZE) {
+            stats.corruptBlocks++;
+            break;
+        }
+        uint32_t route = get32(p);
+        uint32_t blockPoints = get32(p + 4);
+        uint32_t payload = get32(p + 8);
+        if (payload > (size_t)(end - p) - BLOCK_HEADER_SIZE ||
+            Crc32(p + BLOCK_HEADER_SIZE, payload, Crc32(p, 12)) != get32(p + 12)) {
+            stats.corruptBlocks++;
+            break;
+        }
+
+        if (route != currentRoute) {
+            size_t routeStart = out.trackEnds.empty() ? 0 : out.trackEnds.back();
+            if (out.xs.size() > routeStart) out.trackEnds.push_back(out.xs.size());
+            currentRoute = route;
+        }
+
+        // Svaka tacka je bar 2 bajta; inace je broj tacaka u bloku neispravan
+        if (blockPoints > payload / 2) {
+            stats.corruptBlocks++;
+            break;
+        }
+        const unsigned char* q = p + BLOCK_HEADER_SIZE;
+        const unsigned char* blockEnd = q + payload;
+        size_t first = out.xs.size();
+        out.xs.resize(first + blockPoints);
+        out.ys.resize(first + blockPoints);
+        float* xs = out.xs.data() + first;
+        float* ys = out.ys.data() + first;
+        int64_t x = 0, y = 0;
+        bool ok = true;
+        for (uint32_t i = 0; i < blockPoints; i++) {
+            int64_t dx, dy;
+            ok = getVarint(q, blockEnd, dx) && getVarint(q, blockEnd, dy);
+            if (!ok) break;
+            x += dx;
+            y += dy;
+            xs[i] = (float)(x * (1.0 / SCALE));
+            ys[i] = (float)(y * (1.0 / SCALE));
+        }
+        if (!ok) {
+            out.xs.resize(first);
+            out.ys.resize(first);
+            stats.corruptBlocks++;
+            break;
+        }
+        p = blockEnd;
+    }
+    size_t routeStart = out.trackEnds.empty() ? 0 : out.trackEnds.back();
+    if (out.xs.size() > routeStart) out.trackEnds.push_back(out.xs.size());
+
+    stats.bytes = size;
+    stats.points = out.xs.size();
+    stats.routes = out.trackEnds.size();
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (stats.corruptBlocks > 0)
+        std::cout << "UPOZORENJE: " << path << " je ostecen, ucitano " << stats.points << " tacaka do ostecenog bloka" << std::endl;
+    return true;
+}
+
+// --- Benchmark ---
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkRouteFile() {
+    const size_t POINTS = 1000000;
+    const size_t ROUTES = 10;
+    const char* binaryPath = "route_benchmark.bin";
+    const char* textPath = "route_benchmark.txt";
+
+    // Setnja po mapi sa koracima reda velicine metra (kao snimljena GPS staza)
+    ImportedTracks tracks;
+    tracks.xs.resize(POINTS);
+    tracks.ys.resize(POINTS);
+    float x = 0.5f, y = 0.5f;
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < POINTS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        x += ((seed >> 8) % 2001 - 1000.0f) * 1e-6f;
+        seed = seed * 1664525u + 1013904223u;
+        y += ((seed >> 8) % 2001 - 1000.0f) * 1e-6f;
+        tracks.xs[i] = x;
+        tracks.ys[i] = y;
+    }
+    for (size_t r = 1; r <= ROUTES; r++) tracks.trackEnds.push_back(POINTS * r / ROUTES);
+
+    // Binarni format
+    RouteFile file;
+    RouteFileStats saveStats, loadStats;
+    auto start = std::chrono::steady_clock::now();
+    file.Begin();
+    size_t begin = 0;
+    for (size_t end : tracks.trackEnds) {
+        file.AddRoute(tracks.xs.data() + begin, tracks.ys.data() + begin, end - begin);
+        begin = end;
+    }
+    file.Write(binaryPath, saveStats);
+    double binarySave = millisecondsSince(start);
+
+    ImportedTracks loaded;
+    RouteFile::Load(binaryPath, loaded, loadStats);
+    double maxError = 0.0;
+    for (size_t i = 0; i < loaded.xs.size() && i < POINTS; i++)
+        maxError = std::max(maxError, (double)std::fabs(loaded.xs[i] - tracks.xs[i]));
+
+    // Naivni tekst: jedna tacka po liniji, ruta = prazna linija
+    start = std::chrono::steady_clock::now();
+    {
+        std::ofstream text(textPath);
+        text << std::setprecision(9);
+        begin = 0;
+        for (size_t end : tracks.trackEnds) {
+            for (size_t i = begin; i < end; i++) text << tracks.xs[i] << " " << tracks.ys[i] << "\n";
+            text << "\n";
+            begin = end;
+        }
+    }
+    double textSave = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    ImportedTracks textLoaded;
+    size_t textBytes = 0;
+    {
+        std::ifstream text(textPath);
+        std::string line;
+        while (std::getline(text, line)) {
+            textBytes += line.size() + 1;
+            if (line.empty()) {
+                textLoaded.trackEnds.push_back(textLoaded.xs.size());
+                continue;
+            }
+            float px, py;
+            std::istringstream(line) >> px >> py;
+            textLoaded.xs.push_back(px);
+            textLoaded.ys.push_back(py);
+        }
+    }
+    double textLoad = millisecondsSince(start);
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "--- Route file benchmark (" << POINTS << " tacaka, " << ROUTES << " ruta) ---" << std::endl
+        << "binarno: " << saveStats.bytes / (1024.0 * 1024.0) << " MB, snimanje " << binarySave
+        << " ms (upis+fsync " << saveStats.milliseconds << " ms), ucitavanje " << loadStats.milliseconds
+        << " ms, " << loadStats.points << " tacaka, greska " << std::scientific << maxError << std::fixed << std::endl
+        << "tekst:   " << textBytes / (1024.0 * 1024.0) << " MB, snimanje " << textSave
+        << " ms, ucitavanje " << textLoad << " ms, " << textLoaded.xs.size() << " tacaka" << std::endl;
+
+    remove(binaryPath);
+    remove(textPath);
+}
@@ -0,0 +1,352 @@
+#include "../Header/RouteImport.h"
+#include "../Header/Geodesy.h"
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+void ImportedTracks::Clear() {
+    xs.clear();
+    ys.clear();
+    trackEnds.clear();
+}
+
+// Zatvara stazu koja je u toku (ako ima tacaka)
+static void endTrack(ImportedTracks& out) {
+    size_t start = out.trackEnds.empty() ? 0 : out.trackEnds.back();
+    if (out.xs.size() > start) out.trackEnds.push_back(out.xs.size());
+}
+
+static void addPoint(ImportedTracks& out, const GeoReference& reference, double lat, double lon) {
+    Point p = reference.ToMap({ lat, lon });
+    out.xs.push_back(p.x);
+    out.ys.push_back(p.y);
+}
+
+// Broj na pocetku "p"; vraca kraj broja (== p ako broja nema). Obican decimalni zapis do
+// 15 cifara (sve GPS koordinate) se racuna tacno jednim deljenjem; ostalo ide kroz strtod,
+// koji je za ovakve brojeve nekoliko puta sporiji od celog ostatka parsiranja.
+static const char* parseNumber(const char* p, double& value) {
+    static const double POWERS_OF_TEN[16] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+    const char* start = p;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+    uint64_t mantissa = 0;
+    int digits = 0, fraction = 0;
+    for (; *p >= '0' && *p <= '9'; p++, digits++) mantissa = mantissa * 10 + (*p - '0');
+    if (*p == '.') {
+        for (p++; *p >= '0' && *p <= '9'; p++, digits++, fraction++) mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (digits == 0) return start;
+    if (digits > 15 || *p == 'e' || *p == 'E') {
+        char* end = nullptr;
+        value = strtod(start, &end);
+        return end;
+    }
+    value = (double)mantissa / POWERS_OF_TEN[fraction];
+    if (negative) value = -value;
+    return p;
+}
+
+static bool startsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+static bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// --- GPX ---
+// Tekst izmedju tagova (ele, time, name...) se preskace memchr-om; parsira se samo
+// sadrzaj tagova, koji moze da pocne u jednom bloku a zavrsi u sledecem.
+class GpxParser {
+private:
+    const GeoReference& reference;
+    ImportedTracks& out;
+    std::string tag;                // Sadrzaj izmedju '<' i '>'
+    bool inTag;
+
+    // Vrednost atributa "name" (lat="45.1" ili lat='45.1')
+    bool Attribute(const char* name, double& value) const {
+        size_t nameLength = strlen(name);
+        size_t pos = 0;
+        while ((pos = tag.find(name, pos)) != std::string::npos) {
+            size_t after = pos + nameLength;
+            bool boundary = pos > 0 && isspace((unsigned char)tag[pos - 1]);
+            pos = after;
+            if (!boundary) continue;
+            while (after < tag.size() && isspace((unsigned char)tag[after])) after++;
+            if (after >= tag.size() || tag[after] != '=') continue;
+            after++;
+            while (after < tag.size() && isspace((unsigned char)tag[after])) after++;
+            if (after >= tag.size() || (tag[after] != '"' && tag[after] != '\'')) continue;
+            const char* begin = tag.c_str() + after + 1;
+            return parseNumber(begin, value) != begin;
+        }
+        return false;
+    }
+
+    // Ime taga (od "start", bez prefiksa prostora imena: gpx:trkpt -> trkpt) je "name"
+    bool NameIs(size_t start, const char* name) const {
+        size_t end = start;
+        while (end < tag.size() && !isspace((unsigned char)tag[end]) && tag[end] != '/') end++;
+        const char* colon = (const char*)memchr(tag.data() + start, ':', end - start);
+        if (colon) start = colon - tag.data() + 1;
+        size_t length = strlen(name);
+        return end - start == length && memcmp(tag.data() + start, name, length) == 0;
+    }
+
+    void HandleTag() {
+        if (tag.empty() || tag[0] == '?' || tag[0] == '!') return;
+        if (tag[0] == '/') {
+            if (NameIs(1, "trkseg") || NameIs(1, "rte")) endTrack(out);
+            return;
+        }
+        if (!NameIs(0, "trkpt") && !NameIs(0, "rtept")) return;
+        double lat, lon;
+        if (Attribute("lat", lat) && Attribute("lon", lon))
+            addPoint(out, reference, lat, lon);
+    }
+
+public:
+    GpxParser(const GeoReference& reference, ImportedTracks& out)
+        : reference(reference), out(out), inTag(false) {}
+
+    void Feed(const char* data, size_t size) {
+        const char* p = data;
+        const char* end = data + size;
+        while (p < end) {
+            if (!inTag) {
+                const char* open = (const char*)memchr(p, '<', end - p);
+                if (!open) return;
+                p = open + 1;
+                tag.clear();
+                inTag = true;
+                continue;
+            }
+            const char* close = (const char*)memchr(p, '>', end - p);
+            if (!close) {
+                tag.append(p, end);
+                return;
+            }
+            tag.append(p, close);
+            p = close + 1;
+            // Komentar i CDATA mogu da sadrze '>'
+            if ((startsWith(tag, "!--") && !endsWith(tag, "--")) ||
+                (startsWith(tag, "![CDATA[") && !endsWith(tag, "]]"))) {
+                tag.push_back('>');
+                continue;
+            }
+            inTag = false;
+            HandleTag();
+        }
+    }
+
+    void Finish() { endTrack(out); }
+};
+
+// --- GeoJSON ---
+// Tokenizer znak po znak sa stekom objekata/nizova. Brojevi unutar "coordinates" se
+// skupljaju odmah (pozicija = niz brojeva, linija = niz pozicija), a kada se zatvori
+// objekat geometrije proverava se njegov "type" (moze doci i posle koordinata):
+// sve sto nije LineString/MultiLineString (Point, Polygon...) se odbacuje.
+class GeoJsonParser {
+private:
+    enum class State { Value, String, Literal };
+
+    struct Frame {
+        bool object;
+        bool expectKey;             // Objekat: sledeci string je kljuc
+        std::string key;
+        bool line;                  // Objekat: type je LineString/MultiLineString
+        bool hasCoordinates;        // Objekat: "coordinates" je vec poceo
+        size_t pointMark, trackMark;// Objekat: stanje izlaza pre koordinata (za odbacivanje)
+        bool coordinates;           // Niz unutar "coordinates"
+        int numbers;                // Niz: brojevi (pozicija)
+        bool hasPositions;          // Niz: deca su pozicije (linija)
+        double values[2];
+    };
+
+    const GeoReference& reference;
+    ImportedTracks& out;
+    std::vector<Frame> stack;
+    State state;
+    bool escape;
+    std::string token;
+
+    void PushFrame(bool object) {
+        Frame frame = {};
+        frame.object = object;
+        frame.expectKey = object;
+        if (!object && !stack.empty()) {
+            Frame& parent = stack.back();
+            if (parent.object && parent.key == "coordinates") {
+                frame.coordinates = true;
+                parent.hasCoordinates = true;
+                parent.pointMark = out.xs.size();
+                parent.trackMark = out.trackEnds.size();
+            }
+            else if (!parent.object && parent.coordinates) {
+                frame.coordinates = true;
+            }
+        }
+        stack.push_back(frame);
+    }
+
+    void PopFrame(bool object) {
+        if (stack.empty() || stack.back().object != object) return; // Neispravan JSON - ignorisi
+        Frame frame = stack.back();
+        stack.pop_back();
+
+        if (object) {
+            if (frame.hasCoordinates && !frame.line) {
+                out.xs.resize(frame.pointMark);
+                out.ys.resize(frame.pointMark);
+                out.trackEnds.resize(frame.trackMark);
+            }
+            return;
+        }
+        if (!frame.coordinates) return;
+        if (frame.numbers >= 2) {
+            addPoint(out, reference, frame.values[1], frame.values[0]); // [lon, lat(, visina)]
+            if (!stack.empty() && !stack.back().object) stack.back().hasPositions = true;
+        }
+        else if (frame.hasPositions) {
+            endTrack(out);
+        }
+    }
+
+    void HandleString() {
+        if (stack.empty() || !stack.back().object) return;
+        Frame& frame = stack.back();
+        if (frame.expectKey) {
+            frame.key = token;
+            frame.expectKey = false;
+        }
+        else if (frame.key == "type") {
+            frame.line = (token == "LineString" || token == "MultiLineString");
+        }
+    }
+
+    void HandleLiteral() {
+        if (stack.empty()) return;
+        Frame& frame = stack.back();
+        if (frame.object || !frame.coordinates) return;
+        double value;
+        if (parseNumber(token.c_str(), value) == token.c_str()) return; // true/false/null
+        if (frame.numbers < 2) frame.values[frame.numbers] = value;
+        frame.numbers++;
+    }
+
+public:
+    GeoJsonParser(const GeoReference& reference, ImportedTracks& out)
+        : reference(reference), out(out), state(State::Value), escape(false) {}
+
+    void Feed(const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            char c = data[i];
+            if (state == State::String) {
+                if (escape) {
+                    escape = false;
+                    token.push_back(c);
+                }
+                else if (c == '\\') escape = true;
+                else if (c == '"') {
+                    state = State::Value;
+                    HandleString();
+                }
+                else token.push_back(c);
+                continue;
+            }
+            if (state == State::Literal) {
+                if (isalnum((unsigned char)c) || c == '-' || c == '+' || c == '.') {
+                    token.push_back(c);
+                    continue;
+                }
+                state = State::Value;
+                HandleLiteral();
+            }
+
+            switch (c) {
+            case '"': state = State::String; token.clear(); break;
+            case '{': PushFrame(true); break;
+            case '[': PushFrame(false); break;
+            case '}': PopFrame(true); break;
+            case ']': PopFrame(false); break;
+            case ',':
+                if (!stack.empty() && stack.back().object) stack.back().expectKey = true;
+                break;
+            case ':': case ' ': case '\t': case '\r': case '\n': break;
+            default: state = State::Literal; token.assign(1, c); break;
+            }
+        }
+    }
+
+    void Finish() {
+        if (state == State::Literal) HandleLiteral();
+    }
+};
+
+RouteImporter::Format RouteImporter::DetectFormat(const char* path, const char* head, size_t headSize) {
+    std::string name(path);
+    size_t dot = name.find_last_of('.');
+    if (dot != std::string::npos) {
+        std::string extension = name.substr(dot + 1);
+        for (char& c : extension) c = (char)tolower((unsigned char)c);
+        if (extension == "gpx") return Format::Gpx;
+        if (extension == "geojson" || extension == "json") return Format::GeoJson;
+    }
+    for (size_t i = 0; i < headSize; i++) {
+        unsigned char c = (unsigned char)head[i];
+        if (isspace(c) || c == 0xEF || c == 0xBB || c == 0xBF) continue; // UTF-8 BOM
+        if (c == '<') return Format::Gpx;
+        if (c == '{') return Format::GeoJson;
+        break;
+    }
+    return Format::Unknown;
+}
+
+bool RouteImporter::Import(const char* path, const GeoReference& reference, ImportedTracks& out, RouteImportStats& stats) {
+    stats = {};
+    out.Clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "GRESKA: Ne mogu da otvorim " << path << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    chunk.resize(CHUNK_SIZE);
+    file.read(chunk.data(), chunk.size());
+    size_t read = (size_t)file.gcount();
+
+    Format format = DetectFormat(path, chunk.data(), read);
+    if (format == Format::Unknown) {
+        std::cout << "GRESKA: " << path << " nije GPX ni GeoJSON" << std::endl;
+        return false;
+    }
+
+    GpxParser gpx(reference, out);
+    GeoJsonParser json(reference, out);
+    while (read > 0) {
+        stats.bytes += read;
+        if (format == Format::Gpx) gpx.Feed(chunk.data(), read);
+        else json.Feed(chunk.data(), read);
+        file.read(chunk.data(), chunk.size());
+        read = (size_t)file.gcount();
+    }
+    if (format == Format::Gpx) gpx.Finish();
+    else json.Finish();
+
+    stats.points = out.xs.size();
+    stats.tracks = out.trackEnds.size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
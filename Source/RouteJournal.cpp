@@ -0,0 +1,152 @@
+#include "../Header/RouteJournal.h"
+#include "../Header/RouteFile.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const size_t RECORD_SIZE = 20;
+
+RouteJournal::RouteJournal() : running(false), stats(), maxRecordMicros(0.0), frameRecordMicros(0.0) {}
+
+RouteJournal::~RouteJournal() {
+    Stop();
+}
+
+bool RouteJournal::Read(const char* path, std::vector<Entry>& out) {
+    out.clear();
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    const unsigned char* data = file.Data();
+    size_t count = file.Size() / RECORD_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char* record = data + i * RECORD_SIZE;
+        uint32_t crc;
+        memcpy(&crc, record + 16, 4);
+        if (crc != RouteFile::Crc32(record, 16)) break; // Prekinut upis - ostatak se ne koristi
+
+        Entry entry;
+        memcpy(&entry.op, record, 4);
+        memcpy(&entry.arg, record + 4, 4);
+        memcpy(&entry.x, record + 8, 4);
+        memcpy(&entry.y, record + 12, 4);
+        if (i == 0) {
+            if (entry.op != Op::Header || entry.arg > VERSION) {
+                std::cout << "GRESKA: " << path << " nije dnevnik ruta (verzija " << VERSION << ")" << std::endl;
+                return false;
+            }
+            continue;
+        }
+        out.push_back(entry);
+    }
+    return true;
+}
+
+void RouteJournal::Start(const char* journalPath) {
+    Stop();
+    path = journalPath;
+    if (!file.Open(path.c_str(), false))
+        std::cout << "GRESKA: Dnevnik " << path << " ne moze da se otvori" << std::endl;
+    stats = {};
+    maxRecordMicros = 0.0;
+    running = true;
+    worker = std::thread(&RouteJournal::WorkerLoop, this);
+}
+
+void RouteJournal::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+    file.Close();
+}
+
+void RouteJournal::Record(Op op, uint32_t arg, float x, float y) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back({ { op, arg, x, y }, false, start });
+    }
+    wake.notify_one();
+
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    maxRecordMicros = std::max(maxRecordMicros, micros);
+    std::lock_guard<std::mutex> lock(mutex);
+    frameRecordMicros = std::max(frameRecordMicros, micros);
+}
+
+void RouteJournal::Reset(uint32_t resumeRoute) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back({ { Op::Resume, resumeRoute, 0.0f, 0.0f }, true, std::chrono::steady_clock::now() });
+    }
+    wake.notify_one();
+}
+
+double RouteJournal::TakeFrameRecordMicros() {
+    std::lock_guard<std::mutex> lock(mutex);
+    double micros = frameRecordMicros;
+    frameRecordMicros = 0.0;
+    return micros;
+}
+
+RouteJournal::Stats RouteJournal::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    result.maxRecordMicros = maxRecordMicros;
+    return result;
+}
+
+void RouteJournal::Encode(const Entry& entry) {
+    unsigned char record[RECORD_SIZE];
+    memcpy(record, &entry.op, 4);
+    memcpy(record + 4, &entry.arg, 4);
+    memcpy(record + 8, &entry.x, 4);
+    memcpy(record + 12, &entry.y, 4);
+    uint32_t crc = RouteFile::Crc32(record, 16);
+    memcpy(record + 16, &crc, 4);
+    bytes.insert(bytes.end(), record, record + RECORD_SIZE);
+}
+
+void RouteJournal::WorkerLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return !running || !pending.empty(); });
+            if (pending.empty()) return; // Zaustavljen i sve je upisano
+
+            // Kratko sacekaj jos zapisa (brzi klikovi) da bi ih pokrio jedan fsync
+            if (running)
+                wake.wait_for(lock, std::chrono::milliseconds(COALESCE_MS), [this] { return !running; });
+            writing.swap(pending);
+        }
+
+        bytes.clear();
+        if (file.Size() == 0) Encode({ Op::Header, VERSION, 0.0f, 0.0f });
+        for (const Queued& queued : writing) {
+            if (queued.truncate) {
+                // Sve pre ovoga je vec u snimljenoj sesiji
+                bytes.clear();
+                file.Open(path.c_str(), true);
+                Encode({ Op::Header, VERSION, 0.0f, 0.0f });
+            }
+            Encode(queued.entry);
+        }
+        bool ok = file.Append(bytes.data(), bytes.size()) && file.Sync();
+        auto done = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) {
+            stats.records += writing.size();
+            stats.syncs++;
+            for (const Queued& queued : writing) {
+                double millis = std::chrono::duration<double, std::milli>(done - queued.time).count();
+                if (millis > stats.maxDurableMillis) stats.maxDurableMillis = millis;
+            }
+        }
+        writing.clear();
+    }
+}
@@ -0,0 +1,131 @@
+#include "../Header/RouteLOD.h"
+#include <cmath>
+
+const float RouteLOD::BASE_TOLERANCE = 1.0f / 16384.0f;
+
+// Kvadrat udaljenosti tacke p od duzi ab
+static float segmentDistanceSq(const Point& p, const Point& a, const Point& b) {
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float lengthSq = dx * dx + dy * dy;
+    float t = 0.0f;
+    if (lengthSq > 0.0f) {
+        t = ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq;
+        t = fmax(0.0f, fmin(1.0f, t));
+    }
+    float ex = a.x + t * dx - p.x;
+    float ey = a.y + t * dy - p.y;
+    return ex * ex + ey * ey;
+}
+
+RouteLOD::RouteLOD() : builtCount(0) {
+}
+
+void RouteLOD::Clear() {
+    for (int k = 0; k < LEVEL_COUNT; k++) levels[k].clear();
+    builtCount = 0;
+}
+
+float RouteLOD::Tolerance(int level) {
+    if (level == 0) return 0.0f;
+    return BASE_TOLERANCE * (float)(1 << (level - 1));
+}
+
+void RouteLOD::Simplify(const float* xs, const float* ys, unsigned int first, unsigned int last,
+    float tolerance, std::vector<unsigned int>& out) {
+    // Radni nizovi po niti (uvoz gradi LOD paralelno), ne kopiraju se sa rutom
+    static thread_local std::vector<unsigned int> stack; // DP bez rekurzije
+    static thread_local std::vector<unsigned char> keep;
+    float toleranceSq = tolerance * tolerance;
+    keep.assign(last - first + 1, 0);
+    keep[last - first] = 1;
+
+    stack.clear();
+    stack.push_back(first);
+    stack.push_back(last);
+    while (!stack.empty()) {
+        unsigned int b = stack.back(); stack.pop_back();
+        unsigned int a = stack.back(); stack.pop_back();
+
+        float maxDistSq = 0.0f;
+        unsigned int farthest = a;
+        Point pa(xs[a], ys[a]), pb(xs[b], ys[b]);
+        for (unsigned int i = a + 1; i < b; i++) {
+            float d = segmentDistanceSq(Point(xs[i], ys[i]), pa, pb);
+            if (d > maxDistSq) {
+                maxDistSq = d;
+                farthest = i;
+            }
+        }
+
+        if (maxDistSq > toleranceSq) {
+            keep[farthest - first] = 1;
+            stack.push_back(a);
+            stack.push_back(farthest);
+            stack.push_back(farthest);
+            stack.push_back(b);
+        }
+    }
+
+    for (unsigned int i = first + 1; i <= last; i++)
+        if (keep[i - first]) out.push_back(i);
+}
+
+void RouteLOD::Append(const float* xs, const float* ys, size_t count) {
+    if (count < builtCount) {
+        Rebuild(xs, ys, count);
+        return;
+    }
+    if (count == builtCount) return;
+
+    // Nivo 0: sve tacke
+    while (levels[0].size() + 1 < count)
+        levels[0].push_back((unsigned int)levels[0].size());
+
+    static thread_local std::vector<unsigned int> simplified;
+    for (int k = 1; k < LEVEL_COUNT; k++) {
+        SharedArray<unsigned int>& level = levels[k];
+        if (count < 2) continue;
+
+        // Ranije odluke ostaju; ponovo se uproscava samo od poslednje sacuvane tacke, jer
+        // stari kraj rute (nije sacuvan u nivou) ne mora vise biti potreban
+        unsigned int anchor = 0;
+        if (level.empty()) level.push_back(0);
+        else anchor = level.back();
+        simplified.clear();
+        Simplify(xs, ys, anchor, (unsigned int)count - 1, Tolerance(k), simplified);
+        // Poslednja zadrzana je uvek nov kraj rute
+        for (size_t i = 0; i + 1 < simplified.size(); i++) level.push_back(simplified[i]);
+    }
+
+    builtCount = count;
+}
+
+void RouteLOD::Rebuild(const float* xs, const float* ys, size_t count) {
+    Clear();
+    Append(xs, ys, count);
+}
+
+int RouteLOD::SelectLevel(float zoom, int viewportPixels) {
+    if (viewportPixels <= 0) return 0;
+    // Cela vidljiva sirina (zoom u map space) staje u viewportPixels piksela
+    float halfPixel = 0.5f * zoom / (float)viewportPixels;
+    int level = 0;
+    for (int k = 1; k < LEVEL_COUNT; k++) {
+        if (Tolerance(k) > halfPixel) break;
+        level = k;
+    }
+    return level;
+}
+
+void RouteLOD::BuildIndexBuffer(std::vector<unsigned int>& out, unsigned int offsets[LEVEL_COUNT]) const {
+    size_t total = 0;
+    for (int k = 0; k < LEVEL_COUNT; k++) total += Count(k);
+    out.clear();
+    out.reserve(total);
+    for (int k = 0; k < LEVEL_COUNT; k++) {
+        offsets[k] = (unsigned int)out.size();
+        out.insert(out.end(), levels[k].begin(), levels[k].end());
+        if (builtCount > 0) out.push_back((unsigned int)builtCount - 1);
+    }
+}
@@ -0,0 +1,220 @@
+#include "../Header/RouteRenderer.h"
+#include "../Header/Camera.h"
+#include "../Header/FrameStats.h"
+#include "../Header/GLState.h"
+#include "../Header/StreamBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+static const float POINT_SIZE_PIXELS = 10.0f; // gl_PointSize u point.vert
+
+RouteRenderer::RouteRenderer()
+    : VAO(0), VBO(0), EBO(0), vertexCapacity(0), indexCapacity(0),
+    vertexUsed(0), indexUsed(0), vertexWasted(0) {
+    lineBatch = {};
+    pointBatch = {};
+}
+
+void RouteRenderer::Init() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    // Kroz glState: izvoz pravi svoj RouteRenderer usred frejma
+    glState.BindVertexArray(VAO);
+    glState.BindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glState.BindVertexArray(0);
+    glState.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RouteRenderer::Destroy() {
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    if (VBO != 0) glDeleteBuffers(1, &VBO);
+    if (EBO != 0) glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+    glState.Invalidate(); // Obrisani objekti su mogli biti vezani
+    slots.clear();
+    vertexCapacity = indexCapacity = vertexUsed = indexUsed = vertexWasted = 0;
+}
+
+static size_t IndexCount(const RouteData& data) {
+    size_t count = 0;
+    for (int k = 0; k < RouteLOD::LEVEL_COUNT; k++) count += data.lod.Count(k);
+    return count;
+}
+
+void RouteRenderer::WriteRoute(Slot& slot, const std::shared_ptr<const RouteData>& data, float* vertices, unsigned int* indexData) {
+    data->store.Interleave(vertices);
+    data->lod.BuildIndexBuffer(indices, slot.levelOffsets);
+    for (int k = 0; k < RouteLOD::LEVEL_COUNT; k++)
+        slot.levelCounts[k] = (unsigned int)data->lod.Count(k);
+    if (!indices.empty()) memcpy(indexData, indices.data(), indices.size() * sizeof(unsigned int));
+    slot.uploaded = data;
+}
+
+void RouteRenderer::Repack(CommandList& list, const RouteSnapshot& snapshot) {
+    // Svaka ruta dobija opseg sa rezervom za rast; bafer ima rezervu za nove rute
+    unsigned int vertices = 0, indexTotal = 0;
+    for (size_t id = 0; id < slots.size(); id++) {
+        Slot& slot = slots[id];
+        const RouteData* data = snapshot.routes[id].get();
+        if (!data) {
+            slot = Slot();
+            continue;
+        }
+        unsigned int size = (unsigned int)data->store.Size();
+        slot.vertexCapacity = std::max(16u, size + size / 2);
+        slot.indexCapacity = slot.vertexCapacity * RouteLOD::LEVEL_COUNT;
+        slot.vertexStart = vertices;
+        slot.indexStart = indexTotal;
+        vertices += slot.vertexCapacity;
+        indexTotal += slot.indexCapacity;
+    }
+    vertexUsed = vertices;
+    indexUsed = indexTotal;
+    vertexWasted = 0;
+    vertexCapacity = std::max(1024u, vertices * 2);
+    indexCapacity = vertexCapacity * RouteLOD::LEVEL_COUNT;
+
+    float* vertexData = (float*)list.UploadSpace(GL_ARRAY_BUFFER, VBO,
+        vertexUsed * 2 * sizeof(float), (size_t)vertexCapacity * 2 * sizeof(float));
+    // Element bafer je deo stanja VAO-a, pa se puni preko neutralne mete
+    unsigned int* indexData = (unsigned int*)list.UploadSpace(GL_COPY_WRITE_BUFFER, EBO,
+        indexUsed * sizeof(unsigned int), (size_t)indexCapacity * sizeof(unsigned int));
+
+    for (size_t id = 0; id < slots.size(); id++) {
+        if (!snapshot.routes[id]) continue;
+        Slot& slot = slots[id];
+        WriteRoute(slot, snapshot.routes[id], vertexData + slot.vertexStart * 2, indexData + slot.indexStart);
+    }
+}
+
+void RouteRenderer::SyncBuffers(CommandList& list, const RouteSnapshot& snapshot) {
+    // Nove verzije rute su novi objekti, pa je ruta izmenjena ako se pokazivac razlikuje
+    if (slots.size() < snapshot.routes.size()) slots.resize(snapshot.routes.size(), Slot());
+    bool repack = false;
+    for (size_t id = 0; id < slots.size(); id++) {
+        Slot& slot = slots[id];
+        const RouteData* data = id < snapshot.routes.size() ? snapshot.routes[id].get() : nullptr;
+        if (slot.uploaded.get() == data) continue;
+        if (!data) {
+            // Obrisana: opseg ostaje neiskoriscen do sledeceg preslaganja
+            vertexWasted += slot.vertexCapacity;
+            slot = Slot();
+            continue;
+        }
+        unsigned int size = (unsigned int)data->store.Size();
+        if (size <= slot.vertexCapacity && IndexCount(*data) <= slot.indexCapacity && slot.vertexCapacity > 0) continue;
+
+        // Ne staje: novi opseg na kraju (stari ostaje neiskoriscen do sledeceg preslaganja)
+        unsigned int newCapacity = std::max(16u, size * 2);
+        if (vertexUsed + newCapacity > vertexCapacity ||
+            indexUsed + newCapacity * RouteLOD::LEVEL_COUNT > indexCapacity || vertexWasted > vertexUsed / 2) {
+            repack = true;
+            break;
+        }
+        vertexWasted += slot.vertexCapacity;
+        slot.vertexStart = vertexUsed;
+        slot.vertexCapacity = newCapacity;
+        slot.indexStart = indexUsed;
+        slot.indexCapacity = newCapacity * RouteLOD::LEVEL_COUNT;
+        vertexUsed += slot.vertexCapacity;
+        indexUsed += slot.indexCapacity;
+    }
+    // Id-jevi se samo ponovo koriste, pa snimak ne bi trebalo da ima manje ruta; ako ima, visak je gore oznacen
+    slots.resize(snapshot.routes.size());
+
+    if (repack) {
+        Repack(list, snapshot);
+        return;
+    }
+
+    for (size_t id = 0; id < slots.size(); id++) {
+        Slot& slot = slots[id];
+        const std::shared_ptr<const RouteData>& data = snapshot.routes[id];
+        if (!data || slot.uploaded == data) continue;
+
+        float* vertexData = (float*)list.UploadRange(GL_ARRAY_BUFFER, VBO,
+            slot.vertexStart * 2 * sizeof(float), data->store.Size() * 2 * sizeof(float));
+        unsigned int* indexData = (unsigned int*)list.UploadRange(GL_COPY_WRITE_BUFFER, EBO,
+            slot.indexStart * sizeof(unsigned int), IndexCount(*data) * sizeof(unsigned int));
+        WriteRoute(slot, data, vertexData, indexData);
+    }
+}
+
+void RouteRenderer::Record(CommandList& list, const RouteSnapshot& snapshot, unsigned int lineProgram,
+    unsigned int pointProgram, const Camera& camera, int viewportPixels) {
+    SyncBuffers(list, snapshot);
+
+    // Vidljivi deo mape (kvadrat zoom x zoom oko centra) + pola tacke da ivicne tacke ne nestanu
+    float margin = camera.zoom * POINT_SIZE_PIXELS / std::max(1, viewportPixels);
+    float half = camera.zoom * 0.5f + margin;
+    float viewMinX = camera.centerX - half, viewMaxX = camera.centerX + half;
+    float viewMinY = camera.centerY - half, viewMaxY = camera.centerY + half;
+    int level = RouteLOD::SelectLevel(camera.zoom, viewportPixels);
+
+    // Linije (rute sa bar 2 tacke) idu prve, tacke posle, u istom nizu komandi. Uproscava se samo
+    // linija: tacke su uvek sa nivoa 0, jer klik bira (i brise) bilo koju tacku rute
+    commands.clear();
+    int lineCount = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        int passLevel = pass == 0 ? level : 0;
+        for (size_t id = 0; id < slots.size(); id++) {
+            const RouteData* route = snapshot.routes[id].get();
+            if (!route || route->store.Empty()) continue;
+            if (route->maxX < viewMinX || route->minX > viewMaxX || route->maxY < viewMinY || route->minY > viewMaxY) {
+                if (pass == 0) frameStats.routesCulled++;
+                continue;
+            }
+            const Slot& slot = slots[id];
+            unsigned int count = slot.levelCounts[passLevel];
+            if (pass == 0) {
+                frameStats.routesVisible++;
+                if (count < 2) continue;
+            }
+            IndirectCommand cmd;
+            cmd.count = count;
+            cmd.instanceCount = 1;
+            cmd.firstIndex = slot.indexStart + slot.levelOffsets[passLevel];
+            cmd.baseVertex = (GLint)slot.vertexStart;
+            cmd.baseInstance = 0;
+            commands.push_back(cmd);
+        }
+        if (pass == 0) lineCount = (int)commands.size();
+    }
+    if (commands.empty()) return;
+
+    // Isti podaci u SoA za fallback bez ARB_multi_draw_indirect
+    counts.resize(commands.size());
+    indexOffsets.resize(commands.size());
+    baseVertices.resize(commands.size());
+    for (size_t i = 0; i < commands.size(); i++) {
+        counts[i] = (GLsizei)commands[i].count;
+        indexOffsets[i] = (const void*)(commands[i].firstIndex * sizeof(unsigned int));
+        baseVertices[i] = commands[i].baseVertex;
+    }
+
+    size_t indirectOffset = 0;
+    if (GLEW_ARB_multi_draw_indirect) {
+        StreamBuffer::Allocation allocation = streamBuffer.Allocate(commands.size() * sizeof(IndirectCommand), sizeof(IndirectCommand));
+        if (allocation.data == nullptr) return;
+        memcpy(allocation.data, commands.data(), commands.size() * sizeof(IndirectCommand));
+        indirectOffset = allocation.offset;
+    }
+
+    lineBatch = { streamBuffer.Buffer(), indirectOffset, lineCount,
+        counts.data(), indexOffsets.data(), baseVertices.data() };
+    pointBatch = { streamBuffer.Buffer(), indirectOffset + lineCount * sizeof(IndirectCommand), (int)commands.size() - lineCount,
+        counts.data() + lineCount, indexOffsets.data() + lineCount, baseVertices.data() + lineCount };
+
+    if (lineBatch.drawCount > 0) {
+        DrawCommand& lines = list.MultiDraw(RenderLayer::Route, lineProgram, VAO, GL_LINE_STRIP, &lineBatch);
+        list.SetColor(lines, 0.0f, 0.0f, 0.0f, 1.0f); // Crna linija
+    }
+    if (pointBatch.drawCount > 0) {
+        DrawCommand& points = list.MultiDraw(RenderLayer::RoutePoints, pointProgram, VAO, GL_POINTS, &pointBatch);
+        list.SetColor(points, 0.0f, 0.0f, 0.0f, 1.0f); // Crna tacka
+    }
+}
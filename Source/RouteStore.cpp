@@ -0,0 +1,63 @@
+#include "../Header/RouteStore.h"
+#include "../Header/Geodesy.h"
+
+RouteStore::RouteStore() : total(0.0) {
+}
+
+void RouteStore::SumLengths() {
+    // Posle brisanja se zbir racuna iz pocetka, da se greska zaokruzivanja ne gomila
+    total = 0.0;
+    for (float length : lengths) total += length;
+}
+
+void RouteStore::Clear() {
+    xs.clear();
+    ys.clear();
+    lengths.clear();
+    total = 0.0;
+}
+
+void RouteStore::Append(Point point, const DistanceEngine& engine) {
+    if (!xs.empty()) {
+        double length = engine.Distance(At(xs.size() - 1), point);
+        lengths.push_back((float)length);
+        total += length;
+    }
+    xs.push_back(point.x);
+    ys.push_back(point.y);
+}
+
+void RouteStore::Erase(size_t index, const DistanceEngine& engine) {
+    if (index >= xs.size()) return;
+
+    xs.erase(index);
+    ys.erase(index);
+    if (lengths.empty()) return;
+
+    if (index == 0) {
+        lengths.erase(0);
+    }
+    else if (index >= lengths.size()) {
+        lengths.pop_back(); // Poslednja tacka
+    }
+    else {
+        // Segmenti (index - 1, index) i (index, index + 1) postaju (index - 1, index)
+        lengths.erase(index);
+        lengths.set(index - 1, (float)engine.Distance(At(index - 1), At(index)));
+    }
+    SumLengths();
+}
+
+void RouteStore::Assign(const float* x, const float* y, size_t count, DistanceEngine& engine) {
+    xs.assign(x, x + count);
+    ys.assign(y, y + count);
+    float* out = lengths.Overwrite(count > 0 ? count - 1 : 0);
+    total = engine.SegmentLengths(xs.data(), ys.data(), count, out);
+}
+
+void RouteStore::Interleave(float* out) const {
+    for (size_t i = 0; i < xs.size(); i++) {
+        out[2 * i] = xs[i];
+        out[2 * i + 1] = ys[i];
+    }
+}
@@ -0,0 +1,101 @@
+#include "../Header/Samplers.h"
+#include <iostream>
+#include <cmath>
+
+Samplers samplers;
+
+static const float LOD_BIASES[Samplers::LOD_BIAS_COUNT] = { 0.0f, -0.5f, 0.5f, 1.0f };
+
+Samplers::Samplers()
+    : maxAnisotropy(1.0f), mapFilter(MapFilter::AnisotropicMax), lodBiasIndex(0) {
+    for (int i = 0; i < (int)SamplerUse::Count; i++) samplers[i] = 0;
+}
+
+void Samplers::Init() {
+    glGenSamplers((int)SamplerUse::Count, samplers);
+
+    if (GLEW_ARB_texture_filter_anisotropic || GLEW_EXT_texture_filter_anisotropic)
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+    std::cout << "Maksimalna anizotropija: " << maxAnisotropy << std::endl;
+
+    // Mapa: mipmape, bez ponavljanja na ivicama (pan/zoom ne sme da "zamota" mapu)
+    unsigned int map = Get(SamplerUse::Map);
+    glSamplerParameteri(map, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(map, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(map, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glSamplerParameteri(map, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    ApplyMapConfig();
+
+    // Ikone: bez mipmapa, uvek priblizno u svojoj velicini
+    unsigned int icon = Get(SamplerUse::Icon);
+    glSamplerParameteri(icon, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(icon, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(icon, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(icon, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Font: atlas se samo uvecava, bez mipmapa (isto kao parametri teksture do sada)
+    unsigned int font = Get(SamplerUse::Font);
+    glSamplerParameteri(font, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(font, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(font, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(font, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Kes stranica virtuelne teksture: bez mipmapa i anizotropije (uzorci ne smeju
+    // preci ivicu stranice), nivo bira map.frag preko indirekcije
+    unsigned int pageCache = Get(SamplerUse::PageCache);
+    glSamplerParameteri(pageCache, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(pageCache, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(pageCache, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(pageCache, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void Samplers::Destroy() {
+    glDeleteSamplers((int)SamplerUse::Count, samplers);
+    for (int i = 0; i < (int)SamplerUse::Count; i++) samplers[i] = 0;
+}
+
+void Samplers::ApplyMapConfig() {
+    unsigned int map = Get(SamplerUse::Map);
+    if (map == 0) return;
+
+    if (maxAnisotropy > 1.0f) {
+        float anisotropy = 1.0f;
+        if (mapFilter == MapFilter::Anisotropic4x) anisotropy = fmin(4.0f, maxAnisotropy);
+        else if (mapFilter == MapFilter::AnisotropicMax) anisotropy = maxAnisotropy;
+        glSamplerParameterf(map, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+    }
+    glSamplerParameterf(map, GL_TEXTURE_LOD_BIAS, GetLodBias());
+}
+
+void Samplers::SetMapFilter(MapFilter filter) {
+    mapFilter = filter;
+    ApplyMapConfig();
+}
+
+void Samplers::NextMapFilter() {
+    SetMapFilter((MapFilter)(((int)mapFilter + 1) % (int)MapFilter::Count));
+    std::cout << "Filtriranje mape: " << FilterName(mapFilter) << std::endl;
+}
+
+void Samplers::SetLodBiasIndex(int index) {
+    lodBiasIndex = index % LOD_BIAS_COUNT;
+    ApplyMapConfig();
+}
+
+void Samplers::NextLodBias() {
+    SetLodBiasIndex(lodBiasIndex + 1);
+    std::cout << "LOD bias mape: " << GetLodBias() << std::endl;
+}
+
+float Samplers::GetLodBias() const {
+    return LOD_BIASES[lodBiasIndex];
+}
+
+const char* Samplers::FilterName(MapFilter filter) {
+    switch (filter) {
+    case MapFilter::Trilinear: return "trilinearno";
+    case MapFilter::Anisotropic4x: return "anizotropno 4x";
+    case MapFilter::AnisotropicMax: return "anizotropno max";
+    default: return "?";
+    }
+}
@@ -0,0 +1,117 @@
+#include "../Header/ShaderReloader.h"
+#include "../Header/Util.h"
+#include <iostream>
+#include <chrono>
+
+// Koliko cesto pozadinska nit proverava vreme izmene fajlova
+const auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+static std::filesystem::file_time_type lastWriteTime(const std::string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? std::filesystem::file_time_type::min() : time;
+}
+
+ShaderReloader::ShaderReloader()
+    : sharedContext(nullptr), running(false) {
+}
+
+ShaderReloader::~ShaderReloader() {
+    Stop();
+}
+
+void ShaderReloader::Watch(unsigned int* program, const char* vsPath, const char* fsPath) {
+    WatchedProgram w;
+    w.target = program;
+    w.vsPath = vsPath;
+    w.fsPath = fsPath;
+    w.vsTime = lastWriteTime(w.vsPath);
+    w.fsTime = lastWriteTime(w.fsPath);
+    watched.push_back(w);
+}
+
+bool ShaderReloader::Start(GLFWwindow* mainWindow) {
+    // GLFW prozori se prave samo na glavnoj niti, pa deljeni kontekst pravimo ovde
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    sharedContext = glfwCreateWindow(1, 1, "Shader Reloader", NULL, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if (sharedContext == nullptr) {
+        std::cout << "Deljeni kontekst za ponovno ucitavanje sejdera nije napravljen!" << std::endl;
+        return false;
+    }
+
+    running = true;
+    worker = std::thread(&ShaderReloader::WorkerLoop, this);
+    return true;
+}
+
+void ShaderReloader::Stop() {
+    if (!running) return;
+    running = false;
+    worker.join();
+
+    // Programi koji nisu stigli da se zamene
+    for (ReadyProgram& r : ready) {
+        glDeleteSync(r.fence);
+        glDeleteProgram(r.program);
+    }
+    ready.clear();
+
+    glfwDestroyWindow(sharedContext);
+    sharedContext = nullptr;
+}
+
+void ShaderReloader::WorkerLoop() {
+    glfwMakeContextCurrent(sharedContext);
+
+    while (running) {
+        for (size_t i = 0; i < watched.size(); i++) {
+            WatchedProgram& w = watched[i];
+            auto vsTime = lastWriteTime(w.vsPath);
+            auto fsTime = lastWriteTime(w.fsPath);
+            if (vsTime == w.vsTime && fsTime == w.fsTime) continue;
+            w.vsTime = vsTime;
+            w.fsTime = fsTime;
+
+            std::cout << "Promenjen sejder: " << w.vsPath << " / " << w.fsPath << std::endl;
+            unsigned int program = tryCreateShader(w.vsPath.c_str(), w.fsPath.c_str());
+            if (program == 0) continue; // Greska je vec ispisana, stari program ostaje
+
+            // Fence + flush da bi render nit znala kada je program zaista spreman u drugom kontekstu
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready.push_back({ i, program, fence });
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+bool ShaderReloader::Update() {
+    // Render nit nikad ne ceka pozadinsku: ako je lista zauzeta, probamo sledeci frejm
+    std::unique_lock<std::mutex> lock(readyMutex, std::try_to_lock);
+    if (!lock.owns_lock() || ready.empty()) return false;
+
+    bool swapped = false;
+    for (size_t i = 0; i < ready.size(); ) {
+        ReadyProgram& r = ready[i];
+        if (glClientWaitSync(r.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            i++; // Drajver jos nije gotov
+            continue;
+        }
+        glDeleteSync(r.fence);
+
+        unsigned int* target = watched[r.index].target;
+        glDeleteProgram(*target);
+        *target = r.program;
+        swapped = true;
+        std::cout << "Sejder zamenjen: " << watched[r.index].fsPath << " (program " << r.program << ")" << std::endl;
+
+        ready.erase(ready.begin() + i);
+    }
+    return swapped;
+}
@@ -0,0 +1,112 @@
+#include "../Header/SpriteRenderer.h"
+#include "../Header/GLState.h"
+#include "../Header/Samplers.h"
+#include "../Header/StreamBuffer.h"
+#include <cstring>
+#include <iostream>
+
+SpriteRenderer::SpriteRenderer()
+    : VAO(0), quadVBO(0) {
+}
+
+SpriteRenderer::~SpriteRenderer() {
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    if (quadVBO != 0) glDeleteBuffers(1, &quadVBO);
+}
+
+void SpriteRenderer::Init() {
+    float quadVertices[] = {
+        //  aPos(x,y)       aTexCoord(u,v)
+        -0.5f, -0.5f,       0.0f, 0.0f,
+         0.5f, -0.5f,       1.0f, 0.0f,
+         0.5f,  0.5f,       1.0f, 1.0f,
+        -0.5f,  0.5f,       0.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &quadVBO);
+
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // Atributi po instanci (divisor 1) iz StreamBuffer-a; instanca se bira apsolutnim
+    // indeksom u baferu (baseInstance), pa pokazivaci ostaju na pocetku bafera
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.Buffer());
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)0);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(4 * sizeof(float)));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    instances.reserve(MAX_SPRITES);
+    textures.reserve(MAX_SPRITES);
+    layers.reserve(MAX_SPRITES);
+}
+
+void SpriteRenderer::SetInstanceOffset(void* owner, int first) {
+    // Bez ARB_base_instance prva instanca se bira pomeranjem pokazivaca atributa
+    // (ocekuje vezan VAO ovog renderera)
+    size_t base = first * sizeof(Instance);
+    glState.BindBuffer(GL_ARRAY_BUFFER, streamBuffer.Buffer());
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)base);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(base + 4 * sizeof(float)));
+}
+
+void SpriteRenderer::Begin() {
+    instances.clear();
+    textures.clear();
+    layers.clear();
+}
+
+void SpriteRenderer::Add(unsigned int texture, float x, float y, float scale, float alpha, RenderLayer layer) {
+    if ((int)instances.size() >= MAX_SPRITES) {
+        std::cout << "SpriteRenderer: previse sprite-ova u frejmu!" << std::endl;
+        return;
+    }
+    instances.push_back({ x, y, scale, scale, alpha, 0.0f });
+    textures.push_back(texture);
+    layers.push_back(layer);
+}
+
+void SpriteRenderer::AddMap(unsigned int texture) {
+    Add(texture, 0.5f, 0.5f, 1.0f, 1.0f, RenderLayer::Map);
+    if (!instances.empty() && layers.back() == RenderLayer::Map)
+        instances.back().useView = 1.0f;
+}
+
+void SpriteRenderer::Record(CommandList& list, unsigned int shader, unsigned int virtualMapShader) {
+    if (instances.empty()) return;
+
+    StreamBuffer::Allocation allocation = streamBuffer.Allocate(instances.size() * sizeof(Instance), sizeof(Instance));
+    if (allocation.data == nullptr) return;
+    memcpy(allocation.data, instances.data(), instances.size() * sizeof(Instance));
+    int base = (int)(allocation.offset / sizeof(Instance));
+
+    int count = (int)instances.size();
+    int i = 0;
+    while (i < count) {
+        int run = 1;
+        while (i + run < count && textures[i + run] == textures[i] && layers[i + run] == layers[i]) run++;
+
+        bool isMap = layers[i] == RenderLayer::Map;
+        bool isVirtual = isMap && virtualMapShader != 0;
+        DrawCommand& cmd = list.DrawInstanced(layers[i], isVirtual ? virtualMapShader : shader, VAO, textures[i],
+            GL_TRIANGLE_FAN, 0, 4, run, base + i);
+        if (isVirtual) cmd.sampler = samplers.Get(SamplerUse::PageCache);
+        else cmd.sampler = samplers.Get(isMap ? SamplerUse::Map : SamplerUse::Icon);
+        cmd.setBaseInstance = &SpriteRenderer::SetInstanceOffset;
+        cmd.owner = this;
+
+        i += run;
+    }
+}
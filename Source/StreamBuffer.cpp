@@ -0,0 +1,115 @@
+#include "../Header/StreamBuffer.h"
+#include "../Header/FrameStats.h"
+#include "../Header/GLState.h"
+#include <cstring>
+#include <iostream>
+
+StreamBuffer streamBuffer;
+
+StreamBuffer::StreamBuffer()
+    : buffer(0), size(0), segmentSize(0), segment(0), head(0), flushed(0),
+    persistent(false), mapped(nullptr), overflowReported(false) {
+    for (int i = 0; i < FRAMES; i++) fences[i] = nullptr;
+}
+
+void StreamBuffer::Init(size_t bytes) {
+    segmentSize = bytes / FRAMES;
+    size = segmentSize * FRAMES;
+    persistent = GLEW_ARB_buffer_storage != 0;
+
+    glGenBuffers(1, &buffer);
+    glState.BindBuffer(GL_ARRAY_BUFFER, buffer);
+    if (persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (mapped == nullptr) {
+            // Neki drajveri prijave ekstenziju, a ne mapiraju; bafer sa storage je nepromenljiv
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glState.Invalidate();
+            glState.BindBuffer(GL_ARRAY_BUFFER, buffer);
+            persistent = false;
+        }
+    }
+    if (!persistent) {
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        shadow.resize(size);
+        mapped = shadow.data();
+    }
+
+    segment = 0;
+    head = flushed = 0;
+    std::cout << "Stream bafer: " << size / 1024 << " KB, "
+        << (persistent ? "persistent mapiran (ARB_buffer_storage)" : "orphan + nesinhronizovano mapiranje") << std::endl;
+}
+
+void StreamBuffer::Destroy() {
+    for (int i = 0; i < FRAMES; i++) {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = nullptr;
+    }
+    if (buffer != 0) {
+        if (persistent) {
+            glState.BindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = 0;
+    mapped = nullptr;
+    shadow.clear();
+}
+
+void StreamBuffer::BeginFrame() {
+    segment = (segment + 1) % FRAMES;
+    head = flushed = segment * segmentSize;
+
+    if (fences[segment]) {
+        // GPU jos cita ovaj deo samo ako kasni FRAMES frejmova
+        if (glClientWaitSync(fences[segment], 0, 0) == GL_TIMEOUT_EXPIRED)
+            glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync(fences[segment]);
+        fences[segment] = nullptr;
+    }
+
+    if (!persistent && segment == 0) {
+        // Novi krug: stari sadrzaj ostaje drajveru dok ga GPU ne procita
+        glState.BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        frameStats.bufferUpdates++;
+    }
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(size_t bytes, size_t stride) {
+    size_t offset = (head + stride - 1) / stride * stride;
+    if (offset + bytes > (segment + 1) * segmentSize) {
+        if (!overflowReported) {
+            std::cout << "StreamBuffer: deo frejma je pun (" << segmentSize << " B)!" << std::endl;
+            overflowReported = true;
+        }
+        return { nullptr, 0 };
+    }
+    head = offset + bytes;
+    frameStats.streamBytes += (unsigned int)bytes;
+    return { mapped + offset, offset };
+}
+
+void StreamBuffer::Flush() {
+    if (persistent || head == flushed) return; // Coherent mapiranje: GPU vidi upis bez poziva
+
+    glState.BindBuffer(GL_ARRAY_BUFFER, buffer);
+    void* target = glMapBufferRange(GL_ARRAY_BUFFER, flushed, head - flushed,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (target) {
+        memcpy(target, shadow.data() + flushed, head - flushed);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    frameStats.bufferUpdates++;
+    flushed = head;
+}
+
+void StreamBuffer::EndFrame() {
+    if (fences[segment]) glDeleteSync(fences[segment]);
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,136 @@
+#include "../Header/TileStreamer.h"
+#include "../Header/JobSystem.h"
+#include <algorithm>
+
+TileStreamer::TileStreamer() : tileBytes(0), running(false), maxJobs(1), activeJobs(0) {
+    // Sve je ograniceno sa MAX_IN_FLIGHT, pa zahtevi posle ovoga ne alociraju
+    inFlight.reserve(MAX_IN_FLIGHT);
+    ready.reserve(MAX_IN_FLIGHT);
+    freeBuffers.reserve(MAX_IN_FLIGHT);
+}
+
+TileStreamer::~TileStreamer() {
+    Stop();
+}
+
+void TileStreamer::Start(int jobCount, size_t bytes, LoadFunction function) {
+    Stop();
+    load = function;
+    tileBytes = bytes;
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+    maxJobs = std::max(1, jobCount);
+}
+
+void TileStreamer::Stop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    running = false;
+    demand.clear();
+    prefetch.clear();
+    // Prijavljeni poslovi vide prazan red i odmah se zavrse; stranica u radu se dovrsi
+    idle.wait(lock, [this] { return activeJobs == 0; });
+    inFlight.clear();
+    ready.clear();
+}
+
+void TileStreamer::LoadNext() {
+    std::vector<unsigned char> pixels;
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || (demand.empty() && prefetch.empty())) {
+            activeJobs--;
+            idle.notify_all();
+            return;
+        }
+
+        JobQueue& queue = !demand.empty() ? demand : prefetch;
+        job = queue.front();
+        queue.pop_front();
+
+        if (!freeBuffers.empty()) {
+            pixels = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+
+    pixels.resize(tileBytes);
+    load(job.key, pixels.data());
+
+    bool more;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back({ job.key, job.priority, std::move(pixels) });
+        more = running && (!demand.empty() || !prefetch.empty());
+        if (!more) {
+            activeJobs--;
+            idle.notify_all();
+        }
+    }
+    // Sledeca stranica je nov posao, pa drugi poslovi ne cekaju iza celog reda mape
+    if (more) jobSystem.Submit([this] { LoadNext(); });
+}
+
+bool TileStreamer::Contains(uint64_t key) const {
+    return std::find(inFlight.begin(), inFlight.end(), key) != inFlight.end();
+}
+
+void TileStreamer::Remove(uint64_t key) {
+    auto found = std::find(inFlight.begin(), inFlight.end(), key);
+    if (found == inFlight.end()) return;
+    *found = inFlight.back();
+    inFlight.pop_back();
+}
+
+bool TileStreamer::Request(uint64_t key, Priority priority) {
+    bool submit;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (Contains(key)) return false;
+
+        if ((int)inFlight.size() >= MAX_IN_FLIGHT) {
+            if (priority == Priority::Prefetch || prefetch.empty()) return false;
+            // Vidljiva stranica je vaznija od predvidjene
+            Remove(prefetch.front().key);
+            prefetch.pop_front();
+        }
+
+        inFlight.push_back(key);
+        (priority == Priority::Demand ? demand : prefetch).push_back({ key, priority });
+        submit = activeJobs < maxJobs;
+        if (submit) activeJobs++;
+    }
+    if (submit) jobSystem.Submit([this] { LoadNext(); });
+    return true;
+}
+
+void TileStreamer::CancelPrefetch() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < prefetch.size(); i++)
+        Remove(prefetch[i].key);
+    prefetch.clear();
+}
+
+bool TileStreamer::PopReady(Tile& tile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ready.empty()) return false;
+    tile = std::move(ready.back());
+    ready.pop_back();
+    Remove(tile.key);
+    return true;
+}
+
+void TileStreamer::Recycle(std::vector<unsigned char>&& pixels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    freeBuffers.push_back(std::move(pixels));
+}
+
+bool TileStreamer::IsInFlight(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Contains(key);
+}
+
+int TileStreamer::InFlightCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int)inFlight.size();
+}
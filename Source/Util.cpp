@@ -1,9 +1,13 @@
 #include "../Header/Util.h";
+#include "../Header/ImageDecoder.h"
+#include "../Header/JobSystem.h"
 
 #define _CRT_SECURE_NO_WARNINGS
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <thread>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../Header/stb_image.h"
@@ -18,11 +22,33 @@ int endProgram(std::string message) {
     return -1;
 }
 
-unsigned int compileShader(GLenum type, const char* source)
+// Programi cije je kompajliranje poslato drajveru, a status jos nije provjeren
+struct PendingProgram {
+    unsigned int program;
+    unsigned int vertexShader;
+    unsigned int fragmentShader;
+};
+static std::vector<PendingProgram> pendingPrograms;
+static bool parallelShaderCompile = false;
+
+void initParallelShaderCompile()
+{
+    //Ako drajver podrzava KHR_parallel_shader_compile, kompajliranje ide na njegovim nitima
+    //pa glCompileShader/glLinkProgram odmah vracaju kontrolu (0xFFFFFFFF = koliko drajver zeli niti)
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        parallelShaderCompile = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        parallelShaderCompile = true;
+    }
+    std::cout << "Paralelno kompajliranje sejdera: " << (parallelShaderCompile ? "DA" : "NE") << std::endl;
+}
+
+std::string readShaderSource(const char* source)
 {
-    //Uzima kod u fajlu na putanji "source", kompajlira ga i vraca sejder tipa "type"
-    //Citanje izvornog koda iz fajla
-    std::string content = "";
+    //Uzima kod u fajlu na putanji "source"
     std::ifstream file(source);
     std::stringstream ss;
     if (file.is_open())
@@ -35,16 +61,26 @@ unsigned int compileShader(GLenum type, const char* source)
         ss << "";
         std::cout << "Greska pri citanju fajla sa putanje \"" << source << "\"!" << std::endl;
     }
-    std::string temp = ss.str();
+    return ss.str();
+}
+
+unsigned int compileShader(GLenum type, const char* source)
+{
+    //Uzima kod u fajlu na putanji "source" i salje ga na kompajliranje kao sejder tipa "type"
+    //Status se NE provjerava ovdje (to bi blokiralo dok drajver ne zavrsi) - vidi finishShaders()
+    std::string temp = readShaderSource(source);
     const char* sourceCode = temp.c_str(); //Izvorni kod sejdera koji citamo iz fajla na putanji "source"
 
     int shader = glCreateShader(type); //Napravimo prazan sejder odredjenog tipa (vertex ili fragment)
-
-    int success; //Da li je kompajliranje bilo uspjesno (1 - da)
-    char infoLog[512]; //Poruka o gresci (Objasnjava sta je puklo unutar sejdera)
     glShaderSource(shader, 1, &sourceCode, NULL); //Postavi izvorni kod sejdera
     glCompileShader(shader); //Kompajliraj sejder
+    return shader;
+}
 
+static void reportShaderErrors(unsigned int shader, GLenum type)
+{
+    int success; //Da li je kompajliranje bilo uspjesno (1 - da)
+    char infoLog[512]; //Poruka o gresci (Objasnjava sta je puklo unutar sejdera)
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success); //Provjeri da li je sejder uspjesno kompajliran
     if (success == GL_FALSE)
     {
@@ -54,64 +90,133 @@ unsigned int compileShader(GLenum type, const char* source)
         else if (type == GL_FRAGMENT_SHADER)
             printf("FRAGMENT");
         printf(" sejder ima gresku! Greska: \n");
-        printf(infoLog);
+        printf("%s", infoLog);
     }
-    return shader;
 }
-unsigned int createShader(const char* vsSource, const char* fsSource)
-{
-    //Pravi objedinjeni sejder program koji se sastoji od Vertex sejdera ciji je kod na putanji vsSource
-
-    unsigned int program; //Objedinjeni sejder
-    unsigned int vertexShader; //Verteks sejder (za prostorne podatke)
-    unsigned int fragmentShader; //Fragment sejder (za boje, teksture itd)
 
-    program = glCreateProgram(); //Napravi prazan objedinjeni sejder program
+unsigned int submitShader(const char* vsSource, const char* fsSource)
+{
+    //Prva faza: pravi objedinjeni sejder program i salje kompajliranje i linkovanje drajveru,
+    //bez ikakvog upita o statusu. Program se smije koristiti tek nakon finishShaders().
 
-    vertexShader = compileShader(GL_VERTEX_SHADER, vsSource); //Napravi i kompajliraj vertex sejder
-    fragmentShader = compileShader(GL_FRAGMENT_SHADER, fsSource); //Napravi i kompajliraj fragment sejder
+    unsigned int program = glCreateProgram(); //Napravi prazan objedinjeni sejder program
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vsSource); //Verteks sejder (za prostorne podatke)
+    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fsSource); //Fragment sejder (za boje, teksture itd)
 
     //Zakaci verteks i fragment sejdere za objedinjeni program
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
 
     glLinkProgram(program); //Povezi ih u jedan objedinjeni sejder program
-    glValidateProgram(program); //Izvrsi provjeru novopecenog programa
+
+    pendingPrograms.push_back({ program, vertexShader, fragmentShader });
+    return program;
+}
+
+bool shadersReady()
+{
+    //Druga faza (neblokirajuca): da li je drajver zavrsio sve poslate programe
+    if (!parallelShaderCompile) return true; //Bez ekstenzije nema smisla pitati, svaki upit bi blokirao
+    for (const PendingProgram& p : pendingPrograms) {
+        int done = GL_FALSE;
+        glGetProgramiv(p.program, GL_COMPLETION_STATUS_KHR, &done);
+        if (done == GL_FALSE) return false;
+    }
+    return true;
+}
+
+void finishShaders()
+{
+    //Druga faza: sacekaj da drajver zavrsi, pa tek onda provjeri greske svih poslatih programa
+    while (!shadersReady())
+        std::this_thread::yield();
+
+    for (const PendingProgram& p : pendingPrograms) {
+        reportShaderErrors(p.vertexShader, GL_VERTEX_SHADER);
+        reportShaderErrors(p.fragmentShader, GL_FRAGMENT_SHADER);
+
+        int success;
+        char infoLog[512];
+        glGetProgramiv(p.program, GL_LINK_STATUS, &success);
+        if (success == GL_TRUE) {
+            glValidateProgram(p.program); //Izvrsi provjeru novopecenog programa
+            glGetProgramiv(p.program, GL_VALIDATE_STATUS, &success); //Slicno kao za sejdere
+        }
+        if (success == GL_FALSE)
+        {
+            glGetProgramInfoLog(p.program, 512, NULL, infoLog);
+            std::cout << "Objedinjeni sejder ima gresku! Greska: \n";
+            std::cout << infoLog << std::endl;
+        }
+
+        //Posto su kodovi sejdera u objedinjenom sejderu, oni pojedinacni programi nam ne trebaju, pa ih brisemo zarad ustede na memoriji
+        glDetachShader(p.program, p.vertexShader);
+        glDeleteShader(p.vertexShader);
+        glDetachShader(p.program, p.fragmentShader);
+        glDeleteShader(p.fragmentShader);
+    }
+    pendingPrograms.clear();
+}
+
+unsigned int createShader(const char* vsSource, const char* fsSource)
+{
+    //Pravi objedinjeni sejder program koji se sastoji od Vertex sejdera ciji je kod na putanji vsSource
+    //(sinhrono - posalji pa odmah sacekaj)
+    unsigned int program = submitShader(vsSource, fsSource);
+    finishShaders();
+    return program;
+}
+
+unsigned int tryCreateShader(const char* vsSource, const char* fsSource)
+{
+    //Kao createShader, ali ne dira listu poslatih programa (bezbjedno sa druge niti i konteksta)
+    //i vraca 0 ako kompajliranje ili linkovanje nije uspjelo
+    unsigned int program = glCreateProgram();
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vsSource);
+    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fsSource);
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    reportShaderErrors(vertexShader, GL_VERTEX_SHADER);
+    reportShaderErrors(fragmentShader, GL_FRAGMENT_SHADER);
 
     int success;
     char infoLog[512];
-    glGetProgramiv(program, GL_VALIDATE_STATUS, &success); //Slicno kao za sejdere
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (success == GL_FALSE)
     {
-        glGetShaderInfoLog(program, 512, NULL, infoLog);
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cout << "Objedinjeni sejder ima gresku! Greska: \n";
         std::cout << infoLog << std::endl;
     }
 
-    //Posto su kodovi sejdera u objedinjenom sejderu, oni pojedinacni programi nam ne trebaju, pa ih brisemo zarad ustede na memoriji
     glDetachShader(program, vertexShader);
     glDeleteShader(vertexShader);
     glDetachShader(program, fragmentShader);
     glDeleteShader(fragmentShader);
 
+    if (success == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
     return program;
 }
 
 unsigned loadImageToTexture(const char* filePath) {
     int TextureWidth;
     int TextureHeight;
-    int TextureChannels;
 
-    unsigned char* ImageData = stbi_load(filePath, &TextureWidth, &TextureHeight, &TextureChannels, 0);
+    // Dekoder bira implementaciju (paralelne trake ili stb_image) i uvek vraca RGBA,
+    // vec okrenut naopako kako GL ocekuje
+    ImageDecodeStats stats = {};
+    unsigned char* ImageData = decodeImageRGBA(filePath, &TextureWidth, &TextureHeight, true, &stats);
 
     // DODATO: debug ispis
-    std::cout << "TEXTURE INFO: " << TextureWidth << "x" << TextureHeight << " Channels: " << TextureChannels << std::endl;
+    std::cout << "TEXTURE INFO: " << TextureWidth << "x" << TextureHeight << " Channels: 4" << std::endl;
 
     if (ImageData != NULL)
     {
-        //Slike se osnovno ucitavaju naopako pa se moraju ispraviti da budu uspravne
-        stbi__vertical_flip(ImageData, TextureWidth, TextureHeight, 4); // PROMENJENO: TextureChannels ? 3
-
         // PROMENJENO: Fiksiran format na RGB
         GLint InternalFormat = GL_RGBA;
 
@@ -174,6 +279,68 @@ unsigned loadImageToTextureRGBA(const char* filePath) {
     }
 }
 
+void loadImagesToTexturesRGBA(const char* const* filePaths, unsigned* textures, int count) {
+    // Svaka slika se dekodira na radnoj niti, a teksturu pravi posao glavne niti koji zavisi od
+    // tog dekodiranja: tekstura nastaje cim je njena slika gotova, dok se ostale jos dekodiraju
+    struct Decoded {
+        unsigned char* pixels;
+        int width, height;
+    };
+    std::vector<Decoded> decoded(count);
+    std::vector<JobSystem::JobHandle> uploads(count);
+    for (int i = 0; i < count; i++) {
+        JobSystem::JobHandle decode = jobSystem.Submit([&decoded, filePaths, i]() {
+            Decoded& image = decoded[i];
+            image.pixels = decodeImageRGBA(filePaths[i], &image.width, &image.height, true);
+        });
+        uploads[i] = jobSystem.SubmitMainThread([&decoded, filePaths, textures, i]() {
+            Decoded& image = decoded[i];
+            if (image.pixels == NULL) {
+                std::cout << "Ikona nije ucitana! Putanja: " << filePaths[i] << std::endl;
+                textures[i] = 0;
+                return;
+            }
+            std::cout << "ICON INFO: " << filePaths[i] << " - " << image.width << "x" << image.height << " Channels: 4" << std::endl;
+            textures[i] = createTextureRGBA(image.pixels, image.width, image.height, false);
+            freeImagePixels(image.pixels);
+        }, { decode });
+    }
+    for (const JobSystem::JobHandle& upload : uploads) jobSystem.WaitMainThread(upload);
+}
+
+unsigned char* loadImagePixels(const char* filePath, int* width, int* height) {
+    ImageDecodeStats stats = {};
+    unsigned char* pixels = decodeImageRGBA(filePath, width, height, true, &stats);
+    if (pixels == NULL) {
+        std::cout << "Slika nije ucitana! Putanja: " << filePath << std::endl;
+        return NULL;
+    }
+    std::cout << "IMAGE INFO: " << filePath << " - " << *width << "x" << *height << " ("
+        << (stats.backend == ImageBackend::StripPng ? "trake, " + std::to_string(stats.threads) + " niti" : std::string("stb_image"))
+        << ", " << stats.milliseconds << " ms)" << std::endl;
+    return pixels;
+}
+
+void freeImagePixels(unsigned char* pixels) {
+    stbi_image_free(pixels);
+}
+
+unsigned createTextureRGBA(const unsigned char* pixels, int width, int height, bool mipmaps) {
+    unsigned int Texture;
+    glGenTextures(1, &Texture);
+    glBindTexture(GL_TEXTURE_2D, Texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return Texture;
+}
+
 GLFWcursor* loadImageToCursor(const char* filePath) {
     int w, h, channels;
 
@@ -0,0 +1,449 @@
+#include "../Header/VirtualTexture.h"
+#include "../Header/Camera.h"
+#include "../Header/FrameStats.h"
+#include "../Header/GLState.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+static int nextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+VirtualTexture::VirtualTexture()
+    : source(nullptr), maxLevel(0), cacheTexture(0), indirectionTexture(0), paramsUBO(0),
+    indirectionWidth(0), indirectionHeight(0), indirectionDirty(true),
+    feedbackFBO(0), feedbackColor(0), quadVAO(0), quadVBO(0),
+    feedbackWidth(0), feedbackHeight(0), readbackIndex(0), feedbackProgram(0), frame(0) {
+    readbackPBO[0] = readbackPBO[1] = 0;
+    readbackFence[0] = readbackFence[1] = nullptr;
+    readbackWidth[0] = readbackWidth[1] = 0;
+    readbackHeight[0] = readbackHeight[1] = 0;
+}
+
+VirtualTexture::~VirtualTexture() {
+    streamer.Stop(); // Radne niti citaju izvor
+    for (int i = 0; i < 2; i++)
+        if (readbackFence[i]) glDeleteSync(readbackFence[i]);
+    if (readbackPBO[0]) glDeleteBuffers(2, readbackPBO);
+    if (feedbackFBO) glDeleteFramebuffers(1, &feedbackFBO);
+    if (feedbackColor) glDeleteTextures(1, &feedbackColor);
+    if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
+    if (quadVBO) glDeleteBuffers(1, &quadVBO);
+    if (cacheTexture) glDeleteTextures(1, &cacheTexture);
+    if (indirectionTexture) glDeleteTextures(1, &indirectionTexture);
+    if (paramsUBO) glDeleteBuffers(1, &paramsUBO);
+}
+
+uint64_t VirtualTexture::PageKey(int level, int x, int y) {
+    // level + 1 da nijedna stranica nema kljuc 0 (prazan slot)
+    return ((uint64_t)(level + 1) << 48) | ((uint64_t)y << 24) | (uint64_t)x;
+}
+
+void VirtualTexture::BuildLevels() {
+    // Nivoi dok jedna stranica ne pokrije ceo nivo; velicine kao u izvoru (max(1, w >> nivo))
+    levels.clear();
+    for (int level = 0; ; level++) {
+        Level info;
+        info.width = source->LevelWidth(level);
+        info.height = source->LevelHeight(level);
+        info.pagesX = (info.width + PAGE_PAYLOAD - 1) / PAGE_PAYLOAD;
+        info.pagesY = (info.height + PAGE_PAYLOAD - 1) / PAGE_PAYLOAD;
+        levels.push_back(info);
+        if (info.width <= PAGE_PAYLOAD && info.height <= PAGE_PAYLOAD) break;
+    }
+    maxLevel = (int)levels.size() - 1;
+}
+
+bool VirtualTexture::Init(MapSource* mapSource) {
+    source = mapSource;
+    BuildLevels();
+    int width = source->Width(), height = source->Height();
+
+    // Kes stranica
+    int cacheSize = CACHE_PAGES * PAGE_SIZE;
+    glGenTextures(1, &cacheTexture);
+    glBindTexture(GL_TEXTURE_2D, cacheTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cacheSize, cacheSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    // Indirekcija: nivo 0 pokriva stranice najfinijeg nivoa, stepen dvojke da bi
+    // mip k imao bar onoliko stranica koliko ih ima virtuelni nivo k
+    indirectionWidth = nextPowerOfTwo(levels[0].pagesX);
+    indirectionHeight = nextPowerOfTwo(levels[0].pagesY);
+    // Lanac mipmapa mora imati bar maxLevel + 1 nivo
+    indirectionWidth = std::max(indirectionWidth, 1 << maxLevel);
+    glGenTextures(1, &indirectionTexture);
+    glBindTexture(GL_TEXTURE_2D, indirectionTexture);
+    indirection.resize(maxLevel + 1);
+    for (int level = 0; level <= maxLevel; level++) {
+        int w = std::max(1, indirectionWidth >> level);
+        int h = std::max(1, indirectionHeight >> level);
+        indirection[level].assign((size_t)w * h * 4, 0);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8UI, w, h, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Parametri za sejdere
+    Params params = {};
+    params.virtualSize[0] = (float)width;
+    params.virtualSize[1] = (float)height;
+    params.virtualSize[2] = (float)PAGE_PAYLOAD;
+    params.virtualSize[3] = (float)PAGE_BORDER;
+    params.cacheInfo[0] = (float)cacheSize;
+    params.cacheInfo[1] = (float)cacheSize;
+    params.cacheInfo[2] = (float)PAGE_SIZE;
+    params.cacheInfo[3] = (float)maxLevel;
+    params.feedbackInfo[0] = (float)FEEDBACK_SHIFT;
+    glGenBuffers(1, &paramsUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, paramsUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Params), &params, GL_STATIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, PARAMS_BINDING, paramsUBO); // Ne menja se, vezuje se jednom
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Kvadrat mape u map space (isto je i texture koordinata) za feedback prolaz
+    float quad[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenFramebuffers(1, &feedbackFBO);
+    glGenBuffers(2, readbackPBO);
+
+    slots.assign(CACHE_PAGES * CACHE_PAGES, CacheSlot{ 0, 0, false });
+    pageScratch.resize(PAGE_SIZE * PAGE_SIZE * 4);
+
+    // Najgrublji nivo (jedna stranica) je uvek tu, pa svaki piksel ima bar nesto da prikaze
+    uint64_t top = PageKey(maxLevel, 0, 0);
+    LoadPage(top, pageScratch.data());
+    int slot = AllocateSlot();
+    UploadPage(top, slot, pageScratch.data());
+    slots[slot].locked = true;
+    RebuildIndirection();
+
+    streamer.Start(LOAD_JOBS, pageScratch.size(), [this](uint64_t key, unsigned char* pixels) {
+        LoadPage(key, pixels);
+    });
+
+    // Init je vezivao direktno
+    glState.Invalidate();
+
+    std::cout << "Virtuelna tekstura: " << width << "x" << height << ", nivoa " << maxLevel + 1
+        << ", stranica na nivou 0: " << levels[0].pagesX << "x" << levels[0].pagesY << std::endl;
+    return true;
+}
+
+void VirtualTexture::Bind() {
+    if (indirectionDirty) {
+        glState.ActiveTexture(INDIRECTION_UNIT);
+        glState.BindTexture(indirectionTexture);
+        for (int level = 0; level <= maxLevel; level++) {
+            int w = std::max(1, indirectionWidth >> level);
+            int h = std::max(1, indirectionHeight >> level);
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, w, h, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, indirection[level].data());
+        }
+        indirectionDirty = false;
+    }
+
+    glState.ActiveTexture(INDIRECTION_UNIT);
+    glState.BindTexture(indirectionTexture);
+    glState.BindSampler(INDIRECTION_UNIT, 0);
+    glState.ActiveTexture(0);
+}
+
+int VirtualTexture::AllocateSlot() {
+    // Prazan slot ili najdavnije korisceni koji nije trazen u ovom frejmu
+    int best = -1;
+    for (int i = 0; i < (int)slots.size(); i++) {
+        const CacheSlot& slot = slots[i];
+        if (slot.key == 0) return i;
+        if (slot.locked || slot.lastUsed == frame) continue;
+        if (best == -1 || slot.lastUsed < slots[best].lastUsed) best = i;
+    }
+    if (best != -1) resident.erase(slots[best].key);
+    return best;
+}
+
+void VirtualTexture::LoadPage(uint64_t key, unsigned char* pixels) const {
+    int level = (int)(key >> 48) - 1;
+    int pageY = (int)((key >> 24) & 0xFFFFFF);
+    int pageX = (int)(key & 0xFFFFFF);
+    const Level& info = levels[level];
+
+    // Deo stranice (sa ivicom) koji je unutar nivoa cita izvor; van slike se ponavlja
+    // poslednji red/kolona
+    int originX = pageX * PAGE_PAYLOAD - PAGE_BORDER;
+    int originY = pageY * PAGE_PAYLOAD - PAGE_BORDER;
+    int x0 = std::max(originX, 0), x1 = std::min(originX + PAGE_SIZE, info.width);
+    int y0 = std::max(originY, 0), y1 = std::min(originY + PAGE_SIZE, info.height);
+    int w = x1 - x0, h = y1 - y0;
+    thread_local std::vector<unsigned char> region;
+    region.resize((size_t)PAGE_SIZE * PAGE_SIZE * 4);
+    source->ReadRegion(level, x0, y0, w, h, region.data());
+
+    for (int row = 0; row < PAGE_SIZE; row++) {
+        int sy = std::min(std::max(originY + row, y0), y1 - 1) - y0;
+        const unsigned char* srcRow = &region[(size_t)sy * w * 4];
+        unsigned char* dstRow = pixels + (size_t)row * PAGE_SIZE * 4;
+        for (int col = 0; col < PAGE_SIZE; col++) {
+            int sx = std::min(std::max(originX + col, x0), x1 - 1) - x0;
+            memcpy(dstRow + col * 4, srcRow + (size_t)sx * 4, 4);
+        }
+    }
+}
+
+void VirtualTexture::UploadPage(uint64_t key, int slot, const unsigned char* pixels) {
+    int slotX = slot % CACHE_PAGES;
+    int slotY = slot / CACHE_PAGES;
+    glState.ActiveTexture(0);
+    glState.BindTexture(cacheTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, slotX * PAGE_SIZE, slotY * PAGE_SIZE, PAGE_SIZE, PAGE_SIZE,
+        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    slots[slot].key = key;
+    slots[slot].lastUsed = frame;
+    resident[key] = slot;
+}
+
+void VirtualTexture::RebuildIndirection() {
+    // Od najgrubljeg ka najfinijem: stranica koja nije u kesu nasledjuje unos roditelja
+    for (int level = maxLevel; level >= 0; level--) {
+        const Level& info = levels[level];
+        int w = std::max(1, indirectionWidth >> level);
+        int h = std::max(1, indirectionHeight >> level);
+        std::vector<unsigned char>& entries = indirection[level];
+
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                unsigned char* entry = &entries[((size_t)y * w + x) * 4];
+                auto found = (x < info.pagesX && y < info.pagesY) ? resident.find(PageKey(level, x, y)) : resident.end();
+                if (found != resident.end()) {
+                    entry[0] = (unsigned char)(found->second % CACHE_PAGES);
+                    entry[1] = (unsigned char)(found->second / CACHE_PAGES);
+                    entry[2] = (unsigned char)level;
+                    entry[3] = 1;
+                }
+                else if (level < maxLevel) {
+                    int pw = std::max(1, indirectionWidth >> (level + 1));
+                    int px = std::min(x / 2, pw - 1);
+                    int py = std::min(y / 2, std::max(1, indirectionHeight >> (level + 1)) - 1);
+                    memcpy(entry, &indirection[level + 1][((size_t)py * pw + px) * 4], 4);
+                }
+                else {
+                    memset(entry, 0, 4);
+                }
+            }
+        }
+    }
+    indirectionDirty = true;
+}
+
+void VirtualTexture::ResizeFeedback(int width, int height) {
+    if (width == feedbackWidth && height == feedbackHeight) return;
+    feedbackWidth = width;
+    feedbackHeight = height;
+
+    if (feedbackColor) glDeleteTextures(1, &feedbackColor);
+
+    glGenTextures(1, &feedbackColor);
+    glBindTexture(GL_TEXTURE_2D, feedbackColor);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, feedbackColor, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Feedback FBO nije kompletan!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)width * height * 4 * sizeof(unsigned short), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glState.Invalidate();
+}
+
+void VirtualTexture::Update(unsigned int program, int viewportWidth, int viewportHeight) {
+    frame++;
+
+    // 1) Feedback prolaz u malom FBO-u (isti pogled kao upravo iscrtani frejm)
+    ResizeFeedback(std::max(1, viewportWidth >> FEEDBACK_SHIFT), std::max(1, viewportHeight >> FEEDBACK_SHIFT));
+
+    glState.UseProgram(program);
+    if (program != feedbackProgram) {
+        unsigned int view = glGetUniformBlockIndex(program, "ViewParams");
+        if (view != GL_INVALID_INDEX) glUniformBlockBinding(program, view, VIEW_UBO_BINDING);
+        unsigned int params = glGetUniformBlockIndex(program, "VirtualTextureParams");
+        if (params != GL_INVALID_INDEX) glUniformBlockBinding(program, params, PARAMS_BINDING);
+        feedbackProgram = program;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+    glViewport(0, 0, feedbackWidth, feedbackHeight);
+    GLuint clearValue[4] = { 0, 0, 0, 0 }; // w = 0: piksel bez mape
+    glClearBufferuiv(GL_COLOR, 0, clearValue);
+    glState.SetBlend(false);
+    glState.BindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    glState.SetBlend(true);
+
+    // 2) Asinhrono citanje u PBO; obradjuje se onaj iz prethodnog frejma kada je GPU gotov
+    int write = readbackIndex;
+    int read = 1 - readbackIndex;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO[write]);
+    glReadPixels(0, 0, feedbackWidth, feedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, (void*)0);
+    if (readbackFence[write]) glDeleteSync(readbackFence[write]);
+    readbackFence[write] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readbackWidth[write] = feedbackWidth;
+    readbackHeight[write] = feedbackHeight;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, viewportWidth, viewportHeight);
+
+    if (readbackFence[read] && glClientWaitSync(readbackFence[read], 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(readbackFence[read]);
+        readbackFence[read] = nullptr;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackPBO[read]);
+        size_t size = (size_t)readbackWidth[read] * readbackHeight[read] * 4 * sizeof(unsigned short);
+        const unsigned short* data = (const unsigned short*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (data) {
+            ProcessFeedback(data, readbackWidth[read], readbackHeight[read]);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackIndex = read;
+
+    // 3) Gotove stranice sa radnih niti u kes
+    UploadReady();
+}
+
+void VirtualTexture::ProcessFeedback(const unsigned short* data, int width, int height) {
+    // Vidljive stranice: susedni pikseli su uglavnom ista stranica, pa se ponavljanje odmah
+    // preskace, a ostatak sortira. Nizovi su clanovi, pa posle zagrevanja frejm ne ide na heap
+    visiblePages.clear();
+    for (int i = 0; i < width * height; i++) {
+        const unsigned short* pixel = data + i * 4;
+        if (pixel[3] == 0) continue;
+        int level = std::min((int)pixel[2], maxLevel);
+        uint64_t key = PageKey(level, pixel[0], pixel[1]);
+        if (visiblePages.empty() || visiblePages.back() != key) visiblePages.push_back(key);
+    }
+    std::sort(visiblePages.begin(), visiblePages.end());
+    visiblePages.erase(std::unique(visiblePages.begin(), visiblePages.end()), visiblePages.end());
+
+    // Trazene stranice: vidljive + svi njihovi preci (da prelaz na finiji nivo ne bude rupa)
+    neededPages.clear();
+    for (uint64_t key : visiblePages) {
+        int level = (int)(key >> 48) - 1;
+        int y = (int)((key >> 24) & 0xFFFFFF), x = (int)(key & 0xFFFFFF);
+        for (; level <= maxLevel; level++, x /= 2, y /= 2)
+            neededPages.push_back(PageKey(level, x, y));
+    }
+    std::sort(neededPages.begin(), neededPages.end());
+    neededPages.erase(std::unique(neededPages.begin(), neededPages.end()), neededPages.end());
+
+    requests.clear();
+    for (uint64_t key : neededPages) {
+        auto found = resident.find(key);
+        if (found != resident.end()) slots[found->second].lastUsed = frame;
+        else requests.push_back(key);
+    }
+
+    // Pogodak = stranica koju je pogled trazio vec je bila u kesu
+    for (uint64_t key : visiblePages) {
+        frameStats.tilesVisible++;
+        if (resident.count(key)) {
+            frameStats.tilesHit++;
+            continue;
+        }
+        auto position = std::lower_bound(demandedMissing.begin(), demandedMissing.end(), key);
+        if (position == demandedMissing.end() || *position != key) demandedMissing.insert(position, key);
+    }
+
+    // Prvo grublji nivoi (brzo pokrivaju ekran), pa finiji
+    std::sort(requests.begin(), requests.end(), [](uint64_t a, uint64_t b) { return (a >> 48) > (b >> 48); });
+
+    for (uint64_t key : requests) {
+        int level = (int)(key >> 48) - 1;
+        int y = (int)((key >> 24) & 0xFFFFFF), x = (int)(key & 0xFFFFFF);
+        if (level > maxLevel || x >= levels[level].pagesX || y >= levels[level].pagesY) continue;
+        streamer.Request(key, TileStreamer::Priority::Demand);
+    }
+}
+
+void VirtualTexture::UploadReady() {
+    TileStreamer::Tile tile;
+    int uploads = 0;
+    while (uploads < MAX_UPLOADS_PER_FRAME && streamer.PopReady(tile)) {
+        if (resident.count(tile.key) == 0) {
+            int slot = AllocateSlot();
+            if (slot == -1) { // Ceo kes je potreban za ovaj frejm; stranica ce biti ponovo trazena
+                streamer.Recycle(std::move(tile.pixels));
+                break;
+            }
+            UploadPage(tile.key, slot, tile.pixels.data());
+            uploads++;
+
+            auto missing = std::lower_bound(demandedMissing.begin(), demandedMissing.end(), tile.key);
+            if (missing != demandedMissing.end() && *missing == tile.key) {
+                demandedMissing.erase(missing);
+                frameStats.tilesLate++;
+            }
+            else if (tile.priority == TileStreamer::Priority::Prefetch) frameStats.tilesPrefetched++;
+        }
+        streamer.Recycle(std::move(tile.pixels));
+    }
+
+    if (uploads > 0) RebuildIndirection();
+    frameStats.tilesInFlight = streamer.InFlightCount();
+}
+
+void VirtualTexture::Prefetch(float centerX, float centerY, float zoom, float velocityX, float velocityY, int viewportWidth) {
+    // Staro predvidjanje vise ne vazi (nova pozicija/pravac); zapoceti poslovi se zavrsavaju
+    streamer.CancelPrefetch();
+    if (velocityX == 0.0f && velocityY == 0.0f) return;
+
+    // Nivo koji ce map.frag birati za ovaj zoom (teksela po pikselu ekrana)
+    float texelsPerPixel = zoom * levels[0].width / std::max(1, viewportWidth);
+    int level = std::min(std::max((int)floorf(log2f(std::max(texelsPerPixel, 1.0f))), 0), maxLevel);
+    const Level& info = levels[level];
+
+    // Pogled posle PREFETCH_LOOKAHEAD sekundi, u stranicama tog nivoa
+    float aheadX = centerX + velocityX * PREFETCH_LOOKAHEAD;
+    float aheadY = centerY + velocityY * PREFETCH_LOOKAHEAD;
+    float half = zoom * 0.5f;
+    int x0 = std::max(0, (int)floorf((aheadX - half) * info.width / PAGE_PAYLOAD));
+    int x1 = std::min(info.pagesX - 1, (int)floorf((aheadX + half) * info.width / PAGE_PAYLOAD));
+    int y0 = std::max(0, (int)floorf((aheadY - half) * info.height / PAGE_PAYLOAD));
+    int y1 = std::min(info.pagesY - 1, (int)floorf((aheadY + half) * info.height / PAGE_PAYLOAD));
+
+    // Prvo stranice najblize trenutnom pogledu - one ce prve biti potrebne
+    for (int y = velocityY >= 0 ? y0 : y1; y >= y0 && y <= y1; y += velocityY >= 0 ? 1 : -1) {
+        for (int x = velocityX >= 0 ? x0 : x1; x >= x0 && x <= x1; x += velocityX >= 0 ? 1 : -1) {
+            uint64_t key = PageKey(level, x, y);
+            auto found = resident.find(key);
+            if (found != resident.end()) {
+                slots[found->second].lastUsed = frame; // Ne izbacuj ono sto ce uskoro trebati
+                continue;
+            }
+            if (streamer.Request(key, TileStreamer::Priority::Prefetch))
+                frameStats.tilesPrefetchRequested++;
+        }
+    }
+}